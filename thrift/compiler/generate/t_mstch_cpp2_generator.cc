@@ -62,9 +62,55 @@ bool is_cpp_ref_unique_either(const t_field* f) {
       cpp2::is_implicit_ref(f->get_type());
 }
 
+// Fields annotated with `cpp.lazy` are kept serialized until first accessed.
+// Only string, binary, container and struct fields that are stored by value
+// and reached through generated accessors qualify.
+bool is_lazy_field(
+    const t_field* f,
+    const std::map<std::string, std::string>& options) {
+  if (!f->annotations_.count("cpp.lazy") || options.count("optionals") ||
+      options.count("terse_writes") || options.count("no_getters_setters")) {
+    return false;
+  }
+  if (f->annotations_.count("cpp.ref") || f->annotations_.count("cpp2.ref") ||
+      f->annotations_.count("cpp.ref_type") ||
+      f->annotations_.count("cpp2.ref_type") ||
+      cpp2::is_implicit_ref(f->get_type())) {
+    return false;
+  }
+  auto const* type = f->get_type()->get_true_type();
+  return type->is_string_or_binary() || type->is_container() ||
+      type->is_struct() || type->is_xception();
+}
+
+// Structs generated with the `table_based` option (de)serialize through a
+// field table instead of unrolled code. The table addresses every field by
+// offset, so fields held through a pointer or kept serialized do not qualify,
+// and neither do the options that change how fields are written or checked.
+bool is_table_based_struct(
+    const t_struct* strct,
+    const std::map<std::string, std::string>& options) {
+  if (!options.count("table_based") || options.count("optionals") ||
+      options.count("terse_writes") || options.count("enforce_required") ||
+      strct->is_union() || strct->get_members().empty()) {
+    return false;
+  }
+  for (auto const* field : strct->get_members()) {
+    if (field->annotations_.count("cpp.ref") ||
+        field->annotations_.count("cpp2.ref") ||
+        field->annotations_.count("cpp.ref_type") ||
+        field->annotations_.count("cpp2.ref_type") ||
+        is_lazy_field(field, options)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool is_annotation_blacklisted_in_fatal(const std::string& key) {
   const static std::set<std::string> black_list{
       "cpp.methods",
+      "cpp.lazy",
       "cpp.name",
       "cpp.ref",
       "cpp.ref_type",
@@ -450,6 +496,7 @@ class mstch_cpp2_type : public mstch_type {
             {"type:cpp_declare_equal_to",
              &mstch_cpp2_type::cpp_declare_equal_to},
             {"type:optionals?", &mstch_cpp2_type::optionals},
+            {"type:allocator_aware?", &mstch_cpp2_type::allocator_aware},
             {"type:forward_compatibility?",
              &mstch_cpp2_type::forward_compatibility},
             {"type:no_getters_setters?", &mstch_cpp2_type::no_getters_setters},
@@ -534,6 +581,9 @@ class mstch_cpp2_type : public mstch_type {
   mstch::node optionals() {
     return cache_->parsed_options_.count("optionals") != 0;
   }
+  mstch::node allocator_aware() {
+    return cache_->parsed_options_.count("allocator_aware") != 0;
+  }
   mstch::node no_getters_setters() {
     return cache_->parsed_options_.count("no_getters_setters") != 0;
   }
@@ -615,6 +665,7 @@ class mstch_cpp2_field : public mstch_field {
             {"field:enum_has_value", &mstch_cpp2_field::enum_has_value},
             {"field:optionals?", &mstch_cpp2_field::optionals},
             {"field:terse_writes?", &mstch_cpp2_field::terse_writes},
+            {"field:lazy?", &mstch_cpp2_field::lazy},
             {"field:fatal_annotations?",
              &mstch_cpp2_field::has_fatal_annotations},
             {"field:fatal_annotations", &mstch_cpp2_field::fatal_annotations},
@@ -687,6 +738,9 @@ class mstch_cpp2_field : public mstch_field {
         (is_cpp_ref_unique_either(field_) ||
          (!t->is_struct() && !t->is_xception()));
   }
+  mstch::node lazy() {
+    return is_lazy_field(field_, cache_->parsed_options_);
+  }
   mstch::node has_fatal_annotations() {
     return get_fatal_annotations(field_->annotations_).size() > 0;
   }
@@ -735,6 +789,7 @@ class mstch_cpp2_struct : public mstch_struct {
             {"struct:fields_contain_cpp_ref?", &mstch_cpp2_struct::has_cpp_ref},
             {"struct:fields_contain_cpp_ref_unique_either?",
              &mstch_cpp2_struct::has_cpp_ref_unique_either},
+            {"struct:custom_copy?", &mstch_cpp2_struct::custom_copy},
             {"struct:cpp_methods", &mstch_cpp2_struct::cpp_methods},
             {"struct:cpp_declare_hash", &mstch_cpp2_struct::cpp_declare_hash},
             {"struct:cpp_declare_equal_to",
@@ -747,7 +802,11 @@ class mstch_cpp2_struct : public mstch_struct {
             {"struct:message", &mstch_cpp2_struct::message},
             {"struct:isset_fields?", &mstch_cpp2_struct::has_isset_fields},
             {"struct:isset_fields", &mstch_cpp2_struct::isset_fields},
+            {"struct:lazy_fields?", &mstch_cpp2_struct::has_lazy_fields},
+            {"struct:lazy_fields", &mstch_cpp2_struct::lazy_fields},
             {"struct:optionals?", &mstch_cpp2_struct::optionals},
+            {"struct:allocator_aware?", &mstch_cpp2_struct::allocator_aware},
+            {"struct:table_based?", &mstch_cpp2_struct::table_based},
             {"struct:is_large?", &mstch_cpp2_struct::is_large},
             {"struct:no_getters_setters?",
              &mstch_cpp2_struct::no_getters_setters},
@@ -849,6 +908,17 @@ class mstch_cpp2_struct : public mstch_struct {
     }
     return false;
   }
+  // Fields held through a unique pointer are deep-copied, and lazy fields
+  // are copied under the lock that guards their decoding, so neither can
+  // use the defaulted copy constructor and assignment.
+  mstch::node custom_copy() {
+    for (auto const* f : strct_->get_members()) {
+      if (is_cpp_ref_unique_either(f)) {
+        return true;
+      }
+    }
+    return !get_lazy_fields().empty();
+  }
   mstch::node cpp_methods() {
     if (strct_->annotations_.count("cpp.methods")) {
       return strct_->annotations_.at("cpp.methods");
@@ -900,6 +970,17 @@ class mstch_cpp2_struct : public mstch_struct {
     }
     return false;
   }
+  mstch::node has_lazy_fields() {
+    return !get_lazy_fields().empty();
+  }
+  mstch::node lazy_fields() {
+    auto fields = get_lazy_fields();
+    if (fields.empty()) {
+      return mstch::node();
+    }
+    return generate_elements(
+        fields, generators_->field_generator_.get(), generators_, cache_);
+  }
   mstch::node isset_fields() {
     std::vector<t_field const*> fields;
     for (const auto* field : strct_->get_members()) {
@@ -920,6 +1001,15 @@ class mstch_cpp2_struct : public mstch_struct {
   mstch::node optionals() {
     return cache_->parsed_options_.count("optionals") != 0;
   }
+  mstch::node allocator_aware() {
+    // Unions keep their storage in an anonymous union, so they are not
+    // given an allocator-extended constructor.
+    return cache_->parsed_options_.count("allocator_aware") != 0 &&
+        !strct_->is_union();
+  }
+  mstch::node table_based() {
+    return is_table_based_struct(strct_, cache_->parsed_options_);
+  }
   mstch::node is_large() {
     // Outline constructors and destructors if the struct has
     // enough members and at least one has a non-trivial destructor
@@ -1010,6 +1100,19 @@ class mstch_cpp2_struct : public mstch_struct {
     }
   }
 
+  std::vector<t_field const*> get_lazy_fields() {
+    std::vector<t_field const*> fields;
+    if (strct_->is_union()) {
+      return fields;
+    }
+    for (auto const* field : strct_->get_members()) {
+      if (is_lazy_field(field, cache_->parsed_options_)) {
+        fields.push_back(field);
+      }
+    }
+    return fields;
+  }
+
   // Returns the struct members reordered to minimize padding if the
   // cpp.minimize_padding annotation is specified.
   const std::vector<t_field*>& get_members_in_layout_order() {
@@ -1335,6 +1438,10 @@ class mstch_cpp2_program : public mstch_program {
             {"program:indirection?", &mstch_cpp2_program::has_indirection},
             {"program:json?", &mstch_cpp2_program::json},
             {"program:optionals?", &mstch_cpp2_program::optionals},
+            {"program:allocator_aware?",
+             &mstch_cpp2_program::allocator_aware},
+            {"program:lazy_fields?", &mstch_cpp2_program::has_lazy_fields},
+            {"program:table_based?", &mstch_cpp2_program::table_based},
             {"program:coroutines?", &mstch_cpp2_program::coroutines},
             {"program:nimble?", &mstch_cpp2_program::nimble},
             {"program:fatal_languages", &mstch_cpp2_program::fatal_languages},
@@ -1512,6 +1619,30 @@ class mstch_cpp2_program : public mstch_program {
   mstch::node optionals() {
     return cache_->parsed_options_.count("optionals") != 0;
   }
+  mstch::node allocator_aware() {
+    return cache_->parsed_options_.count("allocator_aware") != 0;
+  }
+  mstch::node has_lazy_fields() {
+    for (auto const* strct : program_->get_objects()) {
+      if (strct->is_union()) {
+        continue;
+      }
+      for (auto const* field : strct->get_members()) {
+        if (is_lazy_field(field, cache_->parsed_options_)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  mstch::node table_based() {
+    for (auto const* strct : program_->get_objects()) {
+      if (is_table_based_struct(strct, cache_->parsed_options_)) {
+        return true;
+      }
+    }
+    return false;
+  }
   mstch::node coroutines() {
     return cache_->parsed_options_.count("coroutines") != 0;
   }
@@ -16,8 +16,11 @@
 #ifndef THREADMANAGERIMPL_H
 #define THREADMANAGERIMPL_H
 
+#include <algorithm>
 #include <deque>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include <folly/DefaultKeepAliveExecutor.h>
 #include <folly/PriorityMPMCQueue.h>
@@ -25,6 +28,7 @@
 #include <folly/concurrency/PriorityUnboundedQueueSet.h>
 #include <folly/executors/Codel.h>
 #include <folly/io/async/Request.h>
+#include <folly/lang/Align.h>
 #include <folly/synchronization/LifoSem.h>
 #include <folly/synchronization/SmallLocks.h>
 #include <thrift/lib/cpp/concurrency/Monitor.h>
@@ -85,11 +89,21 @@ class ThreadManager::Task {
     return context_;
   }
 
+  size_t getShard() const {
+    return shard_;
+  }
+
+  void setShard(size_t shard) {
+    shard_ = shard;
+  }
+
  private:
   shared_ptr<Runnable> runnable_;
   SystemClockTimePoint queueBeginTime_;
   SystemClockTimePoint expireTime_;
   std::shared_ptr<folly::RequestContext> context_;
+  // Task queue shard the task was added to
+  size_t shard_{0};
 };
 
 template <typename SemType>
@@ -99,7 +113,21 @@ class ThreadManager::ImplT : public ThreadManager,
   class Worker;
 
  public:
-  explicit ImplT(bool enableTaskStats = false, size_t numPriorities = 1)
+  /**
+   * With numShards > 1 the task queue is split into that many shards. Each
+   * worker gets a home shard by its index among the workers, and each thread
+   * adding tasks gets one the first time it adds a task to this manager,
+   * round-robin in both cases. Tasks go to the adding thread's shard, and a
+   * worker takes tasks from its own shard first, stealing from the others
+   * when it runs dry, so that threads adding tasks at a high rate don't all
+   * contend on one queue. Each shard has its own Codel state. The task and
+   * idle worker counts and the semaphore idle workers wait on are still
+   * shared by all shards.
+   */
+  explicit ImplT(
+      bool enableTaskStats = false,
+      size_t numPriorities = 1,
+      size_t numShards = 1)
       : workerCount_(0),
         intendedWorkerCount_(0),
         idleCount_(0),
@@ -112,13 +140,17 @@ class ThreadManager::ImplT : public ThreadManager,
         executingTimeUs_(0),
         numTasks_(0),
         state_(ThreadManager::UNINITIALIZED),
-        tasks_(numPriorities),
         monitor_(&mutex_),
         deadWorkerMonitor_(&mutex_),
         deadWorkers_(),
         namePrefix_(""),
         namePrefixCounter_(0),
-        codelEnabled_(false || FLAGS_codel_enabled) {}
+        codelEnabled_(false || FLAGS_codel_enabled) {
+    shards_.reserve(std::max<size_t>(numShards, 1));
+    for (size_t i = 0; i < std::max<size_t>(numShards, 1); ++i) {
+      shards_.push_back(std::make_unique<Shard>(numPriorities));
+    }
+  }
 
   ~ImplT() override { stop(); }
 
@@ -165,7 +197,15 @@ class ThreadManager::ImplT : public ThreadManager,
   }
 
   size_t pendingTaskCount() const override {
-    return tasks_.size();
+    size_t count = 0;
+    for (auto& shard : shards_) {
+      count += shard->tasks.size();
+    }
+    return count;
+  }
+
+  size_t numShards() const {
+    return shards_.size();
   }
 
   size_t totalTaskCount() const override {
@@ -223,8 +263,9 @@ class ThreadManager::ImplT : public ThreadManager,
                        const SystemClockTimePoint& workEnd);
   std::unique_ptr<Task> waitOnTask();
   void onTaskExpired(const Task& task);
-
-  Codel codel_;
+  Codel& codelFor(const Task& task) {
+    return shards_[task.getShard()]->codel;
+  }
 
  protected:
   bool tryAdd(size_t priority, std::shared_ptr<Runnable> task);
@@ -243,9 +284,31 @@ class ThreadManager::ImplT : public ThreadManager,
   }
 
  private:
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    explicit Shard(size_t numPriorities) : tasks(numPriorities) {}
+
+    folly::
+        PriorityUMPMCQueueSet<std::unique_ptr<Task>, /* MayBlock = */ false>
+            tasks;
+    Codel codel;
+  };
+
   void stopImpl(bool joinArg);
   void removeWorkerImpl(size_t value, bool afterTasks = false);
   bool shouldStop();
+  size_t currentShard() {
+    if (shards_.size() == 1) {
+      return 0;
+    }
+    auto& shard = *threadShard_;
+    if (shard == kNoShard) {
+      shard = nextThreadShard_++ % shards_.size();
+    }
+    return shard;
+  }
+  void enqueue(size_t priority, std::unique_ptr<Task> task);
+  bool tryDequeue(std::unique_ptr<Task>& task);
+  bool empty() const;
 
   size_t workerCount_;
   // intendedWorkerCount_ tracks the number of worker threads that we currently
@@ -257,6 +320,8 @@ class ThreadManager::ImplT : public ThreadManager,
   std::atomic<size_t> totalTaskCount_;
   size_t expiredCount_;
   std::atomic<int> workersToStop_;
+  // Workers to exit once the task queue is drained, with more than one shard
+  std::atomic<int> workersToJoin_{0};
 
   const bool enableTaskStats_;
   folly::MicroSpinLock statsLock_;
@@ -271,8 +336,12 @@ class ThreadManager::ImplT : public ThreadManager,
   ThreadManager::STATE state_;
   shared_ptr<ThreadFactory> threadFactory_;
 
-  folly::PriorityUMPMCQueueSet<std::unique_ptr<Task>, /* MayBlock = */ false>
-      tasks_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  static constexpr size_t kNoShard = std::numeric_limits<size_t>::max();
+  // Home shard of the calling thread, assigned on first use
+  folly::ThreadLocal<size_t> threadShard_{[] { return new size_t(kNoShard); }};
+  std::atomic<size_t> nextThreadShard_{0};
+  std::atomic<size_t> nextWorkerShard_{0};
 
   Mutex mutex_;
   // monitor_ is signaled on any of the following events:
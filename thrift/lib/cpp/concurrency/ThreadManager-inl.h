@@ -117,7 +117,7 @@ class ThreadManager::ImplT<SemType>::Worker : public Runnable {
         auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
           startTime - task->getQueueBeginTime());
 
-        if (manager_->codel_.overloaded(delay)) {
+        if (manager_->codelFor(*task).overloaded(delay)) {
           if (manager_->codelCallback_) {
             manager_->codelCallback_(task->getRunnable());
           }
@@ -208,6 +208,7 @@ void ThreadManager::ImplT<SemType>::workerStarted(Worker<SemType>* worker) {
     ++totalTaskCount_;
     shared_ptr<Thread> thread = worker->thread();
     *isThreadManagerThread_ = true;
+    *threadShard_ = nextWorkerShard_++ % shards_.size();
     initCallback = initCallback_;
     if (!namePrefix_.empty()) {
       thread->setName(folly::to<std::string>(namePrefix_, "-",
@@ -264,15 +265,15 @@ void ThreadManager::ImplT<SemType>::stopImpl(bool joinArg) {
     if (joinArg) {
       state_ = ThreadManager::JOINING;
       removeWorkerImpl(intendedWorkerCount_, true);
-      assert(tasks_.empty());
+      assert(empty());
     } else {
       state_ = ThreadManager::STOPPING;
       removeWorkerImpl(intendedWorkerCount_);
       // Empty the task queue, in case we stopped without running
       // all of the tasks.
-      totalTaskCount_ -= tasks_.size();
+      totalTaskCount_ -= pendingTaskCount();
       std::unique_ptr<Task> task;
-      while (tasks_.try_dequeue(task)) {
+      while (tryDequeue(task)) {
       }
     }
     state_ = ThreadManager::STOPPED;
@@ -311,8 +312,16 @@ void ThreadManager::ImplT<SemType>::removeWorkerImpl(size_t value, bool afterTas
     // Insert nullptr tasks onto the tasks queue to ask workers to exit
     // after all current tasks are completed
     for (size_t n = 0; n < value; ++n) {
-      auto const qpriority = tasks_.priorities() / 2; // median priority
-      tasks_.at_priority(qpriority).enqueue(nullptr);
+      if (shards_.size() == 1) {
+        auto const qpriority =
+            shards_[0]->tasks.priorities() / 2; // median priority
+        shards_[0]->tasks.at_priority(qpriority).enqueue(nullptr);
+      } else {
+        // A nullptr task on one shard could be taken while other shards
+        // still hold tasks, so tryDequeue() hands these out only once all
+        // shards are empty.
+        ++workersToJoin_;
+      }
       ++totalTaskCount_;
     }
     monitor_.notifyAll();
@@ -380,8 +389,7 @@ void ThreadManager::ImplT<SemType>::add(
 
   auto task = std::make_unique<Task>(
       std::move(value), std::chrono::milliseconds{expiration});
-  auto const qpriority = std::min(tasks_.priorities() - 1, priority);
-  tasks_.at_priority(qpriority).enqueue(std::move(task));
+  enqueue(priority, std::move(task));
 
   ++totalTaskCount_;
 
@@ -408,9 +416,7 @@ bool ThreadManager::ImplT<SemType>::tryAdd(
 
   auto task = std::make_unique<Task>(std::move(value),
                                        std::chrono::milliseconds{0});
-
-  auto const qpriority = std::min(tasks_.priorities() - 1, priority);
-  tasks_.at_priority(qpriority).enqueue(std::move(task));
+  enqueue(priority, std::move(task));
 
   ++totalTaskCount_;
 
@@ -443,7 +449,7 @@ std::shared_ptr<Runnable> ThreadManager::ImplT<SemType>::removeNextPending() {
   }
 
   std::unique_ptr<Task> task;
-  if (tasks_.try_dequeue(task)) {
+  if (tryDequeue(task)) {
     std::shared_ptr<Runnable> r = task->getRunnable();
     --totalTaskCount_;
     return r;
@@ -483,7 +489,7 @@ ThreadManager::ImplT<SemType>::waitOnTask() {
   std::unique_ptr<Task> task;
 
   // Fast path - if tasks are ready, get one
-  if (tasks_.try_dequeue(task)) {
+  if (tryDequeue(task)) {
     --totalTaskCount_;
     return task;
   }
@@ -498,7 +504,7 @@ ThreadManager::ImplT<SemType>::waitOnTask() {
   ++idleCount_;
   --totalTaskCount_;
   g.release();
-  while (!tasks_.try_dequeue(task)) {
+  while (!tryDequeue(task)) {
     waitSem_.wait();
     if (shouldStop()) {
       Guard f(mutex_);
@@ -514,6 +520,56 @@ ThreadManager::ImplT<SemType>::waitOnTask() {
   return task;
 }
 
+template <typename SemType>
+void ThreadManager::ImplT<SemType>::enqueue(
+    size_t priority,
+    std::unique_ptr<Task> task) {
+  auto const shard = currentShard();
+  auto& tasks = shards_[shard]->tasks;
+  task->setShard(shard);
+  auto const qpriority = std::min(tasks.priorities() - 1, priority);
+  tasks.at_priority(qpriority).enqueue(std::move(task));
+}
+
+template <typename SemType>
+bool ThreadManager::ImplT<SemType>::tryDequeue(std::unique_ptr<Task>& task) {
+  if (shards_.size() == 1) {
+    return shards_[0]->tasks.try_dequeue(task);
+  }
+
+  // Higher priorities first across all shards, and within a priority the
+  // calling thread's own shard before stealing from the others.
+  auto const home = currentShard();
+  auto const priorities = shards_[0]->tasks.priorities();
+  for (size_t p = 0; p < priorities; ++p) {
+    for (size_t i = 0; i < shards_.size(); ++i) {
+      auto& shard = *shards_[(home + i) % shards_.size()];
+      if (shard.tasks.at_priority(p).try_dequeue(task)) {
+        return true;
+      }
+    }
+  }
+
+  if (workersToJoin_ > 0) {
+    if (workersToJoin_-- > 0) {
+      task = nullptr;
+      return true;
+    }
+    workersToJoin_++;
+  }
+  return false;
+}
+
+template <typename SemType>
+bool ThreadManager::ImplT<SemType>::empty() const {
+  for (auto& shard : shards_) {
+    if (!shard->tasks.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename SemType>
 void ThreadManager::ImplT<SemType>::onTaskExpired(const Task& task) {
   ExpireCallback expireCallback;
@@ -599,7 +655,7 @@ void ThreadManager::ImplT<SemType>::enableCodel(bool enabled) {
 
 template <typename SemType>
 Codel* ThreadManager::ImplT<SemType>::getCodel() {
-  return &codel_;
+  return &shards_[currentShard()]->codel;
 }
 
 template <typename SemType>
@@ -608,8 +664,10 @@ class SimpleThreadManager : public ThreadManager::ImplT<SemType> {
  public:
   explicit SimpleThreadManager(
       size_t workerCount = 4,
-      bool enableTaskStats = false)
-      : ThreadManager::Impl(enableTaskStats), workerCount_(workerCount) {}
+      bool enableTaskStats = false,
+      size_t numShards = 1)
+      : ThreadManager::Impl(enableTaskStats, 1, numShards),
+        workerCount_(workerCount) {}
 
   void start() override {
     if (this->state() == this->STARTED) {
@@ -626,8 +684,10 @@ class SimpleThreadManager : public ThreadManager::ImplT<SemType> {
 template <typename SemType>
 shared_ptr<ThreadManager> ThreadManager::newSimpleThreadManager(
     size_t count,
-    bool enableTaskStats) {
-  return make_shared<SimpleThreadManager<SemType>>(count, enableTaskStats);
+    bool enableTaskStats,
+    size_t numShards) {
+  return make_shared<SimpleThreadManager<SemType>>(
+      count, enableTaskStats, numShards);
 }
 
 template <typename SemType>
@@ -769,10 +829,11 @@ class PriorityThreadManager::PriorityImplT
       const std::array<
           std::pair<shared_ptr<ThreadFactory>, size_t>,
           N_PRIORITIES>& factories,
-      bool enableTaskStats = false) {
+      bool enableTaskStats = false,
+      size_t numShards = 1) {
     for (int i = 0; i < N_PRIORITIES; i++) {
       unique_ptr<ThreadManager> m(
-          new ThreadManager::ImplT<SemType>(enableTaskStats));
+          new ThreadManager::ImplT<SemType>(enableTaskStats, 1, numShards));
       m->threadFactory(factories[i].first);
       managers_[i] = std::move(m);
       counts_[i] = factories[i].second;
@@ -1030,7 +1091,8 @@ PriorityThreadManager::newPriorityThreadManager(
     const std::array<
         std::pair<shared_ptr<ThreadFactory>, size_t>,
         N_PRIORITIES>& factories,
-    bool enableTaskStats) {
+    bool enableTaskStats,
+    size_t numShards) {
   auto copy = factories;
   if (copy[PRIORITY::NORMAL].second < NORMAL_PRIORITY_MINIMUM_THREADS) {
     LOG(INFO) << "Creating minimum threads of NORMAL priority: "
@@ -1038,14 +1100,15 @@ PriorityThreadManager::newPriorityThreadManager(
     copy[PRIORITY::NORMAL].second = NORMAL_PRIORITY_MINIMUM_THREADS;
   }
   return std::make_shared<PriorityThreadManager::PriorityImplT<SemType>>(
-      copy, enableTaskStats);
+      copy, enableTaskStats, numShards);
 }
 
 template <typename SemType>
 shared_ptr<PriorityThreadManager>
 PriorityThreadManager::newPriorityThreadManager(
     const std::array<size_t, N_PRIORITIES>& counts,
-    bool enableTaskStats) {
+    bool enableTaskStats,
+    size_t numShards) {
   static_assert(N_PRIORITIES == 5, "Implementation is out-of-date");
   // Note that priorities for HIGH and IMPORTANT are the same, the difference
   // is in the number of threads.
@@ -1057,16 +1120,18 @@ PriorityThreadManager::newPriorityThreadManager(
       {Factory(PosixThreadFactory::NORMAL_PRI), counts[PRIORITY::NORMAL]},
       {Factory(PosixThreadFactory::LOW_PRI),    counts[PRIORITY::BEST_EFFORT]},
   }};
-  return newPriorityThreadManager<SemType>(factories, enableTaskStats);
+  return newPriorityThreadManager<SemType>(
+      factories, enableTaskStats, numShards);
 }
 
 template <typename SemType>
 shared_ptr<PriorityThreadManager>
 PriorityThreadManager::newPriorityThreadManager(
     size_t normalThreadsCount,
-    bool enableTaskStats) {
+    bool enableTaskStats,
+    size_t numShards) {
   return newPriorityThreadManager<SemType>(
-      {{2, 2, 2, normalThreadsCount, 2}}, enableTaskStats);
+      {{2, 2, 2, normalThreadsCount, 2}}, enableTaskStats, numShards);
 }
 
 }}} // apache::thrift::concurrency
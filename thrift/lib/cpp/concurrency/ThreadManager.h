@@ -205,12 +205,15 @@ class ThreadManager : public virtual folly::Executor {
   static std::shared_ptr<ThreadManager> newThreadManager();
 
   /**
-   * Creates a simple thread manager the uses count number of worker threads
+   * Creates a simple thread manager the uses count number of worker threads.
+   * With numShards > 1 the task queue is split into shards that adding
+   * threads spread over and idle workers steal from.
    */
   template <typename SemType = folly::LifoSem>
   static std::shared_ptr<ThreadManager> newSimpleThreadManager(
       size_t count = 4,
-      bool enableTaskStats = false);
+      bool enableTaskStats = false,
+      size_t numShards = 1);
 
   /**
    * Creates a thread manager with support for priorities. Unlike
@@ -327,7 +330,8 @@ class PriorityThreadManager : public ThreadManager {
       const std::array<
           std::pair<std::shared_ptr<ThreadFactory>, size_t>,
           N_PRIORITIES>& counts,
-      bool enableTaskStats = false);
+      bool enableTaskStats = false,
+      size_t numShards = 1);
 
   /**
    * Creates a priority-aware thread manager that uses counts[X]
@@ -336,7 +340,8 @@ class PriorityThreadManager : public ThreadManager {
   template <typename SemType = folly::LifoSem>
   static std::shared_ptr<PriorityThreadManager> newPriorityThreadManager(
       const std::array<size_t, N_PRIORITIES>& counts,
-      bool enableTaskStats = false);
+      bool enableTaskStats = false,
+      size_t numShards = 1);
 
   /**
    * Creates a priority-aware thread manager that uses normalThreadsCount
@@ -346,11 +351,14 @@ class PriorityThreadManager : public ThreadManager {
    *
    * @param normalThreadsCount - number of threads of NORMAL priority, defaults
    *          to the number of CPUs on the system
+   * @param numShards - number of task queue shards per priority, see
+   *          newSimpleThreadManager()
    */
   template <typename SemType = folly::LifoSem>
   static std::shared_ptr<PriorityThreadManager> newPriorityThreadManager(
       size_t normalThreadsCount = sysconf(_SC_NPROCESSORS_ONLN),
-      bool enableTaskStats = false);
+      bool enableTaskStats = false,
+      size_t numShards = 1);
 
   template <typename SemType>
   class PriorityImplT;
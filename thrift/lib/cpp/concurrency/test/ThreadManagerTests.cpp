@@ -15,12 +15,14 @@
  */
 #include <numa.h>
 
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <iostream>
 #include <memory>
 #include <random>
 #include <thread>
+#include <vector>
 
 #include <folly/Synchronized.h>
 #include <folly/executors/Codel.h>
@@ -832,3 +834,73 @@ TEST_F(ThreadManagerTest, PriorityQueueThreadManagerExecutor) {
 
   EXPECT_EQ("bca", foo);
 }
+
+TEST_F(ThreadManagerTest, ShardedTaskQueue) {
+  // More shards than workers, so that some shards are only drained by
+  // stealing.
+  auto threadManager = ThreadManager::newSimpleThreadManager(
+      2, false /*stats*/, 8 /*numShards*/);
+  threadManager->threadFactory(std::make_shared<PosixThreadFactory>());
+  threadManager->start();
+
+  constexpr size_t kProducers = 8;
+  constexpr size_t kTasksPerProducer = 1000;
+  std::atomic<size_t> ran{0};
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < kProducers; ++i) {
+    producers.emplace_back([&] {
+      for (size_t j = 0; j < kTasksPerProducer; ++j) {
+        threadManager->add([&] { ++ran; });
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  threadManager->join();
+  EXPECT_EQ(kProducers * kTasksPerProducer, ran.load());
+  EXPECT_EQ(0, threadManager->pendingTaskCount());
+}
+
+TEST_F(ThreadManagerTest, ShardsAssignedPerManager) {
+  auto first = ThreadManager::newSimpleThreadManager(
+      1, false /*stats*/, 2 /*numShards*/);
+  auto second = ThreadManager::newSimpleThreadManager(
+      1, false /*stats*/, 2 /*numShards*/);
+
+  // Threads using other managers in between don't skew the round-robin, so
+  // the first two threads to use a manager land on different shards.
+  auto codelOf = [](ThreadManager& threadManager) {
+    folly::Codel* codel = nullptr;
+    std::thread([&] { codel = threadManager.getCodel(); }).join();
+    return codel;
+  };
+  auto firstCodel = codelOf(*first);
+  codelOf(*second);
+  EXPECT_NE(firstCodel, codelOf(*first));
+}
+
+TEST_F(ThreadManagerTest, ShardedPriorityThreadManager) {
+  auto threadManager = PriorityThreadManager::newPriorityThreadManager(
+      {{1, 1, 1, 2, 1}}, false /*stats*/, 4 /*numShards*/);
+  threadManager->start();
+
+  std::atomic<size_t> ran{0};
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 4; ++i) {
+    producers.emplace_back([&, i] {
+      for (size_t j = 0; j < 100; ++j) {
+        threadManager->add(
+            static_cast<PRIORITY>((i + j) % N_PRIORITIES),
+            FunctionRunner::create([&] { ++ran; }));
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+
+  threadManager->join();
+  EXPECT_EQ(400, ran.load());
+}
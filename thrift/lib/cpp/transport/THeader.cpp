@@ -30,6 +30,7 @@
 #include <thrift/lib/cpp/protocol/TCompactProtocol.h>
 #include <thrift/lib/cpp/protocol/TProtocolTypes.h>
 #include <thrift/lib/cpp/transport/TBufferTransports.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp/util/THttpParser.h>
 #include <thrift/lib/cpp/util/VarintUtils.h>
 
@@ -501,6 +502,14 @@ unique_ptr<IOBuf> THeader::readHeaderFormat(
     buf = IOBuf::create(0);
   }
 
+  // Reflect the peer's dictionary, as with transforms above. Only the
+  // outermost transform's frame header is visible before untransforming.
+  if (!readTrans_.empty() && readTrans_.back() == ZSTD_TRANSFORM) {
+    if (auto dictionaryId = getZstdFrameDictionaryId(*buf)) {
+      zstdDictionaryId_ = dictionaryId;
+    }
+  }
+
   // Untransform data section
   buf = untransform(std::move(buf), readTrans_);
 
@@ -525,6 +534,27 @@ static unique_ptr<IOBuf> decompressCodec(
   }
 }
 
+// ZSTD_TRANSFORM frames name their dictionary, if any, in the frame header.
+static unique_ptr<IOBuf> decompressZstd(IOBuf const& buf) {
+  auto dictionaryId = getZstdFrameDictionaryId(buf);
+  if (dictionaryId == 0) {
+    return decompressCodec(buf, folly::io::CodecType::ZSTD);
+  }
+  auto dictionary = getZstdDictionary(dictionaryId);
+  if (!dictionary) {
+    throw TApplicationException(
+        TApplicationException::MISSING_RESULT,
+        fmt::format("Unknown zstd dictionary: {}", dictionaryId));
+  }
+  try {
+    return dictionary->uncompress(buf);
+  } catch (std::exception const& e) {
+    throw TApplicationException(
+        TApplicationException::MISSING_RESULT,
+        folly::exceptionStr(e).toStdString());
+  }
+}
+
 unique_ptr<IOBuf> THeader::untransform(
     unique_ptr<IOBuf> buf,
     std::vector<uint16_t>& readTrans) {
@@ -545,7 +575,7 @@ unique_ptr<IOBuf> THeader::untransform(
         }
         break;
       case ZSTD_TRANSFORM:
-        buf = decompressCodec(*buf, CodecType::ZSTD);
+        buf = decompressZstd(*buf);
         break;
       case QLZ_TRANSFORM:
         throw TApplicationException(
@@ -575,10 +605,32 @@ static unique_ptr<IOBuf> compressCodec(
   }
 }
 
+static unique_ptr<IOBuf> compressZstd(
+    IOBuf const& buf,
+    folly::Optional<uint32_t> dictionaryId) {
+  if (!dictionaryId) {
+    return compressCodec(buf, folly::io::CodecType::ZSTD, 1);
+  }
+  auto dictionary = getZstdDictionary(*dictionaryId);
+  if (!dictionary) {
+    throw TTransportException(
+        TTransportException::CORRUPTED_DATA,
+        fmt::format("Unknown zstd dictionary: {}", *dictionaryId));
+  }
+  try {
+    return dictionary->compress(buf);
+  } catch (std::exception const& e) {
+    throw TTransportException(
+        TTransportException::CORRUPTED_DATA,
+        folly::exceptionStr(e).toStdString());
+  }
+}
+
 unique_ptr<IOBuf> THeader::transform(
     unique_ptr<IOBuf> buf,
     std::vector<uint16_t>& writeTrans,
-    size_t minCompressBytes) {
+    size_t minCompressBytes,
+    folly::Optional<uint32_t> zstdDictionaryId) {
   size_t dataSize = buf->computeChainDataLength();
 
   for (vector<uint16_t>::iterator it = writeTrans.begin();
@@ -607,7 +659,7 @@ unique_ptr<IOBuf> THeader::transform(
           it = writeTrans.erase(it);
           continue;
         }
-        buf = compressCodec(*buf, CodecType::ZSTD, 1);
+        buf = compressZstd(*buf, zstdDictionaryId);
         break;
       case QLZ_TRANSFORM:
         throw TTransportException(
@@ -630,6 +682,7 @@ std::unique_ptr<THeader> THeader::clone() {
   clone->setProtocolId(protoId_);
   clone->setTransforms(writeTrans_);
   clone->setMinCompressBytes(minCompressBytes_);
+  clone->setZstdDictionaryId(zstdDictionaryId_);
   clone->setSequenceNumber(seqId_);
   clone->setClientType(clientType_);
   clone->setFlags(flags_);
@@ -761,7 +814,8 @@ unique_ptr<IOBuf> THeader::addHeader(
 
   if (clientType_ == THRIFT_HEADER_CLIENT_TYPE) {
     if (transform) {
-      buf = THeader::transform(std::move(buf), writeTrans, minCompressBytes_);
+      buf = THeader::transform(
+          std::move(buf), writeTrans, minCompressBytes_, zstdDictionaryId_);
     }
   }
   size_t chainSize = buf->computeChainDataLength();
@@ -159,12 +159,15 @@ class THeader {
    * transformed data.
    *
    * @param IOBuf to transform.  Returns transformed IOBuf (or chain)
+   * @param zstdDictionaryId registered dictionary for ZSTD_TRANSFORM, see
+   *        ZstdDictionary.h
    * @return transformed data IOBuf
    */
   static std::unique_ptr<folly::IOBuf> transform(
       std::unique_ptr<folly::IOBuf>,
       std::vector<uint16_t>& writeTrans,
-      size_t minCompressBytes);
+      size_t minCompressBytes,
+      folly::Optional<uint32_t> zstdDictionaryId = folly::none);
 
   /**
    * Clone a new THeader. Metadata is copied, but not headers.
@@ -303,6 +306,19 @@ class THeader {
     return minCompressBytes_;
   }
 
+  /**
+   * Compress ZSTD_TRANSFORM payloads against the dictionary registered under
+   * this id (see ZstdDictionary.h). The id travels in the zstd frame header;
+   * on read it is picked up from there so that replies use the same one.
+   */
+  void setZstdDictionaryId(folly::Optional<uint32_t> dictionaryId) {
+    zstdDictionaryId_ = dictionaryId;
+  }
+
+  folly::Optional<uint32_t> getZstdDictionaryId() const {
+    return zstdDictionaryId_;
+  }
+
   void setCrc32c(folly::Optional<uint32_t> crc32c) {
     crc32c_ = crc32c;
   }
@@ -412,6 +428,7 @@ class THeader {
   static const std::string ID_VERSION;
 
   uint32_t minCompressBytes_;
+  folly::Optional<uint32_t> zstdDictionaryId_;
   bool allowBigFrames_;
 
   /**
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
+
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fmt/core.h>
+#include <folly/Synchronized.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+#include <zstd.h>
+
+namespace apache {
+namespace thrift {
+namespace transport {
+
+namespace {
+
+struct CCtxDeleter {
+  void operator()(ZSTD_CCtx* ctx) const {
+    ZSTD_freeCCtx(ctx);
+  }
+};
+
+struct DCtxDeleter {
+  void operator()(ZSTD_DCtx* ctx) const {
+    ZSTD_freeDCtx(ctx);
+  }
+};
+
+// Contexts are expensive to create and not thread safe, dictionaries are
+// immutable and shared, so keep one context of each kind per thread.
+ZSTD_CCtx* threadCCtx() {
+  thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> ctx(ZSTD_createCCtx());
+  return ctx.get();
+}
+
+ZSTD_DCtx* threadDCtx() {
+  thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> ctx(ZSTD_createDCtx());
+  return ctx.get();
+}
+
+// zstd wants contiguous input; only chained buffers pay for a copy.
+folly::ByteRange contiguous(const folly::IOBuf& buf, folly::IOBuf& storage) {
+  if (!buf.isChained()) {
+    return {buf.data(), buf.length()};
+  }
+  storage = buf.cloneCoalescedAsValue();
+  return {storage.data(), storage.length()};
+}
+
+// Largest possible zstd frame header.
+constexpr size_t kMaxFrameHeaderBytes = 18;
+
+void checkZstd(size_t result, const char* what) {
+  if (ZSTD_isError(result)) {
+    throw std::runtime_error(
+        fmt::format("zstd {} failed: {}", what, ZSTD_getErrorName(result)));
+  }
+}
+
+using Registry =
+    std::unordered_map<uint32_t, std::shared_ptr<const ZstdDictionary>>;
+
+folly::Synchronized<Registry>& registry() {
+  static auto* instance = new folly::Synchronized<Registry>();
+  return *instance;
+}
+
+} // namespace
+
+ZstdDictionary::ZstdDictionary(
+    uint32_t id,
+    folly::ByteRange dictionary,
+    int level)
+    : id_(id),
+      cdict_(ZSTD_createCDict(dictionary.data(), dictionary.size(), level)),
+      ddict_(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+  if (!cdict_ || !ddict_) {
+    ZSTD_freeCDict(cdict_);
+    ZSTD_freeDDict(ddict_);
+    throw std::runtime_error(
+        fmt::format("Unable to load zstd dictionary {}", id));
+  }
+}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+std::unique_ptr<folly::IOBuf> ZstdDictionary::compress(
+    const folly::IOBuf& buf) const {
+  folly::IOBuf storage;
+  auto input = contiguous(buf, storage);
+  auto out = folly::IOBuf::create(ZSTD_compressBound(input.size()));
+  auto written = ZSTD_compress_usingCDict(
+      threadCCtx(),
+      out->writableTail(),
+      out->tailroom(),
+      input.data(),
+      input.size(),
+      cdict_);
+  checkZstd(written, "compress");
+  out->append(written);
+  return out;
+}
+
+std::unique_ptr<folly::IOBuf> ZstdDictionary::uncompress(
+    const folly::IOBuf& buf,
+    size_t maxBytes) const {
+  // Reject an oversized frame up front when its header says so, but never
+  // trust the header for the allocation itself: output grows a chunk at a
+  // time and the running total is checked against 'maxBytes'.
+  uint8_t header[kMaxFrameHeaderBytes];
+  folly::io::Cursor cursor(&buf);
+  auto headerSize = cursor.pullAtMost(header, sizeof(header));
+  auto declared = ZSTD_getFrameContentSize(header, headerSize);
+  if (declared == ZSTD_CONTENTSIZE_ERROR) {
+    throw std::runtime_error("zstd uncompress failed: bad frame header");
+  }
+  if (declared != ZSTD_CONTENTSIZE_UNKNOWN && declared > maxBytes) {
+    throw std::runtime_error(fmt::format(
+        "zstd uncompress failed: frame too large ({} > {})",
+        declared,
+        maxBytes));
+  }
+
+  constexpr size_t kChunkBytes = 64 * 1024;
+  auto dctx = threadDCtx();
+  checkZstd(ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only), "uncompress");
+  checkZstd(ZSTD_DCtx_refDDict(dctx, ddict_), "uncompress");
+  folly::IOBufQueue out(folly::IOBufQueue::cacheChainLength());
+  size_t total = 0;
+  auto next = buf.begin();
+  ZSTD_inBuffer input{nullptr, 0, 0};
+  // ZSTD_decompressStream() returns 0 once the frame is fully decoded.
+  size_t hint = 1;
+  while (hint != 0) {
+    while (input.pos == input.size && next != buf.end()) {
+      input = ZSTD_inBuffer{next->data(), next->size(), 0};
+      ++next;
+    }
+    auto chunk = folly::IOBuf::create(kChunkBytes);
+    ZSTD_outBuffer output{chunk->writableTail(), chunk->tailroom(), 0};
+    auto inputBefore = input.pos;
+    hint = ZSTD_decompressStream(dctx, &output, &input);
+    checkZstd(hint, "uncompress");
+    if (output.pos > 0) {
+      total += output.pos;
+      if (total > maxBytes) {
+        throw std::runtime_error(fmt::format(
+            "zstd uncompress failed: frame too large (more than {})",
+            maxBytes));
+      }
+      chunk->append(output.pos);
+      out.append(std::move(chunk));
+    } else if (hint != 0 && input.pos == inputBefore && next == buf.end()) {
+      throw std::runtime_error("zstd uncompress failed: truncated frame");
+    }
+  }
+  if (input.pos != input.size || next != buf.end()) {
+    throw std::runtime_error("zstd uncompress failed: trailing data");
+  }
+  auto ret = out.move();
+  return ret ? std::move(ret) : folly::IOBuf::create(0);
+}
+
+constexpr size_t ZstdDictionary::kDefaultMaxUncompressedBytes;
+
+void registerZstdDictionary(
+    uint32_t id,
+    folly::ByteRange dictionary,
+    int level) {
+  auto dict = std::make_shared<const ZstdDictionary>(id, dictionary, level);
+  registry().wlock()->insert_or_assign(id, std::move(dict));
+}
+
+uint32_t registerZstdDictionary(folly::ByteRange dictionary, int level) {
+  auto id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+  if (id == 0) {
+    throw std::invalid_argument(
+        "zstd dictionary has no embedded id; register it with an explicit id");
+  }
+  registerZstdDictionary(id, dictionary, level);
+  return id;
+}
+
+std::shared_ptr<const ZstdDictionary> getZstdDictionary(uint32_t id) {
+  auto locked = registry().rlock();
+  auto it = locked->find(id);
+  return it == locked->end() ? nullptr : it->second;
+}
+
+uint32_t getZstdFrameDictionaryId(const folly::IOBuf& buf) {
+  uint8_t header[kMaxFrameHeaderBytes];
+  folly::io::Cursor cursor(&buf);
+  auto size = cursor.pullAtMost(header, sizeof(header));
+  return ZSTD_getDictID_fromFrame(header, size);
+}
+
+} // namespace transport
+} // namespace thrift
+} // namespace apache
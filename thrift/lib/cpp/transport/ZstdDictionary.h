@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace apache {
+namespace thrift {
+namespace transport {
+
+/**
+ * A pre-trained zstd dictionary. Small messages share most of their bytes
+ * (field ids, enum values, repeated keys), so compressing them against a
+ * dictionary trained on a sample of real traffic gives far better ratios
+ * than compressing each message on its own.
+ *
+ * Both peers must register the same dictionary bytes under the same id; the
+ * id is what travels on the wire.
+ */
+class ZstdDictionary {
+ public:
+  ZstdDictionary(uint32_t id, folly::ByteRange dictionary, int level = 1);
+  ~ZstdDictionary();
+
+  ZstdDictionary(const ZstdDictionary&) = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  uint32_t id() const {
+    return id_;
+  }
+
+  /**
+   * Compresses 'buf' into a single zstd frame. Throws std::runtime_error on
+   * failure.
+   */
+  std::unique_ptr<folly::IOBuf> compress(const folly::IOBuf& buf) const;
+
+  /**
+   * Uncompresses a frame produced by compress(). Throws std::runtime_error if
+   * the frame is corrupt, was compressed with another dictionary, or would
+   * uncompress to more than 'maxBytes'. Output is allocated as it is
+   * produced, never from the size the frame header declares.
+   */
+  std::unique_ptr<folly::IOBuf> uncompress(
+      const folly::IOBuf& buf,
+      size_t maxBytes = kDefaultMaxUncompressedBytes) const;
+
+  static constexpr size_t kDefaultMaxUncompressedBytes = size_t(64) << 20;
+
+ private:
+  const uint32_t id_;
+  ZSTD_CDict_s* cdict_{nullptr};
+  ZSTD_DDict_s* ddict_{nullptr};
+};
+
+/**
+ * Registers 'dictionary' under 'id' for the whole process, replacing any
+ * dictionary previously registered under that id. Messages already in flight
+ * keep the dictionary they looked up.
+ */
+void registerZstdDictionary(
+    uint32_t id,
+    folly::ByteRange dictionary,
+    int level = 1);
+
+/**
+ * Registers a dictionary trained by zstd (see ZstdDictionaryTrainer) under
+ * the id embedded in it, and returns that id. Throws std::invalid_argument
+ * for raw-content dictionaries, which carry no id.
+ *
+ * THeader's ZSTD_TRANSFORM finds dictionaries through the id zstd writes into
+ * each frame header, so it only works with dictionaries registered this way.
+ */
+uint32_t registerZstdDictionary(folly::ByteRange dictionary, int level = 1);
+
+/**
+ * Returns the dictionary registered under 'id', or nullptr.
+ */
+std::shared_ptr<const ZstdDictionary> getZstdDictionary(uint32_t id);
+
+/**
+ * Returns the dictionary id recorded in the header of the zstd frame at the
+ * start of 'buf', or 0 if the frame was compressed without one.
+ */
+uint32_t getZstdFrameDictionaryId(const folly::IOBuf& buf);
+
+} // namespace transport
+} // namespace thrift
+} // namespace apache
@@ -20,12 +20,16 @@
  */
 
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp/util/THttpParser.h>
 
 #include <folly/Random.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/IOBufQueue.h>
 #include <memory>
+#include <string>
+#include <vector>
+#include <zdict.h>
 
 #include <folly/portability/GTest.h>
 
@@ -168,6 +172,72 @@ void testAsciiHeaderData(const std::string& data, const std::string& expected) {
   }
 }
 
+namespace {
+
+std::string makeZstdMessage(int i) {
+  return "{\"id\":" + std::to_string(i) +
+      ",\"status\":\"ok\",\"region\":\"region-" + std::to_string(i % 5) +
+      "\",\"tags\":[\"alpha\",\"beta\",\"gamma\"]}";
+}
+
+std::string trainZstdDictionary(uint32_t id) {
+  std::string samples;
+  std::vector<size_t> sizes;
+  for (int i = 0; i < 2000; ++i) {
+    auto sample = makeZstdMessage(i);
+    samples += sample;
+    sizes.push_back(sample.size());
+  }
+  std::string dict(16 * 1024, '\0');
+  auto size = ZDICT_trainFromBuffer(
+      &dict[0],
+      dict.size(),
+      samples.data(),
+      sizes.data(),
+      static_cast<unsigned>(sizes.size()));
+  EXPECT_FALSE(ZDICT_isError(size));
+  dict.resize(size);
+  for (size_t i = 0; i < 4; ++i) {
+    dict[4 + i] = static_cast<char>((id >> (8 * i)) & 0xff);
+  }
+  return dict;
+}
+
+} // namespace
+
+TEST(THeaderTest, zstdDictionary) {
+  auto id = registerZstdDictionary(ByteRange(StringPiece(
+      trainZstdDictionary(4242))));
+  EXPECT_EQ(4242, id);
+
+  auto message = makeZstdMessage(12345);
+  auto plain = THeader::transform(
+      IOBuf::copyBuffer(message), {THeader::ZSTD_TRANSFORM}, 0);
+  auto compressed = THeader::transform(
+      IOBuf::copyBuffer(message), {THeader::ZSTD_TRANSFORM}, 0, id);
+  EXPECT_EQ(0, getZstdFrameDictionaryId(*plain));
+  EXPECT_EQ(id, getZstdFrameDictionaryId(*compressed));
+  EXPECT_LT(
+      compressed->computeChainDataLength(), plain->computeChainDataLength());
+
+  // The reading side finds the dictionary through the frame header and
+  // remembers it so replies are compressed the same way.
+  THeader writer;
+  writer.setTransform(THeader::ZSTD_TRANSFORM);
+  writer.setZstdDictionaryId(id);
+  THeader::StringToStringMap persistentHeaders;
+  auto frame = writer.addHeader(IOBuf::copyBuffer(message), persistentHeaders);
+
+  THeader reader;
+  IOBufQueue queue(IOBufQueue::cacheChainLength());
+  queue.append(std::move(frame));
+  size_t needed;
+  auto buf = reader.removeHeader(&queue, needed, persistentHeaders);
+  ASSERT_NE(nullptr, buf);
+  EXPECT_EQ(message, buf->moveToFbString().toStdString());
+  EXPECT_EQ(folly::Optional<uint32_t>(id), reader.getZstdDictionaryId());
+}
+
 TEST(THeaderTest, asciiData1) {
   std::string data = "llocations statistics!";
   auto expected = "The Thrift server received an ASCII request '" + data +
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Trains a zstd dictionary for THeader's ZSTD_TRANSFORM (and rocket payload
+ * compression) from a sample of serialized messages, e.g.
+ *
+ *   zstd_dictionary_trainer --format=theader --output=svc.dict frames.bin
+ *
+ * Sample formats:
+ *   files           - every input file is one serialized message
+ *   length_prefixed - inputs hold messages, each preceded by a 4-byte
+ *                     big-endian length
+ *   theader         - inputs hold raw THeader frames as read off the wire;
+ *                     the payload of each frame (after untransforming) is a
+ *                     sample
+ *
+ * The dictionary id is embedded in the output, which is what
+ * HeaderClientChannel::useZstdDictionary and ThriftServer::loadZstdDictionary
+ * key on. Prints the compression ratio over the samples with and without the
+ * dictionary. Use samples that were not part of the training set for an
+ * honest estimate.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <folly/FileUtil.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <zdict.h>
+#include <zstd.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+
+DEFINE_string(output, "", "Where to write the trained dictionary");
+DEFINE_string(format, "files", "files, length_prefixed or theader");
+DEFINE_uint32(dict_id, 0, "Dictionary id to embed; 0 keeps zstd's choice");
+DEFINE_uint64(max_dict_bytes, 64 * 1024, "Maximum dictionary size");
+DEFINE_int32(level, 1, "Compression level used to report ratios");
+
+using apache::thrift::transport::THeader;
+
+namespace {
+
+using Samples = std::vector<std::string>;
+
+void readLengthPrefixed(const std::string& data, Samples& samples) {
+  auto buf = folly::IOBuf::wrapBuffer(data.data(), data.size());
+  folly::io::Cursor cursor(buf.get());
+  while (!cursor.isAtEnd()) {
+    auto size = cursor.readBE<uint32_t>();
+    samples.push_back(cursor.readFixedString(size));
+  }
+}
+
+void readTHeaderFrames(const std::string& data, Samples& samples) {
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  queue.append(folly::IOBuf::copyBuffer(data));
+  THeader::StringToStringMap persistentHeaders;
+  while (!queue.empty()) {
+    THeader header(THeader::ALLOW_BIG_FRAMES);
+    size_t needed = 0;
+    auto buf = header.removeHeader(&queue, needed, persistentHeaders);
+    if (!buf) {
+      LOG(WARNING) << "Ignoring " << queue.chainLength()
+                   << " trailing bytes of a truncated frame";
+      break;
+    }
+    samples.push_back(buf->moveToFbString().toStdString());
+  }
+}
+
+size_t compressedSize(
+    ZSTD_CCtx* ctx,
+    const std::string& sample,
+    const ZSTD_CDict* dict) {
+  std::string out(ZSTD_compressBound(sample.size()), '\0');
+  size_t written;
+  if (dict) {
+    written = ZSTD_compress_usingCDict(
+        ctx, &out[0], out.size(), sample.data(), sample.size(), dict);
+  } else {
+    written = ZSTD_compressCCtx(
+        ctx, &out[0], out.size(), sample.data(), sample.size(), FLAGS_level);
+  }
+  CHECK(!ZSTD_isError(written)) << ZSTD_getErrorName(written);
+  return written;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  gflags::SetUsageMessage("zstd_dictionary_trainer --output=FILE INPUT...");
+  google::InitGoogleLogging(argv[0]);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_output.empty() || argc < 2) {
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 1;
+  }
+
+  Samples samples;
+  for (int i = 1; i < argc; ++i) {
+    std::string data;
+    if (!folly::readFile(argv[i], data)) {
+      PLOG(ERROR) << "Unable to read " << argv[i];
+      return 1;
+    }
+    if (FLAGS_format == "files") {
+      samples.push_back(std::move(data));
+    } else if (FLAGS_format == "length_prefixed") {
+      readLengthPrefixed(data, samples);
+    } else if (FLAGS_format == "theader") {
+      readTHeaderFrames(data, samples);
+    } else {
+      LOG(ERROR) << "Unknown --format " << FLAGS_format;
+      return 1;
+    }
+  }
+
+  std::string concatenated;
+  std::vector<size_t> sizes;
+  for (const auto& sample : samples) {
+    concatenated += sample;
+    sizes.push_back(sample.size());
+  }
+  LOG(INFO) << "Training on " << samples.size() << " samples, "
+            << concatenated.size() << " bytes";
+
+  std::string dict(FLAGS_max_dict_bytes, '\0');
+  auto dictSize = ZDICT_trainFromBuffer(
+      &dict[0],
+      dict.size(),
+      concatenated.data(),
+      sizes.data(),
+      static_cast<unsigned>(sizes.size()));
+  if (ZDICT_isError(dictSize)) {
+    LOG(ERROR) << "Training failed: " << ZDICT_getErrorName(dictSize)
+               << " (zstd needs at least a few hundred samples)";
+    return 1;
+  }
+  dict.resize(dictSize);
+
+  if (FLAGS_dict_id != 0) {
+    // The id is the little-endian word following the dictionary magic.
+    for (size_t i = 0; i < 4; ++i) {
+      dict[4 + i] = static_cast<char>((FLAGS_dict_id >> (8 * i)) & 0xff);
+    }
+  }
+  auto dictId = ZDICT_getDictID(dict.data(), dict.size());
+  CHECK_NE(0u, dictId);
+
+  auto* cdict = ZSTD_createCDict(dict.data(), dict.size(), FLAGS_level);
+  auto* ctx = ZSTD_createCCtx();
+  CHECK(cdict && ctx);
+  size_t raw = 0;
+  size_t plain = 0;
+  size_t withDict = 0;
+  for (const auto& sample : samples) {
+    raw += sample.size();
+    plain += compressedSize(ctx, sample, nullptr);
+    withDict += compressedSize(ctx, sample, cdict);
+  }
+  ZSTD_freeCCtx(ctx);
+  ZSTD_freeCDict(cdict);
+
+  if (!folly::writeFile(dict, FLAGS_output.c_str())) {
+    PLOG(ERROR) << "Unable to write " << FLAGS_output;
+    return 1;
+  }
+
+  printf("dictionary id:   %u\n", dictId);
+  printf("dictionary size: %zu bytes\n", dict.size());
+  printf(
+      "ratio at level %d: %.2fx without dictionary, %.2fx with\n",
+      FLAGS_level,
+      plain ? double(raw) / plain : 0.0,
+      withDict ? double(raw) / withDict : 0.0);
+  return 0;
+}
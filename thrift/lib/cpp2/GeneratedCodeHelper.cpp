@@ -78,7 +78,8 @@ void helper<ProtocolReader, ProtocolWriter>::process_exn(
     queue.append(THeader::transform(
         queue.move(),
         ctx->getHeader()->getWriteTransforms(),
-        ctx->getHeader()->getMinCompressBytes()));
+        ctx->getHeader()->getMinCompressBytes(),
+        ctx->getHeader()->getZstdDictionaryId()));
     eb->runInEventBaseThread(
         [que = move(queue), request = move(req)]() mutable {
           if (request->isStream()) {
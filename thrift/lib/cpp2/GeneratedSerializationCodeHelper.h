@@ -21,9 +21,13 @@
 #include <iterator>
 #include <list>
 #include <memory>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <type_traits>
 #include <vector>
 
+#include <folly/Traits.h>
 #include <folly/Utility.h>
 #include <folly/functional/Invoke.h>
 #include <folly/io/IOBuf.h>
@@ -111,6 +115,99 @@ template <typename T>
 using set_emplace_hint_is_invocable = emplace_hint_traits::
     is_invocable<T, typename T::iterator, typename T::value_type>;
 
+FOLLY_CREATE_MEMBER_INVOKE_TRAITS(read_fixed_array_traits, readFixedArray);
+FOLLY_CREATE_MEMBER_INVOKE_TRAITS(write_fixed_array_traits, writeFixedArray);
+FOLLY_CREATE_MEMBER_INVOKE_TRAITS(read_varint_array_traits, readVarintArray);
+FOLLY_CREATE_MEMBER_INVOKE_TRAITS(write_varint_array_traits, writeVarintArray);
+
+template <typename T>
+using is_bulk_array_elem = folly::IsOneOf<
+    T,
+    std::int16_t,
+    std::int32_t,
+    std::int64_t,
+    float,
+    double>;
+
+template <typename T>
+struct is_std_vector : std::false_type {};
+template <typename T, typename Alloc>
+struct is_std_vector<std::vector<T, Alloc>> : std::true_type {};
+
+/*
+ * Some protocols can (de)serialize a run of numbers much faster than one
+ * element at a time: BinaryProtocol encodes them as a plain big-endian array
+ * (readFixedArray/writeFixedArray), CompactProtocol as a run of zigzag
+ * varints (readVarintArray/writeVarintArray). `bulk_array_reader` and
+ * `bulk_array_writer` pick whichever the protocol provides for element type
+ * `T`, and derive from std::false_type if it provides neither.
+ */
+template <typename Protocol, typename T, typename = void>
+struct bulk_array_reader : std::false_type {};
+
+template <typename Protocol, typename T>
+struct bulk_array_reader<
+    Protocol,
+    T,
+    std::enable_if_t<
+        is_bulk_array_elem<T>::value &&
+        read_fixed_array_traits::is_invocable<Protocol, T*, std::size_t>::
+            value>> : std::true_type {
+  static void read(Protocol& protocol, T* data, std::size_t size) {
+    protocol.readFixedArray(data, size);
+  }
+};
+
+template <typename Protocol, typename T>
+struct bulk_array_reader<
+    Protocol,
+    T,
+    std::enable_if_t<
+        is_bulk_array_elem<T>::value &&
+        !read_fixed_array_traits::is_invocable<Protocol, T*, std::size_t>::
+            value &&
+        read_varint_array_traits::is_invocable<Protocol, T*, std::size_t>::
+            value>> : std::true_type {
+  static void read(Protocol& protocol, T* data, std::size_t size) {
+    protocol.readVarintArray(data, size);
+  }
+};
+
+template <typename Protocol, typename T, typename = void>
+struct bulk_array_writer : std::false_type {};
+
+template <typename Protocol, typename T>
+struct bulk_array_writer<
+    Protocol,
+    T,
+    std::enable_if_t<
+        is_bulk_array_elem<T>::value &&
+        write_fixed_array_traits::
+            is_invocable<Protocol, T const*, std::size_t>::value>>
+    : std::true_type {
+  static std::size_t
+  write(Protocol& protocol, T const* data, std::size_t size) {
+    return protocol.writeFixedArray(data, size);
+  }
+};
+
+template <typename Protocol, typename T>
+struct bulk_array_writer<
+    Protocol,
+    T,
+    std::enable_if_t<
+        is_bulk_array_elem<T>::value &&
+        !write_fixed_array_traits::
+            is_invocable<Protocol, T const*, std::size_t>::value &&
+        write_varint_array_traits::
+            is_invocable<Protocol, T const*, std::size_t>::value>>
+    : std::true_type {
+  static std::size_t
+  write(Protocol& protocol, T const* data, std::size_t size) {
+    return protocol.writeVarintArray(data, size);
+  }
+};
+
 template <typename Map, typename KeyDeserializer, typename MappedDeserializer>
 typename std::enable_if<
     presorted_constructible_from_vector_value_type<Map>::value>::type
@@ -364,6 +461,40 @@ REGISTER_ZC(binary, folly::IOBuf, Binary, T_STRING);
 REGISTER_ZC(binary, std::unique_ptr<folly::IOBuf>, Binary, T_STRING);
 REGISTER_ZC(binary, folly::fbstring, Binary, T_STRING);
 #undef REGISTER_ZC // this naming sure isn't confusing, no sir
+
+#if __has_include(<memory_resource>)
+// std::pmr::string (used by the `allocator_aware` generator option) has no
+// implicit conversion to folly::StringPiece, so writes go through an explicit
+// view of its bytes. Reads append into the string, which keeps the memory
+// resource it was constructed with.
+#define REGISTER_PMR_STRING(Class, Method, TTypeValue)                   \
+  template <>                                                            \
+  struct protocol_methods<type_class::Class, std::pmr::string> {         \
+    constexpr static protocol::TType ttype_value = protocol::TTypeValue; \
+    template <typename Protocol>                                         \
+    static void read(Protocol& protocol, std::pmr::string& out) {        \
+      protocol.read##Method(out);                                        \
+    }                                                                    \
+    template <typename Protocol>                                         \
+    static std::size_t write(                                            \
+        Protocol& protocol,                                              \
+        std::pmr::string const& in) {                                    \
+      return protocol.write##Method(                                     \
+          folly::StringPiece(in.data(), in.size()));                     \
+    }                                                                    \
+    template <bool, typename Protocol>                                   \
+    static std::size_t serializedSize(                                   \
+        Protocol& protocol,                                              \
+        std::pmr::string const& in) {                                    \
+      return protocol.serializedSize##Method(                            \
+          folly::StringPiece(in.data(), in.size()));                     \
+    }                                                                    \
+  }
+
+REGISTER_PMR_STRING(string, String, T_STRING);
+REGISTER_PMR_STRING(binary, Binary, T_STRING);
+#undef REGISTER_PMR_STRING
+#endif
 #undef REGISTER_SS_COMMON
 #undef REGISTER_RW_COMMON
 
@@ -412,6 +543,49 @@ struct protocol_methods<type_class::list<ElemClass>, Type> {
   using elem_type = typename Type::value_type;
   using elem_methods = protocol_methods<ElemClass, elem_type>;
 
+ private:
+  template <typename Protocol>
+  using bulk_reader = bulk_array_reader<Protocol, elem_type>;
+  template <typename Protocol>
+  using bulk_writer = bulk_array_writer<Protocol, elem_type>;
+
+  template <typename Protocol>
+  static typename std::enable_if<
+      is_std_vector<Type>::value && bulk_reader<Protocol>::value>::type
+  read_elems(Protocol& protocol, Type& out) {
+    bulk_reader<Protocol>::read(protocol, out.data(), out.size());
+  }
+
+  template <typename Protocol>
+  static typename std::enable_if<
+      !(is_std_vector<Type>::value && bulk_reader<Protocol>::value)>::type
+  read_elems(Protocol& protocol, Type& out) {
+    for (auto&& elem : out) {
+      elem_methods::read(protocol, elem);
+    }
+  }
+
+  template <typename Protocol>
+  static typename std::enable_if<
+      is_std_vector<Type>::value && bulk_writer<Protocol>::value,
+      std::size_t>::type
+  write_elems(Protocol& protocol, Type const& out) {
+    return bulk_writer<Protocol>::write(protocol, out.data(), out.size());
+  }
+
+  template <typename Protocol>
+  static typename std::enable_if<
+      !(is_std_vector<Type>::value && bulk_writer<Protocol>::value),
+      std::size_t>::type
+  write_elems(Protocol& protocol, Type const& out) {
+    std::size_t xfer = 0;
+    for (auto const& elem : out) {
+      xfer += elem_methods::write(protocol, elem);
+    }
+    return xfer;
+  }
+
+ public:
   template <typename Protocol>
   static void read(Protocol& protocol, Type& out) {
     std::uint32_t list_size = -1;
@@ -439,9 +613,7 @@ struct protocol_methods<type_class::list<ElemClass>, Type> {
         apache::thrift::skip_n(protocol, list_size, {reported_type});
       } else {
         out.resize(list_size);
-        for (auto&& elem : out) {
-          elem_methods::read(protocol, elem);
-        }
+        read_elems(protocol, out);
       }
     }
     protocol.readListEnd();
@@ -452,9 +624,7 @@ struct protocol_methods<type_class::list<ElemClass>, Type> {
     std::size_t xfer = 0;
 
     xfer += protocol.writeListBegin(elem_methods::ttype_value, out.size());
-    for (auto const& elem : out) {
-      xfer += elem_methods::write(protocol, elem);
-    }
+    xfer += write_elems(protocol, out);
     xfer += protocol.writeListEnd();
     return xfer;
   }
@@ -577,6 +747,41 @@ struct protocol_methods<type_class::set<ElemClass>, Type> {
     out.insert(std::move(tmp));
   }
 
+  template <typename Protocol>
+  using bulk_reader = bulk_array_reader<Protocol, elem_type>;
+
+  // Decode the run of numbers in chunks ahead of building the set from it.
+  // The size comes off the wire, so the buffer is bounded by a chunk rather
+  // than sized from it.
+  template <typename Protocol>
+  static typename std::enable_if<bulk_reader<Protocol>::value>::type
+  read_elems(Protocol& protocol, Type& out, std::uint32_t set_size) {
+    constexpr std::uint32_t kChunkSize = 1024;
+    std::vector<elem_type> values;
+    values.reserve(std::min(set_size, kChunkSize));
+    std::uint32_t left = set_size;
+    std::size_t next = 0;
+    auto const vreader = [&](auto& value) {
+      if (next == values.size()) {
+        values.resize(std::min(left, kChunkSize));
+        bulk_reader<Protocol>::read(protocol, values.data(), values.size());
+        left -= static_cast<std::uint32_t>(values.size());
+        next = 0;
+      }
+      value = values[next++];
+    };
+    deserialize_known_length_set(out, set_size, vreader);
+  }
+
+  template <typename Protocol>
+  static typename std::enable_if<!bulk_reader<Protocol>::value>::type
+  read_elems(Protocol& protocol, Type& out, std::uint32_t set_size) {
+    auto const vreader = [&protocol](auto& value) {
+      elem_methods::read(protocol, value);
+    };
+    deserialize_known_length_set(out, set_size, vreader);
+  }
+
  public:
   template <typename Protocol>
   static void read(Protocol& protocol, Type& out) {
@@ -593,10 +798,7 @@ struct protocol_methods<type_class::set<ElemClass>, Type> {
           reported_type != elem_methods::ttype_value) {
         apache::thrift::skip_n(protocol, set_size, {reported_type});
       } else {
-        auto const vreader = [&protocol](auto& value) {
-          elem_methods::read(protocol, value);
-        };
-        deserialize_known_length_set(out, set_size, vreader);
+        read_elems(protocol, out, set_size);
       }
     }
     protocol.readSetEnd();
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+#include <folly/CPortability.h>
+#include <folly/Likely.h>
+#include <folly/MicroSpinLock.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include <thrift/lib/cpp2/GeneratedSerializationCodeHelper.h>
+#include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
+#include <thrift/lib/cpp2/protocol/CompactProtocol.h>
+
+namespace apache {
+namespace thrift {
+namespace detail {
+
+/*
+ * Protocols whose encoding of a value is self-contained, so that the bytes of
+ * a field can be captured by one reader and replayed verbatim by a writer of
+ * the same protocol.
+ */
+template <typename Protocol>
+struct lazy_field_protocol {
+  static constexpr bool supported = false;
+};
+
+#define THRIFT_LAZY_FIELD_PROTOCOL(Class, Id)              \
+  template <>                                              \
+  struct lazy_field_protocol<Class> {                      \
+    static constexpr bool supported = true;                \
+    static constexpr ProtocolType id = protocol::Id;       \
+  }
+
+THRIFT_LAZY_FIELD_PROTOCOL(BinaryProtocolReader, T_BINARY_PROTOCOL);
+THRIFT_LAZY_FIELD_PROTOCOL(BinaryProtocolWriter, T_BINARY_PROTOCOL);
+THRIFT_LAZY_FIELD_PROTOCOL(CompactProtocolReader, T_COMPACT_PROTOCOL);
+THRIFT_LAZY_FIELD_PROTOCOL(CompactProtocolWriter, T_COMPACT_PROTOCOL);
+
+#undef THRIFT_LAZY_FIELD_PROTOCOL
+
+/**
+ * The still-serialized value of a `cpp.lazy` field.
+ *
+ * When a struct is read with the Binary or Compact protocol, the field is
+ * skipped and the bytes it spans are kept here as a shared IOBuf slice. The
+ * value is only decoded by the first accessor call, and writing the struct
+ * with the same protocol copies the slice out verbatim, so a field that is
+ * never looked at is never decoded or re-encoded.
+ *
+ * The struct member stays public but holds no value until an accessor has
+ * decoded it. From then on the member is authoritative: non-const accessors
+ * and setters drop the bytes, and a change made to the member directly is
+ * written out instead of them.
+ *
+ * Const accessors, comparisons and serialization may decode the field from
+ * several threads at once, as with any const use of a struct. The decode runs
+ * once, under a spin lock, and is published through `decoded_`. The bytes are
+ * left in place until the next non-const access, so that a concurrent writer
+ * that still copies them out verbatim does not race with the decode.
+ */
+class LazyField {
+ public:
+  LazyField() = default;
+
+  LazyField(const LazyField& other)
+      : raw_(other.raw_ ? other.raw_->clone() : nullptr),
+        protocol_(other.protocol_),
+        decoded_(other.decoded_.load(std::memory_order_acquire)) {}
+
+  LazyField(LazyField&& other) noexcept
+      : raw_(std::move(other.raw_)),
+        protocol_(other.protocol_),
+        decoded_(other.decoded_.load(std::memory_order_relaxed)) {
+    other.decoded_.store(true, std::memory_order_relaxed);
+  }
+
+  LazyField& operator=(const LazyField& other) {
+    raw_ = other.raw_ ? other.raw_->clone() : nullptr;
+    protocol_ = other.protocol_;
+    decoded_.store(
+        other.decoded_.load(std::memory_order_acquire),
+        std::memory_order_relaxed);
+    return *this;
+  }
+
+  LazyField& operator=(LazyField&& other) noexcept {
+    raw_ = std::move(other.raw_);
+    protocol_ = other.protocol_;
+    decoded_.store(
+        other.decoded_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    other.decoded_.store(true, std::memory_order_relaxed);
+    return *this;
+  }
+
+  /**
+   * Whether the field still holds serialized bytes that have not been
+   * decoded into the struct member.
+   */
+  bool pending() const {
+    return !decoded_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Drops the serialized bytes. Called by setters, after which the struct
+   * member is authoritative.
+   */
+  void reset() {
+    raw_.reset();
+    decoded_.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * Reads the next value off `prot`. Supported protocols capture its bytes;
+   * any other protocol decodes it into `value` right away.
+   */
+  template <typename TypeClass, typename T, typename Protocol>
+  std::enable_if_t<lazy_field_protocol<Protocol>::supported> read(
+      Protocol& prot,
+      T& /*value*/) {
+    folly::io::Cursor start = prot.getCursor();
+    auto const begin = prot.getCursorPosition();
+    prot.skip(pm::protocol_methods<TypeClass, T>::ttype_value);
+    start.clone(raw_, prot.getCursorPosition() - begin);
+    // The input may be a caller-owned buffer that only lives for the
+    // duration of the read.
+    raw_->makeManaged();
+    protocol_ = lazy_field_protocol<Protocol>::id;
+    decoded_.store(false, std::memory_order_relaxed);
+  }
+
+  template <typename TypeClass, typename T, typename Protocol>
+  std::enable_if_t<!lazy_field_protocol<Protocol>::supported> read(
+      Protocol& prot,
+      T& value) {
+    reset();
+    value = T();
+    pm::protocol_methods<TypeClass, T>::read(prot, value);
+  }
+
+  /**
+   * Returns `value`, decoding the captured bytes into it first if needed.
+   * Safe to call concurrently with other const uses of the struct.
+   */
+  template <typename TypeClass, typename T>
+  T& get(T& value) const {
+    if (UNLIKELY(!decoded_.load(std::memory_order_acquire))) {
+      decode<TypeClass>(value);
+    }
+    return value;
+  }
+
+  /**
+   * Like get(), for non-const accessors: the caller may change `value`, so
+   * the captured bytes are dropped.
+   */
+  template <typename TypeClass, typename T>
+  T& getMutable(T& value) {
+    get<TypeClass>(value);
+    raw_.reset();
+    return value;
+  }
+
+  /**
+   * Copies `other` and the struct member it belongs to into this field and
+   * `value`, without racing with a decode of `other` on another thread.
+   */
+  template <typename T>
+  void copyFrom(const LazyField& other, T& value, const T& otherValue) {
+    bool decoded = other.decoded_.load(std::memory_order_acquire);
+    if (decoded) {
+      value = otherValue;
+    } else {
+      folly::MSLGuard guard(other.lock_);
+      decoded = other.decoded_.load(std::memory_order_relaxed);
+      value = otherValue;
+    }
+    raw_ = decoded || !other.raw_ ? nullptr : other.raw_->clone();
+    protocol_ = other.protocol_;
+    decoded_.store(decoded, std::memory_order_relaxed);
+  }
+
+  template <typename TypeClass, typename T, typename Protocol>
+  std::size_t write(Protocol& prot, T& value) const {
+    if (writesVerbatim(prot)) {
+      return prot.writeSerializedData(raw_);
+    }
+    return pm::protocol_methods<TypeClass, T>::write(
+        prot, get<TypeClass>(value));
+  }
+
+  template <bool ZeroCopy, typename TypeClass, typename T, typename Protocol>
+  std::size_t serializedSize(Protocol& prot, T& value) const {
+    if (writesVerbatim(prot)) {
+      return ZeroCopy ? prot.serializedSizeSerializedData(raw_)
+                      : raw_->computeChainDataLength();
+    }
+    return pm::protocol_methods<TypeClass, T>::template serializedSize<
+        ZeroCopy>(prot, get<TypeClass>(value));
+  }
+
+ private:
+  // Once decoded, the member may have been changed directly, so it is
+  // written out rather than the bytes.
+  template <typename Protocol>
+  std::enable_if_t<
+      lazy_field_protocol<std::remove_const_t<Protocol>>::supported,
+      bool>
+  writesVerbatim(Protocol&) const {
+    return pending() &&
+        protocol_ == lazy_field_protocol<std::remove_const_t<Protocol>>::id;
+  }
+
+  template <typename Protocol>
+  std::enable_if_t<
+      !lazy_field_protocol<std::remove_const_t<Protocol>>::supported,
+      bool>
+  writesVerbatim(Protocol&) const {
+    return false;
+  }
+
+  template <typename TypeClass, typename T>
+  FOLLY_NOINLINE void decode(T& value) const {
+    folly::MSLGuard guard(lock_);
+    if (decoded_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (protocol_ == protocol::T_BINARY_PROTOCOL) {
+      decodeWith<BinaryProtocolReader, TypeClass>(value);
+    } else {
+      decodeWith<CompactProtocolReader, TypeClass>(value);
+    }
+    decoded_.store(true, std::memory_order_release);
+  }
+
+  template <typename Reader, typename TypeClass, typename T>
+  void decodeWith(T& value) const {
+    Reader reader;
+    reader.setInput(raw_.get());
+    value = T();
+    pm::protocol_methods<TypeClass, T>::read(reader, value);
+  }
+
+  // Only changed by non-const members, so const ones may read it freely.
+  std::unique_ptr<folly::IOBuf> raw_;
+  ProtocolType protocol_{protocol::T_BINARY_PROTOCOL};
+  // Whether the struct member holds the value. False while `raw_` still
+  // has to be decoded.
+  mutable std::atomic<bool> decoded_{true};
+  mutable folly::MicroSpinLock lock_{0};
+};
+
+} // namespace detail
+} // namespace thrift
+} // namespace apache
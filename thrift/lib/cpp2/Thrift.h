@@ -23,6 +23,9 @@
 #include <thrift/lib/cpp2/TypeClass.h>
 
 #include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #include <cstdint>
@@ -57,6 +60,62 @@ struct ComparisonOperators {
   }
 };
 
+/**
+ *  Uses-allocator construction, as done by std::scoped_allocator_adaptor and
+ *  the std::pmr containers: `alloc` is passed along if T accepts it, either
+ *  as a leading std::allocator_arg pair or as a trailing argument, and is
+ *  dropped otherwise.
+ */
+template <typename T, typename Alloc, typename... Args>
+std::enable_if_t<
+    std::uses_allocator<T, Alloc>::value &&
+        std::is_constructible<T, std::allocator_arg_t, Alloc const&, Args...>::
+            value,
+    T>
+construct_with_allocator(Alloc const& alloc, Args&&... args) {
+  return T(std::allocator_arg, alloc, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+std::enable_if_t<
+    std::uses_allocator<T, Alloc>::value &&
+        !std::is_constructible<T, std::allocator_arg_t, Alloc const&, Args...>::
+            value,
+    T>
+construct_with_allocator(Alloc const& alloc, Args&&... args) {
+  return T(std::forward<Args>(args)..., alloc);
+}
+
+template <typename T, typename Alloc, typename... Args>
+std::enable_if_t<!std::uses_allocator<T, Alloc>::value, T>
+construct_with_allocator(Alloc const&, Args&&... args) {
+  return T(std::forward<Args>(args)...);
+}
+
+/**
+ *  Re-homes `value` onto `alloc`. Allocator-aware members keep the allocator
+ *  they were constructed with across assignment, so the member is rebuilt in
+ *  place around a copy that was constructed with `alloc`. Members that do not
+ *  use allocators are left untouched.
+ */
+template <typename T, typename Alloc>
+std::enable_if_t<std::uses_allocator<T, Alloc>::value> move_to_allocator(
+    T& value,
+    Alloc const& alloc) {
+  static_assert(
+      std::is_nothrow_move_constructible<T>::value,
+      "rebuilding in place requires a non-throwing move constructor");
+  T rebound = construct_with_allocator<T>(alloc);
+  rebound = std::move(value);
+  value.~T();
+  ::new (static_cast<void*>(std::addressof(value))) T(std::move(rebound));
+}
+
+template <typename T, typename Alloc>
+std::enable_if_t<!std::uses_allocator<T, Alloc>::value> move_to_allocator(
+    T&,
+    Alloc const&) {}
+
 } // namespace st
 } // namespace detail
 
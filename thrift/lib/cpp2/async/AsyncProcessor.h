@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <chrono>
+
 #include <folly/ExceptionWrapper.h>
+#include <folly/Optional.h>
 #include <folly/String.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/EventBase.h>
@@ -72,6 +75,12 @@ class EventTask : public virtual apache::thrift::concurrency::Runnable {
         base_->runInEventBaseThread([req = std::move(req_)]() mutable {});
         return;
       }
+      // ThreadManager drops tasks past their expiration when dequeuing them,
+      // this covers executors that ignore it.
+      if (deadline_ && *deadline_ <= std::chrono::steady_clock::now()) {
+        expired();
+        return;
+      }
     }
     taskFunc_(std::move(req_));
   }
@@ -79,12 +88,24 @@ class EventTask : public virtual apache::thrift::concurrency::Runnable {
   void expired() {
     if (!oneway_) {
       if (req_) {
-        base_->runInEventBaseThread([req = std::move(req_)]() {
-          req->sendErrorWrapped(
-              folly::make_exception_wrapper<TApplicationException>(
-                  "Failed to add task to queue, too full"),
-              kQueueOverloadedErrorCode);
-        });
+        bool deadlineExceeded =
+            deadline_ && *deadline_ <= std::chrono::steady_clock::now();
+        base_->runInEventBaseThread(
+            [req = std::move(req_), deadlineExceeded]() {
+              if (deadlineExceeded) {
+                req->sendErrorWrapped(
+                    folly::make_exception_wrapper<TApplicationException>(
+                        TApplicationException::TApplicationExceptionType::
+                            TIMEOUT,
+                        "Deadline exceeded before processing"),
+                    kTaskExpiredErrorCode);
+                return;
+              }
+              req->sendErrorWrapped(
+                  folly::make_exception_wrapper<TApplicationException>(
+                      "Failed to add task to queue, too full"),
+                  kQueueOverloadedErrorCode);
+            });
       }
     } else {
       if (req_) {
@@ -94,12 +115,20 @@ class EventTask : public virtual apache::thrift::concurrency::Runnable {
     }
   }
 
+  // Point in time after which the caller no longer waits for the response.
+  // Requests still queued then fail with a timeout rather than an overload
+  // error, and are never processed.
+  void setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadline_ = deadline;
+  }
+
  private:
   folly::Function<void(std::unique_ptr<apache::thrift::ResponseChannelRequest>)>
       taskFunc_;
   std::unique_ptr<apache::thrift::ResponseChannelRequest> req_;
   folly::EventBase* base_;
   bool oneway_;
+  folly::Optional<std::chrono::steady_clock::time_point> deadline_;
 };
 
 class PriorityEventTask : public apache::thrift::concurrency::PriorityRunnable,
@@ -238,35 +267,60 @@ class GeneratedAsyncProcessor : public AsyncProcessor {
       }
       return;
     }
+    // The ThreadManager drops the task if it is still queued at the deadline.
+    // Oneway and streaming requests have no deadline to honor.
+    std::chrono::milliseconds expiration(0);
+    folly::Optional<std::chrono::steady_clock::time_point> deadline;
+    if (kind == apache::thrift::RpcKind::SINGLE_REQUEST_SINGLE_RESPONSE &&
+        !req->isOneway()) {
+      deadline = ctx->getDeadline();
+    }
+    if (deadline) {
+      // Rounded up, so that the task never expires before the deadline.
+      expiration = std::chrono::ceil<std::chrono::milliseconds>(
+          *deadline - std::chrono::steady_clock::now());
+      if (expiration <= std::chrono::milliseconds(0)) {
+        req->sendErrorWrapped(
+            folly::make_exception_wrapper<TApplicationException>(
+                TApplicationException::TApplicationExceptionType::TIMEOUT,
+                "Deadline exceeded before processing"),
+            kTaskExpiredErrorCode);
+        return;
+      }
+    }
+    auto task = std::make_shared<apache::thrift::PriorityEventTask>(
+        pri,
+        [=, iprot = std::move(iprot), buf = std::move(buf)](
+            std::unique_ptr<apache::thrift::ResponseChannelRequest>
+                rq) mutable {
+          if (rq->getTimestamps().getSamplingStatus().isEnabled()) {
+            // Since this request was queued, reset the processBegin
+            // time to the actual start time, and not the queue time.
+            rq->getTimestamps().processBegin =
+                apache::thrift::concurrency::Util::currentTimeUsec();
+          }
+          // Oneway request won't be canceled if expired. see
+          // D1006482 for furhter details.  TODO: fix this
+          if (kind != apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE) {
+            if (!rq->isActive()) {
+              eb->runInEventBaseThread(
+                  [rq = std::move(rq)]() mutable { rq.reset(); });
+              return;
+            }
+          }
+          (childClass->*processFunc)(
+              std::move(rq), std::move(buf), std::move(iprot), ctx, eb, tm);
+        },
+        std::move(req),
+        eb,
+        kind == apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE);
+    if (deadline) {
+      task->setDeadline(*deadline);
+    }
     tm->add(
-        std::make_shared<apache::thrift::PriorityEventTask>(
-            pri,
-            [=, iprot = std::move(iprot), buf = std::move(buf)](
-                std::unique_ptr<apache::thrift::ResponseChannelRequest>
-                    rq) mutable {
-              if (rq->getTimestamps().getSamplingStatus().isEnabled()) {
-                // Since this request was queued, reset the processBegin
-                // time to the actual start time, and not the queue time.
-                rq->getTimestamps().processBegin =
-                    apache::thrift::concurrency::Util::currentTimeUsec();
-              }
-              // Oneway request won't be canceled if expired. see
-              // D1006482 for furhter details.  TODO: fix this
-              if (kind != apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE) {
-                if (!rq->isActive()) {
-                  eb->runInEventBaseThread(
-                      [rq = std::move(rq)]() mutable { rq.reset(); });
-                  return;
-                }
-              }
-              (childClass->*processFunc)(
-                  std::move(rq), std::move(buf), std::move(iprot), ctx, eb, tm);
-            },
-            std::move(req),
-            eb,
-            kind == apache::thrift::RpcKind::SINGLE_REQUEST_NO_RESPONSE),
+        std::move(task),
         0, // timeout
-        0, // expiration
+        expiration.count(),
         true, // cancellable
         true); // numa
   }
@@ -473,7 +527,8 @@ class HandlerCallbackBase {
     queue.append(transport::THeader::transform(
         queue.move(),
         reqCtx_->getHeader()->getWriteTransforms(),
-        reqCtx_->getHeader()->getMinCompressBytes()));
+        reqCtx_->getHeader()->getMinCompressBytes(),
+        reqCtx_->getHeader()->getZstdDictionaryId()));
   }
 
   // Can be called from IO or TM thread
@@ -82,6 +82,15 @@ class HeaderChannelTrait {
     return writeTrans_;
   }
 
+  // Dictionary for ZSTD_TRANSFORM, see THeader::setZstdDictionaryId.
+  void setZstdDictionaryId(folly::Optional<uint32_t> dictionaryId) {
+    zstdDictionaryId_ = dictionaryId;
+  }
+
+  folly::Optional<uint32_t> getZstdDictionaryId() const {
+    return zstdDictionaryId_;
+  }
+
  private:
   uint32_t minCompressBytes_{0};
   uint16_t flags_;
@@ -92,6 +101,7 @@ class HeaderChannelTrait {
   std::bitset<CLIENT_TYPES_LEN> supported_clients;
 
   std::vector<uint16_t> writeTrans_;
+  folly::Optional<uint32_t> zstdDictionaryId_;
 };
 } // namespace thrift
 } // namespace apache
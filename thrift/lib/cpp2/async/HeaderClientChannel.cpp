@@ -16,11 +16,14 @@
 
 #include <thrift/lib/cpp2/async/HeaderClientChannel.h>
 
+#include <string>
 #include <utility>
 
+#include <folly/Conv.h>
 #include <folly/io/Cursor.h>
 #include <thrift/lib/cpp/EventHandlerBase.h>
 #include <thrift/lib/cpp/transport/TTransportException.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 
 using folly::IOBuf;
@@ -135,6 +138,7 @@ void HeaderClientChannel::setRequestHeaderOptions(THeader* header) {
   header->setClientType(getClientType());
   header->forceClientType(getForceClientType());
   header->setTransforms(getWriteTransforms());
+  header->setZstdDictionaryId(getZstdDictionaryId());
   if (getClientType() == THRIFT_HTTP_CLIENT_TYPE) {
     header->setHttpClientParser(httpClientParser_);
   }
@@ -175,6 +179,12 @@ uint32_t HeaderClientChannel::sendRequest(
   if (rpcOptions.getTimeout() > std::chrono::milliseconds(0)) {
     timeout = rpcOptions.getTimeout();
   }
+  // Calls made while serving a request inherit what is left of its deadline.
+  bool hasDeadline =
+      rpcOptions.getInheritDeadline() && RequestDeadline::get().hasValue();
+  if (hasDeadline) {
+    timeout = RequestDeadline::clampTimeout(timeout);
+  }
 
   auto twcb = new TwowayCallback<HeaderClientChannel>(
       this,
@@ -188,6 +198,12 @@ uint32_t HeaderClientChannel::sendRequest(
 
   setRequestHeaderOptions(header.get());
   addRpcOptionHeaders(header.get(), rpcOptions);
+  if (hasDeadline && clientSupportHeader()) {
+    // The server drops the request once the caller stopped waiting.
+    header->setHeader(
+        THeader::CLIENT_TIMEOUT_HEADER,
+        folly::to<std::string>(timeout.count()));
+  }
 
   if (getClientType() != THRIFT_HEADER_CLIENT_TYPE) {
     recvCallbackOrder_.push_back(sendSeqId_);
@@ -26,6 +26,7 @@
 #include <folly/io/async/EventBase.h>
 #include <folly/io/async/Request.h>
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp/util/THttpParser.h>
 #include <thrift/lib/cpp2/async/ChannelCallbacks.h>
 #include <thrift/lib/cpp2/async/ClientChannel.h>
@@ -165,6 +166,16 @@ class HeaderClientChannel : public ClientChannel,
     return HeaderChannelTrait::getClientType();
   }
 
+  /**
+   * Loads a dictionary trained by ZstdDictionaryTrainer and compresses
+   * requests with ZSTD_TRANSFORM against it. The server must have loaded the
+   * same dictionary (ThriftServer::loadZstdDictionary).
+   */
+  void useZstdDictionary(folly::ByteRange dictionary) {
+    setZstdDictionaryId(transport::registerZstdDictionary(dictionary));
+    setTransform(transport::THeader::ZSTD_TRANSFORM);
+  }
+
   class ClientFramingHandler : public FramingHandler {
    public:
     explicit ClientFramingHandler(HeaderClientChannel& channel)
@@ -275,7 +275,8 @@ void HeaderServerChannel::HeaderRequest::serializeAndSendError(
   exbuf = THeader::transform(
       std::move(exbuf),
       header.getWriteTransforms(),
-      header.getMinCompressBytes());
+      header.getMinCompressBytes(),
+      header.getZstdDictionaryId());
   sendReply(std::move(exbuf), cb);
 }
 
@@ -305,7 +306,10 @@ void HeaderServerChannel::HeaderRequest::sendErrorWrapped(
       return;
     }
     exbuf = THeader::transform(
-        std::move(exbuf), transforms, header_->getMinCompressBytes());
+        std::move(exbuf),
+        transforms,
+        header_->getMinCompressBytes(),
+        header_->getZstdDictionaryId());
     sendReply(std::move(exbuf), cb);
   });
 }
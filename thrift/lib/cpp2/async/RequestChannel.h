@@ -318,6 +318,21 @@ class RpcOptions {
     return queueTimeout_;
   }
 
+  /**
+   * A request-response call made while serving a request inherits what is
+   * left of that request's deadline (see RequestDeadline). Disable this for
+   * work meant to outlive the request, e.g. background fan-out, so that it
+   * keeps its own timeout.
+   */
+  RpcOptions& setInheritDeadline(bool inheritDeadline) {
+    inheritDeadline_ = inheritDeadline;
+    return *this;
+  }
+
+  bool getInheritDeadline() const {
+    return inheritDeadline_;
+  }
+
   void setWriteHeader(const std::string& key, const std::string& value) {
     writeHeaders_[key] = value;
   }
@@ -345,6 +360,7 @@ class RpcOptions {
   PRIORITY priority_;
   std::chrono::milliseconds chunkTimeout_;
   std::chrono::milliseconds queueTimeout_;
+  bool inheritDeadline_{true};
 
   // For sending and receiving headers.
   std::map<std::string, std::string> writeHeaders_;
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
+
+#include <algorithm>
+
+namespace apache {
+namespace thrift {
+
+const std::string& RequestDeadline::contextDataKey() {
+  static const auto* key = new std::string("apache::thrift::RequestDeadline");
+  return *key;
+}
+
+void RequestDeadline::set(Clock::time_point deadline) {
+  auto* context = folly::RequestContext::get();
+  if (auto* data = static_cast<RequestDeadline*>(
+          context->getContextData(contextDataKey()))) {
+    if (data->deadline_ <= deadline) {
+      return;
+    }
+  }
+  context->overwriteContextData(
+      contextDataKey(), std::make_unique<RequestDeadline>(deadline));
+}
+
+folly::Optional<RequestDeadline::Clock::time_point> RequestDeadline::get() {
+  auto* data = static_cast<RequestDeadline*>(
+      folly::RequestContext::get()->getContextData(contextDataKey()));
+  if (!data) {
+    return folly::none;
+  }
+  return data->deadline_;
+}
+
+folly::Optional<std::chrono::milliseconds> RequestDeadline::remaining() {
+  auto deadline = get();
+  if (!deadline) {
+    return folly::none;
+  }
+  return std::max(
+      std::chrono::milliseconds::zero(),
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          *deadline - Clock::now()));
+}
+
+std::chrono::milliseconds RequestDeadline::clampTimeout(
+    std::chrono::milliseconds timeout) {
+  auto left = remaining();
+  if (!left) {
+    return timeout;
+  }
+  // Zero means no timeout, so the shortest one is a millisecond.
+  auto clamped = std::max(*left, std::chrono::milliseconds(1));
+  if (timeout > std::chrono::milliseconds::zero()) {
+    clamped = std::min(clamped, timeout);
+  }
+  return clamped;
+}
+
+std::shared_ptr<folly::RequestContext> RequestDeadline::makeContext(
+    const folly::Optional<Clock::time_point>& deadline) {
+  if (!deadline) {
+    return folly::RequestContext::saveContext();
+  }
+  auto context = std::make_shared<folly::RequestContext>();
+  context->setContextData(
+      contextDataKey(), std::make_unique<RequestDeadline>(*deadline));
+  return context;
+}
+
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <folly/Optional.h>
+#include <folly/io/async/Request.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * End-to-end deadline of the request being served, attached to its
+ * folly::RequestContext.
+ *
+ * The server sets it from the client timeout and deadline budget of each
+ * request, and client channels clamp the timeout of every call made under
+ * that context to the time left. A handler calling other services therefore
+ * propagates its caller's deadline without any extra code, and never waits
+ * for a response its own caller no longer expects.
+ */
+class RequestDeadline : public folly::RequestData {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit RequestDeadline(Clock::time_point deadline) : deadline_(deadline) {}
+
+  bool hasCallback() override {
+    return false;
+  }
+
+  Clock::time_point getDeadline() const {
+    return deadline_;
+  }
+
+  /**
+   * Attach `deadline` to the current folly::RequestContext, unless it already
+   * carries an earlier one. The caller must have set up a context for the
+   * request, otherwise this would leak into the default context.
+   */
+  static void set(Clock::time_point deadline);
+
+  /**
+   * Deadline of the current folly::RequestContext, if any.
+   */
+  static folly::Optional<Clock::time_point> get();
+
+  /**
+   * Time left until the deadline of the current folly::RequestContext, or
+   * none if it has no deadline. Zero once the deadline has passed.
+   */
+  static folly::Optional<std::chrono::milliseconds> remaining();
+
+  /**
+   * Clamp the timeout of an outgoing call (zero meaning no timeout) to the
+   * time left until the deadline of the current folly::RequestContext. Calls
+   * made past the deadline get the shortest possible timeout, so they fail
+   * instead of waiting.
+   */
+  static std::chrono::milliseconds clampTimeout(
+      std::chrono::milliseconds timeout);
+
+  /**
+   * A new folly::RequestContext carrying `deadline`, for server transports
+   * that don't create one per request. Without a deadline, this is the
+   * current context.
+   */
+  static std::shared_ptr<folly::RequestContext> makeContext(
+      const folly::Optional<Clock::time_point>& deadline);
+
+ private:
+  static const std::string& contextDataKey();
+
+  const Clock::time_point deadline_;
+};
+
+} // namespace thrift
+} // namespace apache
@@ -109,12 +109,15 @@ class ResponseChannelRequest {
 
   virtual ~ResponseChannelRequest() {
     if (admissionController_ != nullptr) {
+      auto now = std::chrono::steady_clock::now();
       if (!startedProcessing_) {
         admissionController_->dequeue();
       } else {
-        auto latency = std::chrono::steady_clock::now() - creationTimestamps_;
+        auto latency = now - creationTimestamps_;
         admissionController_->returnedResponse(latency);
       }
+      admissionController_->requestFinished(
+          now - admissionTimestamp_, startedProcessing_);
     }
   }
 
@@ -129,6 +132,7 @@ class ResponseChannelRequest {
   void setAdmissionController(
       std::shared_ptr<AdmissionController> admissionController) {
     admissionController_ = std::move(admissionController);
+    admissionTimestamp_ = std::chrono::steady_clock::now();
   }
 
   std::shared_ptr<AdmissionController> getAdmissionController() const {
@@ -148,6 +152,7 @@ class ResponseChannelRequest {
   std::shared_ptr<apache::thrift::AdmissionController> admissionController_;
   bool startedProcessing_{false};
   std::chrono::steady_clock::time_point creationTimestamps_;
+  std::chrono::steady_clock::time_point admissionTimestamp_;
 };
 
 /**
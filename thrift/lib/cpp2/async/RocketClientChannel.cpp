@@ -37,6 +37,7 @@
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/transport/core/EnvelopeUtil.h>
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
 #include <thrift/lib/cpp2/transport/core/RpcMetadataUtil.h>
 #include <thrift/lib/cpp2/transport/core/ThriftClientCallback.h>
 #include <thrift/lib/cpp2/transport/rocket/RocketException.h>
@@ -237,6 +238,7 @@ void RocketClientChannel::sendThriftRequest(
   }
   metadata.seqId_ref() = 0;
   DCHECK(metadata.kind_ref().has_value());
+  compressRequest(metadata, buf);
 
   if (!rclient_ || !rclient_->isAlive()) {
     cb->requestError(ClientReceiveState(
@@ -289,6 +291,36 @@ void RocketClientChannel::sendThriftRequest(
   }
 }
 
+void RocketClientChannel::compressRequest(
+    RequestRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf>& buf) {
+  // Servers which predate payload compression can't read compressed
+  // requests, so only compress when asked to explicitly.
+  if (compression_ == CompressionAlgorithm::NONE) {
+    return;
+  }
+
+  metadata.acceptResponseCompression_ref() = compression_;
+  if (compressionDictionaryId_) {
+    metadata.compressionDictionaryId_ref() = *compressionDictionaryId_;
+  }
+  auto size = buf->computeChainDataLength();
+  if (size < minCompressBytes_) {
+    return;
+  }
+  try {
+    auto compressed =
+        detail::compressPayload(*buf, compression_, compressionDictionaryId_);
+    if (compressed->computeChainDataLength() < size) {
+      buf = std::move(compressed);
+      metadata.compression_ref() = compression_;
+    }
+  } catch (const std::exception& ex) {
+    FB_LOG_EVERY_MS(ERROR, 10000)
+        << "Failed to compress request: " << folly::exceptionStr(ex);
+  }
+}
+
 void RocketClientChannel::sendSingleRequestNoResponse(
     const RequestRpcMetadata& metadata,
     std::unique_ptr<ContextStack> ctx,
@@ -368,8 +400,8 @@ void RocketClientChannel::sendSingleRequestSingleResponse(
     auto tHeader = std::make_unique<transport::THeader>();
     tHeader->setClientType(THRIFT_HTTP_CLIENT_TYPE);
 
+    ResponseRpcMetadata responseMetadata;
     if (response.value().hasNonemptyMetadata()) {
-      ResponseRpcMetadata responseMetadata;
       try {
         deserializeMetadata(responseMetadata, *response.value().metadata());
         detail::fillTHeaderFromResponseRpcMetadata(responseMetadata, *tHeader);
@@ -383,11 +415,21 @@ void RocketClientChannel::sendSingleRequestSingleResponse(
       }
     }
 
+    std::unique_ptr<folly::IOBuf> data;
+    try {
+      data = detail::uncompressResponsePayload(
+          responseMetadata, std::move(response.value()).data());
+    } catch (const std::exception& e) {
+      FB_LOG_EVERY_MS(ERROR, 10000) << "Exception on uncompressing response: "
+                                    << folly::exceptionStr(e);
+      cb->requestError(ClientReceiveState(
+          folly::exception_wrapper(std::current_exception(), e),
+          std::move(ctx)));
+      return;
+    }
+
     cb->replyReceived(ClientReceiveState(
-        protocolId,
-        std::move(response.value()).data(),
-        std::move(tHeader),
-        std::move(ctx)));
+        protocolId, std::move(data), std::move(tHeader), std::move(ctx)));
   };
 
   if (callingContext == SendRequestCalledFrom::Fiber) {
@@ -609,11 +651,22 @@ void RocketClientChannel::TakeFirst::onNormalFirstResponse(
     return;
   }
 
+  // Only the first response is ever compressed; stream chunks are not.
+  std::unique_ptr<folly::IOBuf> data;
+  try {
+    data = detail::uncompressResponsePayload(
+        metadata, std::move(firstPayload).data());
+  } catch (const std::exception& ex) {
+    FB_LOG_EVERY_MS(ERROR, 10000)
+        << "Exception on uncompressing response: " << folly::exceptionStr(ex);
+    onErrorFirstResponse(
+        folly::exception_wrapper(std::current_exception(), ex));
+    return;
+  }
+
   auto cb = std::move(clientCallback_);
   cb->onThriftResponse(
-      std::move(metadata),
-      std::move(firstPayload).data(),
-      toStream(std::move(tail), &evb_));
+      std::move(metadata), std::move(data), toStream(std::move(tail), &evb_));
 }
 
 void RocketClientChannel::TakeFirst::onErrorFirstResponse(
@@ -20,6 +20,7 @@
 #include <limits>
 #include <memory>
 
+#include <folly/Optional.h>
 #include <folly/fibers/FiberManagerMap.h>
 #include <folly/io/async/DelayedDestruction.h>
 
@@ -125,6 +126,24 @@ class RocketClientChannel final : public ClientChannel {
   void setMaxPendingRequests(uint32_t n) {
     inflightState_->setMaxInflightRequests(n);
   }
+
+  /**
+   * Compresses request payloads of at least 'minCompressBytes' with
+   * 'algorithm' and asks the server to compress responses the same way. With
+   * ZSTD, 'dictionaryId' selects a dictionary that both sides registered via
+   * transport::registerZstdDictionary.
+   *
+   * Only enable this against servers which support payload compression;
+   * THeader write transforms are ignored by this channel.
+   */
+  void setPayloadCompression(
+      CompressionAlgorithm algorithm,
+      uint32_t minCompressBytes = 0,
+      folly::Optional<uint32_t> dictionaryId = folly::none) {
+    compression_ = algorithm;
+    minCompressBytes_ = minCompressBytes;
+    compressionDictionaryId_ = dictionaryId;
+  }
   SaturationStatus getSaturationStatus() override;
 
   void closeNow() override;
@@ -139,6 +158,9 @@ class RocketClientChannel final : public ClientChannel {
   std::shared_ptr<rocket::RocketClient> rclient_;
   uint16_t protocolId_{apache::thrift::protocol::T_BINARY_PROTOCOL};
   std::chrono::milliseconds timeout_{kDefaultRpcTimeout};
+  CompressionAlgorithm compression_{CompressionAlgorithm::NONE};
+  uint32_t minCompressBytes_{0};
+  folly::Optional<uint32_t> compressionDictionaryId_;
 
   class InflightState {
    public:
@@ -204,6 +226,10 @@ class RocketClientChannel final : public ClientChannel {
       std::shared_ptr<apache::thrift::transport::THeader> header,
       SendRequestCalledFrom callingContext);
 
+  void compressRequest(
+      RequestRpcMetadata& metadata,
+      std::unique_ptr<folly::IOBuf>& buf);
+
   void sendSingleRequestNoResponse(
       const RequestRpcMetadata& metadata,
       std::unique_ptr<ContextStack> ctx,
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <iosfwd>
 #include <iterator>
 #include <map>
@@ -33,6 +35,7 @@
 #include <folly/MapUtil.h>
 #include <folly/Memory.h>
 #include <folly/Optional.h>
+#include <folly/Portability.h>
 #include <folly/Range.h>
 #include <folly/container/F14Map-fwd.h>
 #include <folly/container/F14Set-fwd.h>
@@ -44,6 +47,10 @@
 #include <thrift/lib/cpp2/frozen/schema/MemorySchema.h>
 #include <thrift/lib/thrift/gen-cpp2/frozen_types.h>
 
+#if FOLLY_SSE >= 2
+#include <emmintrin.h>
+#endif
+
 namespace apache {
 namespace thrift {
 namespace frozen {
@@ -502,7 +509,10 @@ Layout<T> maximumLayout() {
  * recursively. The logic of layout should closely match that of freezing.
  */
 class LayoutRoot {
+ protected:
   LayoutRoot() {}
+
+ private:
   /**
    * Lays out a given object from the root, repeatedly running layout until a
    * fixed point is reached.
@@ -512,6 +522,7 @@ class LayoutRoot {
     for (resizes = 0; resizes < 1000; ++resizes) {
       resized_ = false;
       cursor_ = _layout.size;
+      internedBytes_.clear();
       auto after = _layout.layout(*this, root, {0, 0});
       resized_ = _layout.resize(after, false) || resized_;
       if (!resized_) {
@@ -631,9 +642,36 @@ class LayoutRoot {
     return worstCaseDistance;
   }
 
+  /**
+   * Like layoutBytesDistance, but if equal bytes were already laid out through
+   * this method, returns the (possibly negative) distance to that copy instead
+   * of appending them again. 'bytes' must outlive the layout.
+   */
+  int64_t layoutInternedBytesDistance(
+      size_t origin,
+      folly::StringPiece bytes,
+      size_t align) {
+    if (bytes.empty()) {
+      return 0;
+    }
+    auto it = internedBytes_.find(bytes);
+    if (it != internedBytes_.end()) {
+      return static_cast<int64_t>(it->second) - static_cast<int64_t>(origin);
+    }
+    auto distance = layoutBytesDistance(origin, bytes.size(), align);
+    internedBytes_.emplace(bytes, origin + distance);
+    return distance;
+  }
+
  protected:
   bool resized_;
   size_t cursor_;
+  // Offsets of the first copy of every interned byte string.
+  std::unordered_map<
+      folly::StringPiece,
+      size_t,
+      folly::hasher<folly::StringPiece>>
+      internedBytes_;
 };
 
 /**
@@ -719,7 +757,58 @@ class FreezeRoot {
     doAppendBytes(origin, n, range, distance, align);
   }
 
+  /**
+   * Appends a copy of 'bytes', unless equal bytes were already appended
+   * through this method, in which case 'distance' (possibly negative) points
+   * at the earlier copy. Mirrors LayoutRoot::layoutInternedBytesDistance.
+   */
+  void appendInternedBytes(
+      byte* origin,
+      folly::StringPiece bytes,
+      int64_t& distance,
+      size_t align) {
+    if (bytes.empty()) {
+      distance = 0;
+      return;
+    }
+    auto it = internedBytes_.find(bytes);
+    if (it != internedBytes_.end()) {
+      distance = distanceBetween(origin, it->second);
+      return;
+    }
+    folly::MutableByteRange range;
+    size_t dist;
+    appendBytes(origin, bytes.size(), range, dist, align);
+    std::copy(bytes.begin(), bytes.end(), range.begin());
+    internedBytes_.emplace(bytes, range.begin());
+    distance = dist;
+  }
+
+ protected:
+  /**
+   * Distance in the frozen output from 'origin' to 'target', both of which
+   * were handed out by this root.
+   */
+  virtual int64_t distanceBetween(const byte* origin, const byte* target)
+      const {
+    return target - origin;
+  }
+
+  /**
+   * Stops later appendInternedBytes() calls from referring to bytes appended
+   * so far, for roots that don't keep everything they append addressable.
+   */
+  void clearInternedBytes() {
+    internedBytes_.clear();
+  }
+
  private:
+  std::unordered_map<
+      folly::StringPiece,
+      const byte*,
+      folly::hasher<folly::StringPiece>>
+      internedBytes_;
+
   virtual void doAppendBytes(
       byte* origin,
       size_t n,
@@ -736,10 +825,13 @@ inline size_t alignBy(size_t start, size_t alignment) {
  * A FreezeRoot that writes to a given ByteRange
  */
 class ByteRangeFreezer final : public FreezeRoot {
- protected:
+ public:
+  /**
+   * Appends to 'write', advancing it. Objects are frozen into it with
+   * freezeField(); most callers want freeze() instead.
+   */
   explicit ByteRangeFreezer(folly::MutableByteRange& write) : write_(write) {}
 
- public:
   template <class T>
   static typename Layout<T>::View freeze(
       const Layout<T>& layout,
@@ -884,9 +976,11 @@ using View = typename Layout<T>::View;
 #include <thrift/lib/cpp2/frozen/FrozenOptional-inl.h> // @nolint
 #include <thrift/lib/cpp2/frozen/FrozenPair-inl.h> // @nolint
 #include <thrift/lib/cpp2/frozen/FrozenRange-inl.h> // @nolint
+#include <thrift/lib/cpp2/frozen/FrozenPackedRange-inl.h> // @nolint
 #include <thrift/lib/cpp2/frozen/FrozenString-inl.h> // @nolint
 // depends on Range
 #include <thrift/lib/cpp2/frozen/FrozenHashTable-inl.h> // @nolint
+#include <thrift/lib/cpp2/frozen/FrozenSwissTable-inl.h> // @nolint
 #include <thrift/lib/cpp2/frozen/FrozenOrderedTable-inl.h> // @nolint
 // depends on Associative
 #include <thrift/lib/cpp2/frozen/FrozenAssociative-inl.h> // @nolint
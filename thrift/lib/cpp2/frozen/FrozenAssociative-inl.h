@@ -151,6 +151,21 @@ struct Layout<T, typename std::enable_if<IsOrderedSet<T>::value>::type>
     : public detail::
           SetTableLayout<T, typename T::value_type, detail::SortedTableLayout> {
 };
+template <class T>
+struct Layout<T, typename std::enable_if<IsEytzingerMap<T>::value>::type>
+    : public detail::MapTableLayout<
+          T,
+          typename T::key_type,
+          typename T::mapped_type,
+          detail::EytzingerTableLayout> {};
+
+template <class T>
+struct Layout<T, typename std::enable_if<IsEytzingerSet<T>::value>::type>
+    : public detail::SetTableLayout<
+          T,
+          typename T::value_type,
+          detail::EytzingerTableLayout> {};
+
 template <class T>
 struct Layout<T, typename std::enable_if<IsHashMap<T>::value>::type>
     : public detail::MapTableLayout<
@@ -163,6 +178,20 @@ template <class T>
 struct Layout<T, typename std::enable_if<IsHashSet<T>::value>::type>
     : public detail::
           SetTableLayout<T, typename T::value_type, detail::HashTableLayout> {};
+
+template <class T>
+struct Layout<T, typename std::enable_if<IsSwissHashMap<T>::value>::type>
+    : public detail::MapTableLayout<
+          T,
+          typename T::key_type,
+          typename T::mapped_type,
+          detail::SwissTableLayout> {};
+
+template <class T>
+struct Layout<T, typename std::enable_if<IsSwissHashSet<T>::value>::type>
+    : public detail::
+          SetTableLayout<T, typename T::value_type, detail::SwissTableLayout> {
+};
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
@@ -190,6 +190,250 @@ struct SortedTableLayout : public ArrayLayout<T, Item> {
   }
 };
 
+/**
+ * Layout specialization for unique ordered range types, like
+ * SortedTableLayout, with a key-only search index on the side.
+ *
+ * Items are stored in sorted order, so iteration is unchanged. The index
+ * holds the key of every kBlockSize-th item, in Eytzinger (BFS) order padded
+ * out to a complete tree with copies of the last key. A lookup descends the
+ * tree while prefetching the nodes four levels below, then binary searches
+ * the single block of items the tree points to. Compared to a plain binary
+ * search this replaces most of the scattered probes into the item array with
+ * probes into a small index whose top levels stay cached.
+ */
+template <class T, class Item, class KeyExtractor, class Key = T>
+struct EytzingerTableLayout : public ArrayLayout<T, Item> {
+  typedef ArrayLayout<T, Item> Base;
+  typedef EytzingerTableLayout LayoutSelf;
+  typedef SortedTableLayout<T, Item, KeyExtractor, Key> Sorted;
+  Field<std::vector<Key>> indexField;
+
+  static constexpr size_t kBlockSize = 16;
+
+  EytzingerTableLayout()
+      : indexField(4, "index") // continue field ids from ArrayLayout
+  {}
+
+  FieldPosition maximize() {
+    FieldPosition pos = ArrayLayout<T, Item>::maximize();
+    FROZEN_MAXIMIZE_FIELD(index);
+    return pos;
+  }
+
+  static size_t blockCount(size_t size) {
+    return (size + kBlockSize - 1) / kBlockSize;
+  }
+
+  // Sorts the items and checks that their keys are distinct.
+  static void sortItems(const T& coll, std::vector<const Item*>& sorted) {
+    Sorted::maybeIndex(coll, sorted);
+    if (sorted.empty()) {
+      sorted.reserve(coll.size());
+      for (auto& item : coll) {
+        sorted.push_back(KeyExtractor::getPointer(item));
+      }
+    }
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      Sorted::ensureDistinctKeys(
+          KeyExtractor::getKey(*sorted[i - 1]),
+          KeyExtractor::getKey(*sorted[i]));
+    }
+  }
+
+  static void buildIndex(
+      const std::vector<const Item*>& sorted,
+      std::vector<Key>& index) {
+    auto blocks = blockCount(sorted.size());
+    index.clear();
+    if (blocks == 0) {
+      return;
+    }
+    index.resize(folly::nextPowTwo(blocks + 1) - 1);
+    // In-order walk of the implicit tree hands out the sampled keys in
+    // ascending order.
+    size_t next = 0;
+    auto fill = [&](size_t node, auto& self) -> void {
+      if (node > index.size()) {
+        return;
+      }
+      self(2 * node, self);
+      auto block = std::min(next++, blocks - 1);
+      index[node - 1] = KeyExtractor::getKey(*sorted[block * kBlockSize]);
+      self(2 * node + 1, self);
+    };
+    fill(1, fill);
+  }
+
+  FieldPosition layoutItems(
+      LayoutRoot& root,
+      const T& coll,
+      LayoutPosition self,
+      FieldPosition pos,
+      LayoutPosition write,
+      FieldPosition writeStep) final {
+    std::vector<const Item*> sorted;
+    sortItems(coll, sorted);
+    std::vector<Key> index;
+    buildIndex(sorted, index);
+
+    pos = root.layoutField(self, pos, this->indexField, index);
+
+    FieldPosition noField; // not really used
+    for (auto ptr : sorted) {
+      root.layoutField(write, noField, this->itemField, *ptr);
+      write = write(writeStep);
+    }
+
+    return pos;
+  }
+
+  void freezeItems(
+      FreezeRoot& root,
+      const T& coll,
+      FreezePosition self,
+      FreezePosition write,
+      FieldPosition writeStep) const final {
+    std::vector<const Item*> sorted;
+    sortItems(coll, sorted);
+    std::vector<Key> index;
+    buildIndex(sorted, index);
+
+    root.freezeField(self, this->indexField, index);
+
+    FieldPosition noField; // not really used
+    for (auto ptr : sorted) {
+      root.freezeField(write, this->itemField, *ptr);
+      write = write(writeStep);
+    }
+  }
+
+  void thaw(ViewPosition self, T& out) const {
+    out.clear();
+    auto v = view(self);
+    for (auto it = v.begin(); it != v.end(); ++it) {
+      out.insert(it.thaw());
+    }
+  }
+
+  void print(std::ostream& os, int level) const override {
+    Base::print(os, level);
+    indexField.print(os, level + 1);
+  }
+
+  void clear() final {
+    Base::clear();
+    indexField.clear();
+  }
+
+  FROZEN_SAVE_INLINE(FROZEN_SAVE_FIELD(index))
+
+  FROZEN_LOAD_INLINE(FROZEN_LOAD_FIELD(index, 4))
+
+  class View : public Base::View {
+    typedef typename Layout<Key>::View KeyView;
+    typedef typename Layout<Item>::View ItemView;
+    typedef typename Layout<std::vector<Key>>::View IndexView;
+
+   public:
+    View() {}
+    View(const LayoutSelf* layout, ViewPosition self)
+        : Base::View(layout, self),
+          index_(layout->indexField.layout.view(
+              self(layout->indexField.pos))) {}
+
+    typedef typename Base::View::iterator iterator;
+
+    void operator[](size_t) = delete;
+
+    iterator lower_bound(const KeyView& key) const {
+      auto range = block(searchIndex([&](KeyView k) { return k < key; }));
+      return std::lower_bound(
+          range.first, range.second, key, [](ItemView a, KeyView b) {
+            return KeyExtractor::getViewKey(a) < b;
+          });
+    }
+
+    iterator upper_bound(const KeyView& key) const {
+      auto range = block(searchIndex([&](KeyView k) { return !(key < k); }));
+      return std::upper_bound(
+          range.first, range.second, key, [](KeyView a, ItemView b) {
+            return a < KeyExtractor::getViewKey(b);
+          });
+    }
+
+    std::pair<iterator, iterator> equal_range(const KeyView& key) const {
+      auto found = lower_bound(key);
+      if (found != this->end() && KeyExtractor::getViewKey(*found) == key) {
+        auto next = found;
+        return std::make_pair(found, ++next);
+      } else {
+        return std::make_pair(found, found);
+      }
+    }
+
+    iterator find(const KeyView& key) const {
+      auto found = lower_bound(key);
+      if (found != this->end() && KeyExtractor::getViewKey(*found) == key) {
+        return found;
+      } else {
+        return this->end();
+      }
+    }
+
+    size_t count(const KeyView& key) const {
+      return find(key) == this->end() ? 0 : 1;
+    }
+
+    T thaw() const {
+      T ret;
+      static_cast<const EytzingerTableLayout*>(this->layout_)
+          ->thaw(this->position_, ret);
+      return ret;
+    }
+
+   private:
+    /**
+     * Returns the first block whose leading key 'k' doesn't satisfy
+     * 'less(k)', or the number of blocks if there is none. Only the items
+     * just before that block's leading key can still be in range.
+     */
+    template <class Less>
+    size_t searchIndex(Less less) const {
+      size_t n = index_.size();
+      size_t node = 1;
+      while (node <= n) {
+        index_.prefetch(16 * node - 1);
+        node = 2 * node + (less(index_[node - 1]) ? 1 : 0);
+      }
+      // Strip the trailing right turns and the final left turn.
+      node >>= folly::findFirstSet(~node);
+      if (node == 0) {
+        return blockCount(this->size());
+      }
+      // In-order rank of 'node' in a complete tree of height 'height'.
+      size_t height = folly::findLastSet(n);
+      size_t depth = folly::findLastSet(node) - 1;
+      size_t rank =
+          ((2 * (node - (size_t(1) << depth)) + 1) << (height - 1 - depth)) - 1;
+      return rank;
+    }
+
+    // Range of items the index narrowed the search down to.
+    std::pair<iterator, iterator> block(size_t b) const {
+      size_t lo = b == 0 ? 0 : (b - 1) * kBlockSize + 1;
+      size_t hi = std::min(b * kBlockSize, this->size());
+      return std::make_pair(this->begin() + lo, this->begin() + hi);
+    }
+
+    IndexView index_;
+  };
+
+  View view(ViewPosition self) const {
+    return View(this, self);
+  }
+};
+
 } // namespace detail
 } // namespace frozen
 } // namespace thrift
@@ -0,0 +1,363 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+namespace detail {
+
+/**
+ * Layout specialization for integer lists stored in blocks of kBlockSize
+ * values, where each block holds its values as offsets from the block minimum
+ * ("frame of reference") packed at the fewest bits that fit that block. Sorted
+ * or clustered sequences like timestamps, IDs and posting lists then take a
+ * few bits per value rather than the bits of the widest value in the list.
+ *
+ * The values are stored out of line: a header of two words per block (its
+ * minimum, and the word offset of its values shifted left by 8 plus its bit
+ * width), then the packed values of each block starting on a word boundary,
+ * then a word of padding so a value can always be read with two loads. Random
+ * access reads one header and one value.
+ */
+template <class T>
+struct BlockPackedLayout : public LayoutBase {
+  typedef LayoutBase Base;
+  typedef BlockPackedLayout LayoutSelf;
+  typedef typename T::value_type Item;
+  typedef typename std::make_unsigned<Item>::type Unsigned;
+  static_assert(
+      std::is_integral<Item>::value,
+      "Block packing is only available for integral item types");
+
+  static constexpr size_t kBlockSize = 128;
+
+  Field<size_t> distanceField;
+  Field<size_t> countField;
+
+  BlockPackedLayout()
+      : LayoutBase(typeid(T)),
+        distanceField(1, "distance"),
+        countField(2, "count") {}
+
+  FieldPosition maximize() {
+    FieldPosition pos = startFieldPosition();
+    FROZEN_MAXIMIZE_FIELD(distance);
+    FROZEN_MAXIMIZE_FIELD(count);
+    return pos;
+  }
+
+  static size_t blockCount(size_t n) {
+    return (n + kBlockSize - 1) / kBlockSize;
+  }
+
+  // Minimum and bit width of the offsets from it, for one block.
+  static std::pair<Item, size_t> frame(const Item* begin, const Item* end) {
+    auto minmax = std::minmax_element(begin, end);
+    Unsigned range = Unsigned(*minmax.second) - Unsigned(*minmax.first);
+    return {*minmax.first, range ? folly::findLastSet(range) : 0};
+  }
+
+  static size_t encodedWords(const T& coll) {
+    size_t n = coll.size();
+    size_t blocks = blockCount(n);
+    size_t words = 2 * blocks + 1;
+    for (size_t b = 0; b < blocks; ++b) {
+      const Item* begin = coll.data() + b * kBlockSize;
+      const Item* end = coll.data() + std::min(n, (b + 1) * kBlockSize);
+      words += (frame(begin, end).second * (end - begin) + 63) / 64;
+    }
+    return words;
+  }
+
+  static std::vector<uint64_t> encode(const T& coll) {
+    size_t n = coll.size();
+    size_t blocks = blockCount(n);
+    std::vector<uint64_t> words(2 * blocks);
+    for (size_t b = 0; b < blocks; ++b) {
+      const Item* begin = coll.data() + b * kBlockSize;
+      const Item* end = coll.data() + std::min(n, (b + 1) * kBlockSize);
+      auto f = frame(begin, end);
+      size_t offset = words.size();
+      words[2 * b] = uint64_t(Unsigned(f.first));
+      words[2 * b + 1] = (offset << 8) | f.second;
+      if (f.second) {
+        words.resize(offset + (f.second * (end - begin) + 63) / 64);
+        size_t bit = 0;
+        for (auto it = begin; it != end; ++it, bit += f.second) {
+          folly::Bits<uint64_t>::set(
+              &words[offset],
+              bit,
+              f.second,
+              uint64_t(Unsigned(*it) - Unsigned(f.first)));
+        }
+      }
+    }
+    words.push_back(0); // padding
+    return words;
+  }
+
+  FieldPosition layout(LayoutRoot& root, const T& coll, LayoutPosition self) {
+    FieldPosition pos = startFieldPosition();
+    size_t n = coll.size();
+    pos = root.layoutField(self, pos, countField, n);
+    if (!n) {
+      pos = root.layoutField(self, pos, distanceField, 0);
+      return pos;
+    }
+    size_t dist = root.layoutBytesDistance(
+        self.start, encodedWords(coll) * sizeof(uint64_t), alignof(uint64_t));
+    pos = root.layoutField(self, pos, distanceField, dist);
+    return pos;
+  }
+
+  void freeze(FreezeRoot& root, const T& coll, FreezePosition self) const {
+    size_t n = coll.size();
+    root.freezeField(self, countField, n);
+    if (!n) {
+      root.freezeField(self, distanceField, 0);
+      return;
+    }
+    auto words = encode(coll);
+    folly::MutableByteRange range;
+    size_t dist;
+    root.appendBytes(
+        self.start,
+        words.size() * sizeof(uint64_t),
+        range,
+        dist,
+        alignof(uint64_t));
+    root.freezeField(self, distanceField, dist);
+    std::memcpy(range.begin(), words.data(), range.size());
+  }
+
+  void thaw(ViewPosition self, T& out) const {
+    auto v = view(self);
+    out.resize(v.size());
+    for (size_t b = 0; b < blockCount(v.size()); ++b) {
+      v.decodeBlock(b, out.data() + b * kBlockSize);
+    }
+  }
+
+  void print(std::ostream& os, int level) const override {
+    LayoutBase::print(os, level);
+    os << "block packed range of " << folly::demangle(type.name());
+    distanceField.print(os, level + 1);
+    countField.print(os, level + 1);
+  }
+
+  void clear() final {
+    LayoutBase::clear();
+    distanceField.clear();
+    countField.clear();
+  }
+
+  FROZEN_SAVE_INLINE(FROZEN_SAVE_FIELD(distance) FROZEN_SAVE_FIELD(count))
+
+  FROZEN_LOAD_INLINE(FROZEN_LOAD_FIELD(distance, 1) FROZEN_LOAD_FIELD(count, 2))
+
+  /**
+   * A view of a block packed range. Items are produced by value.
+   */
+  class View : public ViewBase<View, BlockPackedLayout, T> {
+    class Iterator;
+
+   public:
+    typedef Item value_type;
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    View() {}
+    View(const LayoutSelf* layout, ViewPosition self)
+        : ViewBase<View, BlockPackedLayout, T>(layout, self) {
+      thawField(self, layout->countField, count_);
+      if (count_) {
+        size_t dist;
+        thawField(self, layout->distanceField, dist);
+        data_ = self.start + dist;
+      }
+    }
+
+    Item operator[](size_t index) const {
+      size_t b = index / kBlockSize;
+      uint64_t base = word(2 * b);
+      uint64_t header = word(2 * b + 1);
+      size_t bits = header & 0xff;
+      if (!bits) {
+        return Item(Unsigned(base));
+      }
+      auto words = reinterpret_cast<const folly::Unaligned<uint64_t>*>(
+          data_ + (header >> 8) * sizeof(uint64_t));
+      return Item(Unsigned(
+          base +
+          folly::Bits<folly::Unaligned<uint64_t>>::get(
+              words, (index % kBlockSize) * bits, bits)));
+    }
+
+    /**
+     * Decodes block 'b' (items [b * kBlockSize, (b + 1) * kBlockSize)) into
+     * 'out', which must have room for kBlockSize items. Returns the number of
+     * items decoded. This is the fast path for scans: the loop is branch-free
+     * with a fixed bit width, and the base is added to every item at once.
+     */
+    size_t decodeBlock(size_t b, Item* out) const {
+      size_t n = std::min(kBlockSize, count_ - b * kBlockSize);
+      uint64_t base = word(2 * b);
+      uint64_t header = word(2 * b + 1);
+      size_t bits = header & 0xff;
+      size_t offset = header >> 8;
+      uint64_t deltas[kBlockSize];
+      if (bits == 0) {
+        std::fill(deltas, deltas + n, 0);
+      } else {
+        uint64_t mask = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        for (size_t i = 0, bit = 0; i < n; ++i, bit += bits) {
+          size_t w = offset + bit / 64;
+          size_t shift = bit % 64;
+          // Both words are in bounds thanks to the trailing padding word.
+          uint64_t lo = word(w) >> shift;
+          uint64_t hi = (word(w + 1) << 1) << (63 - shift);
+          deltas[i] = (lo | hi) & mask;
+        }
+      }
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = Item(Unsigned(base + deltas[i]));
+      }
+      return n;
+    }
+
+    Item front() const {
+      assert(!empty());
+      return (*this)[0];
+    }
+
+    Item back() const {
+      assert(!empty());
+      return (*this)[size() - 1];
+    }
+
+    const_iterator begin() const {
+      return const_iterator(*this, 0);
+    }
+
+    const_iterator end() const {
+      return const_iterator(*this, count_);
+    }
+
+    bool empty() const {
+      return !count_;
+    }
+
+    size_t size() const {
+      return count_;
+    }
+
+   private:
+    uint64_t word(size_t i) const {
+      return folly::loadUnaligned<uint64_t>(data_ + i * sizeof(uint64_t));
+    }
+
+    /**
+     * Random access iterator producing items by value.
+     */
+    class Iterator {
+     public:
+      using difference_type = ptrdiff_t;
+      using value_type = Item;
+      using pointer = const Item*;
+      using reference = Item;
+      using iterator_category = std::random_access_iterator_tag;
+
+      Iterator() {}
+      Iterator(const View& outer, size_t index)
+          : outer_(outer), index_(index) {}
+
+      Item operator*() const {
+        return outer_[index_];
+      }
+
+      ptrdiff_t operator-(const Iterator& other) const {
+        return index_ - other.index_;
+      }
+
+      Iterator& operator++() {
+        ++index_;
+        return *this;
+      }
+      Iterator& operator--() {
+        --index_;
+        return *this;
+      }
+      Iterator& operator+=(ptrdiff_t delta) {
+        index_ += delta;
+        return *this;
+      }
+      Iterator& operator-=(ptrdiff_t delta) {
+        index_ -= delta;
+        return *this;
+      }
+      Iterator operator++(int) {
+        Iterator ret(*this);
+        ++*this;
+        return ret;
+      }
+      Iterator operator--(int) {
+        Iterator ret(*this);
+        --*this;
+        return ret;
+      }
+      Iterator operator+(ptrdiff_t delta) const {
+        Iterator ret(*this);
+        ret += delta;
+        return ret;
+      }
+      Iterator operator-(ptrdiff_t delta) const {
+        Iterator ret(*this);
+        ret -= delta;
+        return ret;
+      }
+
+      bool operator==(const Iterator& other) const {
+        return index_ == other.index_;
+      }
+      bool operator!=(const Iterator& other) const {
+        return !(*this == other);
+      }
+      bool operator<(const Iterator& other) const {
+        return index_ < other.index_;
+      }
+
+     private:
+      View outer_;
+      size_t index_{0};
+    };
+
+    const byte* data_{nullptr};
+    size_t count_{0};
+  };
+
+  View view(ViewPosition self) const {
+    return View(this, self);
+  }
+};
+
+} // namespace detail
+
+template <class T>
+struct Layout<T, typename std::enable_if<IsBlockPacked<T>::value>::type>
+    : public detail::BlockPackedLayout<T> {};
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
@@ -228,6 +228,21 @@ struct ArrayLayout : public LayoutBase {
       return {data, data + count_};
     }
 
+    /**
+     * Hints that the item at 'index' is about to be read. Out of range
+     * indices are ignored.
+     */
+    void prefetch(size_t index) const {
+#if defined(__GNUC__)
+      if (index < count_) {
+        auto pos = indexPosition(data_, index, itemLayout());
+        __builtin_prefetch(pos.start + pos.bitOffset / 8);
+      }
+#else
+      (void)index;
+#endif
+    }
+
    private:
     /**
      * Simple iterator on a range, with additional '.thaw()' member for thawing
@@ -138,12 +138,100 @@ struct StringLayout : public LayoutBase {
   }
 };
 
+/**
+ * Like StringLayout for chars, but equal values are only stored once per
+ * frozen object. The first occurrence of a value is appended as usual and
+ * later ones point back at it through a signed distance, so a column of
+ * low-cardinality strings costs one bit-packed distance and count per value
+ * plus the distinct strings.
+ */
+template <class T>
+struct InternedStringLayout : public LayoutBase {
+  typedef LayoutBase Base;
+  Field<int64_t> distanceField;
+  Field<size_t> countField;
+
+  InternedStringLayout()
+      : LayoutBase(typeid(T)),
+        distanceField(1, "distance"),
+        countField(2, "count") {}
+
+  FieldPosition maximize() {
+    FieldPosition pos = startFieldPosition();
+    FROZEN_MAXIMIZE_FIELD(distance);
+    FROZEN_MAXIMIZE_FIELD(count);
+    return pos;
+  }
+
+  FieldPosition layout(LayoutRoot& root, const T& o, LayoutPosition self) {
+    FieldPosition pos = startFieldPosition();
+    if (o.empty()) {
+      return pos;
+    }
+    int64_t dist = root.layoutInternedBytesDistance(self.start, o, 1);
+    pos = root.layoutField(self, pos, distanceField, dist);
+    pos = root.layoutField(self, pos, countField, o.size());
+    return pos;
+  }
+
+  void freeze(FreezeRoot& root, const T& o, FreezePosition self) const {
+    int64_t dist;
+    root.appendInternedBytes(self.start, o, dist, 1);
+    root.freezeField(self, distanceField, dist);
+    root.freezeField(self, countField, o.size());
+  }
+
+  void thaw(ViewPosition self, T& out) const {
+    auto v = view(self);
+    out.assign(v.begin(), v.end());
+  }
+
+  typedef folly::StringPiece View;
+
+  View view(ViewPosition self) const {
+    View range;
+    int64_t dist;
+    size_t n;
+    thawField(self, countField, n);
+    if (n) {
+      thawField(self, distanceField, dist);
+      range.reset(reinterpret_cast<const char*>(self.start + dist), n);
+    }
+    return range;
+  }
+
+  void print(std::ostream& os, int level) const override {
+    LayoutBase::print(os, level);
+    os << "interned string of " << folly::demangle(type.name());
+    distanceField.print(os, level + 1);
+    countField.print(os, level + 1);
+  }
+
+  void clear() final {
+    LayoutBase::clear();
+    distanceField.clear();
+    countField.clear();
+  }
+
+  FROZEN_SAVE_INLINE(FROZEN_SAVE_FIELD(distance) FROZEN_SAVE_FIELD(count))
+
+  FROZEN_LOAD_INLINE(FROZEN_LOAD_FIELD(distance, 1) FROZEN_LOAD_FIELD(count, 2))
+
+  static size_t hash(const View& v) {
+    return folly::hash::fnv64_buf(v.begin(), v.size());
+  }
+};
+
 } // namespace detail
 
 template <class T>
 struct Layout<T, typename std::enable_if<IsString<T>::value>::type>
     : detail::StringLayout<typename std::decay<T>::type> {};
 
+template <class T>
+struct Layout<T, typename std::enable_if<IsInternedString<T>::value>::type>
+    : detail::InternedStringLayout<typename std::decay<T>::type> {};
+
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
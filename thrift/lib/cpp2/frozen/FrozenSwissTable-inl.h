@@ -0,0 +1,306 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+namespace apache {
+namespace thrift {
+namespace frozen {
+namespace detail {
+
+/**
+ * A group of slots in a SwissTableLayout: one control byte per slot, holding
+ * either kEmpty or the low 7 bits of the hash of the slot's key, followed by
+ * the index of the group's first item in the dense item array. All 16
+ * control bytes of a group are matched at once. Groups are frozen as raw
+ * bytes, so the struct has no padding, and needs no more alignment than the
+ * other blittable items of a frozen buffer.
+ */
+struct SwissGroup {
+  static constexpr size_t kSlots = 16;
+  static constexpr uint8_t kEmpty = 0x80;
+
+  uint8_t ctrl[kSlots];
+  uint64_t offset;
+
+  SwissGroup() : offset(0) {
+    std::fill(ctrl, ctrl + kSlots, kEmpty);
+  }
+
+  // Bit i is set if slot i holds a key with the given hash bits.
+  uint32_t match(uint8_t h2) const {
+#if FOLLY_SSE >= 2
+    auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return _mm_movemask_epi8(
+        _mm_cmpeq_epi8(c, _mm_set1_epi8(static_cast<char>(h2))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kSlots; ++i) {
+      mask |= uint32_t(ctrl[i] == h2) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Bit i is set if slot i is empty.
+  uint32_t matchEmpty() const {
+#if FOLLY_SSE >= 2
+    auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return _mm_movemask_epi8(c);
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kSlots; ++i) {
+      mask |= uint32_t(ctrl[i] == kEmpty) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Bit i is set if slot i holds an item.
+  uint32_t matchFull() const {
+    return ~matchEmpty() & ((1u << kSlots) - 1);
+  }
+};
+
+static_assert(
+    sizeof(SwissGroup) == SwissGroup::kSlots + sizeof(uint64_t),
+    "SwissGroup must not have padding bytes");
+
+/**
+ * Layout specialization for range types which support unique hash lookup,
+ * laid out as a Swiss table: slots are grouped 16 at a time, a lookup probes
+ * whole groups by comparing 7 hash bits against each control byte, and only
+ * items whose hash bits match are compared. A lookup usually touches one
+ * group and one item. Takes 1.5 bytes per slot for the groups, at a load
+ * factor between 40% and 80%.
+ */
+template <class T, class Item, class KeyExtractor, class Key>
+struct SwissTableLayout : public ArrayLayout<T, Item> {
+  typedef ArrayLayout<T, Item> Base;
+  Field<std::vector<SwissGroup>> groupsField;
+  typedef Layout<Key> KeyLayout;
+  typedef SwissTableLayout LayoutSelf;
+
+  SwissTableLayout()
+      : groupsField(4, "groups") // continue field ids from ArrayLayout
+  {}
+
+  FieldPosition maximize() {
+    FieldPosition pos = ArrayLayout<T, Item>::maximize();
+    FROZEN_MAXIMIZE_FIELD(groups);
+    return pos;
+  }
+
+  // Power of two, so that triangular probing visits every group.
+  static size_t groupCount(size_t size) {
+    size_t slots = size + size / 4; // 80% max load factor
+    return folly::nextPowTwo(std::max<size_t>(
+        1, (slots + SwissGroup::kSlots - 1) / SwissGroup::kSlots));
+  }
+
+  static size_t mix(size_t hash) {
+    return folly::hash::twang_mix64(hash);
+  }
+
+  static uint8_t hashBits(size_t mixed) {
+    return mixed & 0x7f;
+  }
+
+  static size_t firstGroup(size_t mixed, size_t groups) {
+    return (mixed >> 7) & (groups - 1);
+  }
+
+  static void buildIndex(
+      const T& coll,
+      std::vector<const Item*>& index,
+      std::vector<SwissGroup>& groups) {
+    auto n = groupCount(coll.size());
+    groups.resize(n);
+    index.resize(n * SwissGroup::kSlots);
+    for (auto& item : coll) {
+      const typename KeyExtractor::KeyType* itemKey =
+          &KeyExtractor::getKey(item);
+      auto h = mix(KeyLayout::hash(*itemKey));
+      auto h2 = hashBits(h);
+      auto g = firstGroup(h, n);
+      for (size_t p = 0;; g = (g + ++p) & (n - 1)) {
+        auto& group = groups[g];
+        for (auto m = group.match(h2); m; m &= m - 1) {
+          auto slot = folly::findFirstSet(m) - 1;
+          if (*itemKey ==
+              KeyExtractor::getKey(*index[g * SwissGroup::kSlots + slot])) {
+            throw std::domain_error("Input collection is not distinct");
+          }
+        }
+        if (auto empty = group.matchEmpty()) {
+          auto slot = folly::findFirstSet(empty) - 1;
+          group.ctrl[slot] = h2;
+          index[g * SwissGroup::kSlots + slot] =
+              KeyExtractor::getPointer(item);
+          break;
+        }
+        if (p + 1 == n) {
+          throw std::out_of_range("All buckets full!");
+        }
+      }
+    }
+    size_t count = 0;
+    for (auto& group : groups) {
+      group.offset = count;
+      count += folly::popcount(group.matchFull());
+    }
+  }
+
+  FieldPosition layoutItems(
+      LayoutRoot& root,
+      const T& coll,
+      LayoutPosition self,
+      FieldPosition pos,
+      LayoutPosition write,
+      FieldPosition writeStep) final {
+    std::vector<const Item*> index;
+    std::vector<SwissGroup> groups;
+    buildIndex(coll, index, groups);
+
+    pos = root.layoutField(self, pos, this->groupsField, groups);
+
+    FieldPosition noField; // not really used
+    for (auto& it : index) {
+      if (it) {
+        root.layoutField(write, noField, this->itemField, *it);
+        write = write(writeStep);
+      }
+    }
+
+    return pos;
+  }
+
+  void freezeItems(
+      FreezeRoot& root,
+      const T& coll,
+      FreezePosition self,
+      FreezePosition write,
+      FieldPosition writeStep) const final {
+    std::vector<const Item*> index;
+    std::vector<SwissGroup> groups;
+    buildIndex(coll, index, groups);
+
+    root.freezeField(self, this->groupsField, groups);
+
+    FieldPosition noField; // not really used
+    for (auto& it : index) {
+      if (it) {
+        root.freezeField(write, this->itemField, *it);
+        write = write(writeStep);
+      }
+    }
+  }
+
+  void thaw(ViewPosition self, T& out) const {
+    out.clear();
+    auto v = view(self);
+    for (auto it = v.begin(); it != v.end(); ++it) {
+      out.insert(it.thaw());
+    }
+  }
+
+  void print(std::ostream& os, int level) const override {
+    Base::print(os, level);
+    groupsField.print(os, level + 1);
+  }
+
+  void clear() final {
+    Base::clear();
+    groupsField.clear();
+  }
+
+  FROZEN_SAVE_INLINE(FROZEN_SAVE_FIELD(groups))
+
+  FROZEN_LOAD_INLINE(FROZEN_LOAD_FIELD(groups, 4))
+
+  class View : public Base::View {
+    typedef typename Layout<Key>::View KeyView;
+    typedef typename Layout<Item>::View ItemView;
+
+    folly::Range<const SwissGroup*> groups_;
+
+   public:
+    View() {}
+    View(const LayoutSelf* layout, ViewPosition self)
+        : Base::View(layout, self),
+          groups_(layout->groupsField.layout
+                      .view(self(layout->groupsField.pos))
+                      .range()) {}
+
+    typedef typename Base::View::iterator iterator;
+
+    void operator[](size_t) = delete;
+
+    std::pair<iterator, iterator> equal_range(const KeyView& key) const {
+      auto found = find(key);
+      if (found != this->end()) {
+        auto next = found;
+        return std::make_pair(found, ++next);
+      } else {
+        return std::make_pair(found, found);
+      }
+    }
+
+    iterator find(const KeyView& key) const {
+      auto n = groups_.size();
+      if (n == 0) {
+        return this->end();
+      }
+      auto h = mix(KeyLayout::hash(key));
+      auto h2 = hashBits(h);
+      auto g = firstGroup(h, n);
+      for (size_t p = 0; p < n; g = (g + ++p) & (n - 1)) {
+        const SwissGroup& group = groups_[g];
+        auto full = group.matchFull();
+        for (auto m = group.match(h2); m; m &= m - 1) {
+          auto slot = folly::findFirstSet(m) - 1;
+          auto index =
+              group.offset + folly::popcount(full & ((1u << slot) - 1));
+          auto found = this->begin() + index;
+          if (KeyExtractor::getViewKey(*found) == key) {
+            return found;
+          }
+        }
+        if (full != (1u << SwissGroup::kSlots) - 1) {
+          // A group with an empty slot ends every probe sequence through it.
+          break;
+        }
+      }
+      return this->end();
+    }
+
+    size_t count(const KeyView& key) const {
+      return find(key) == this->end() ? 0 : 1;
+    }
+
+    T thaw() const {
+      T ret;
+      static_cast<const SwissTableLayout*>(this->layout_)
+          ->thaw(this->position_, ret);
+      return ret;
+    }
+  };
+
+  View view(ViewPosition self) const {
+    return View(this, self);
+  }
+};
+} // namespace detail
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
@@ -16,8 +16,12 @@
 #include <thrift/lib/cpp2/frozen/FrozenUtil.h>
 
 #include <cstdlib>
+#include <thread>
 
 #include <folly/Conv.h>
+#include <folly/portability/SysMman.h>
+#include <folly/portability/SysResource.h>
+#include <folly/portability/Unistd.h>
 
 DEFINE_bool(
     thrift_frozen_util_disable_mlock,
@@ -105,6 +109,160 @@ void MallocFreezer::doAppendBytes(
   range = appendBuffer(padding + n);
   range.advance(padding);
 }
+namespace {
+
+size_t pageSize() {
+  static const size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+// Widens 'range' to whole pages.
+folly::ByteRange pagesOf(folly::ByteRange range) {
+  if (range.empty()) {
+    return range;
+  }
+  auto mask = ~(uintptr_t(pageSize()) - 1);
+  auto begin = reinterpret_cast<uintptr_t>(range.begin()) & mask;
+  auto end = alignBy(reinterpret_cast<uintptr_t>(range.end()), pageSize());
+  return folly::ByteRange(
+      reinterpret_cast<const byte*>(begin), reinterpret_cast<const byte*>(end));
+}
+
+void advise(folly::ByteRange range, int advice, const char* name) {
+  auto pages = pagesOf(range);
+  if (pages.empty()) {
+    return;
+  }
+  if (madvise(const_cast<byte*>(pages.begin()), pages.size(), advice) != 0) {
+    PLOG(WARNING) << "madvise(" << name << ") failed";
+  }
+}
+
+struct PageFaults {
+  int64_t minor{0};
+  int64_t major{0};
+};
+
+PageFaults pageFaults() {
+  PageFaults faults;
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    faults.minor = usage.ru_minflt;
+    faults.major = usage.ru_majflt;
+  }
+  return faults;
+}
+
+} // namespace
+
+void adviseFrozenRange(folly::ByteRange range, FrozenAccess access) {
+  switch (access) {
+    case FrozenAccess::Normal:
+      advise(range, MADV_NORMAL, "MADV_NORMAL");
+      break;
+    case FrozenAccess::Random:
+      advise(range, MADV_RANDOM, "MADV_RANDOM");
+      break;
+    case FrozenAccess::Sequential:
+      advise(range, MADV_SEQUENTIAL, "MADV_SEQUENTIAL");
+      break;
+    case FrozenAccess::WillNeed:
+      advise(range, MADV_WILLNEED, "MADV_WILLNEED");
+      break;
+  }
+}
+
+void populateFrozenRange(folly::ByteRange range, size_t threads) {
+  const size_t page = pageSize();
+  size_t pages = (range.size() + page - 1) / page;
+  threads = std::max<size_t>(1, std::min(threads, pages));
+  auto touch = [&](size_t beginPage, size_t endPage) {
+    auto data = static_cast<const volatile byte*>(range.begin());
+    byte sum = 0;
+    for (size_t p = beginPage; p < endPage; ++p) {
+      sum ^= data[p * page];
+    }
+    (void)sum;
+  };
+  if (threads <= 1) {
+    touch(0, pages);
+    return;
+  }
+  size_t perThread = (pages + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (size_t begin = 0; begin < pages; begin += perThread) {
+    workers.emplace_back(touch, begin, std::min(pages, begin + perThread));
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+size_t residentFrozenBytes(folly::ByteRange range) {
+#ifdef __linux__
+  auto pages = pagesOf(range);
+  if (pages.empty()) {
+    return 0;
+  }
+  std::vector<unsigned char> resident(pages.size() / pageSize());
+  if (mincore(const_cast<byte*>(pages.begin()), pages.size(), &resident[0]) !=
+      0) {
+    return 0;
+  }
+  size_t count = 0;
+  for (auto r : resident) {
+    count += r & 1;
+  }
+  return std::min(range.size(), count * pageSize());
+#else
+  (void)range;
+  return 0;
+#endif
+}
+
+folly::MemoryMapping mapFrozenFile(
+    folly::File file,
+    const MapFrozenOptions& options) {
+  auto start = std::chrono::steady_clock::now();
+  auto faultsBefore = pageFaults();
+  folly::MemoryMapping mapping(std::move(file), 0);
+  auto range = mapping.range();
+  if (options.stats) {
+    *options.stats = MapFrozenStats();
+    options.stats->mappedBytes = range.size();
+    options.stats->residentBytesBefore = residentFrozenBytes(range);
+  }
+
+  if (options.hugePages) {
+#ifdef MADV_HUGEPAGE
+    advise(range, MADV_HUGEPAGE, "MADV_HUGEPAGE");
+#endif
+  }
+  if (options.populateThreads) {
+    // Read ahead as fast as possible first; the requested pattern only applies
+    // once the file is in memory.
+    adviseFrozenRange(range, FrozenAccess::WillNeed);
+    populateFrozenRange(range, options.populateThreads);
+  }
+  if (options.access != FrozenAccess::Normal) {
+    adviseFrozenRange(range, options.access);
+  }
+  if (options.lock) {
+    mapping.mlock(options.lockMode);
+  }
+
+  if (options.stats) {
+    auto faultsAfter = pageFaults();
+    options.stats->residentBytesAfter = residentFrozenBytes(range);
+    options.stats->minorFaults = faultsAfter.minor - faultsBefore.minor;
+    options.stats->majorFaults = faultsAfter.major - faultsBefore.major;
+    options.stats->elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+  }
+  return mapping;
+}
+
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
@@ -15,9 +15,11 @@
  */
 #pragma once
 
+#include <chrono>
 #include <stdexcept>
 
 #include <folly/File.h>
+#include <folly/io/IOBuf.h>
 #include <folly/portability/GFlags.h>
 #include <folly/system/MemoryMapping.h>
 #include <thrift/lib/cpp2/frozen/Frozen.h>
@@ -68,6 +70,13 @@ class MallocFreezer final : public FreezeRoot {
   size_t distanceToEnd(const byte* origin) const;
   size_t offsetOf(const byte* origin) const;
 
+  int64_t distanceBetween(const byte* origin, const byte* target)
+      const override {
+    // Segments aren't contiguous in memory, but are once appended.
+    return static_cast<int64_t>(distanceToEnd(origin)) -
+        static_cast<int64_t>(distanceToEnd(target));
+  }
+
   folly::MutableByteRange appendBuffer(size_t size);
 
   void doAppendBytes(
@@ -205,6 +214,35 @@ void freezeToStringMalloc(const T& x, std::string& out) {
   freezer.appendTo(out);
 }
 
+/**
+ * Freezes 'x' along with its layout into a single IOBuf, without intermediate
+ * copies. The result can be sent as an IOBuf binary field, e.g.
+ *
+ *   typedef binary (cpp2.type = "std::unique_ptr<folly::IOBuf>") IOBufPtr
+ *
+ * and the receiver can use it in place with mapFrozen<T>(std::move(buf)).
+ */
+template <class T>
+std::unique_ptr<folly::IOBuf> freezeToIOBuf(const T& x) {
+  Layout<T> layout;
+  size_t contentSize = LayoutRoot::layout(x, layout);
+  std::string schema;
+  serializeRootLayout(layout, schema);
+
+  size_t bufferSize = schema.size() + contentSize;
+  auto buf = folly::IOBuf::create(bufferSize);
+  std::copy(schema.begin(), schema.end(), buf->writableData());
+  std::fill(
+      buf->writableData() + schema.size(),
+      buf->writableData() + bufferSize,
+      0);
+  folly::MutableByteRange writeRange(
+      buf->writableData() + schema.size(), contentSize);
+  ByteRangeFreezer::freeze(layout, x, writeRange);
+  buf->append(bufferSize - writeRange.size());
+  return buf;
+}
+
 /**
  * mapFrozen<T>() returns an owned reference to a frozen object which can be
  * used as a Frozen view of the object. All overloads of this function return
@@ -219,6 +257,8 @@ void freezeToStringMalloc(const T& x, std::string& out) {
  *  - mapFrozen<T>(StringPiece): Same as mapFrozen<T>(ByteRange).
  *  - mapFrozen<T>(MemoryMapping): Takes ownership of the memory mapping
  *      in addition to the layout tree.
+ *  - mapFrozen<T>(unique_ptr<IOBuf>): Takes ownership of the IOBuf, which is
+ *      coalesced first if it is chained.
  *  - mapFrozen<T>(File): Owns the memory mapping created from the File (which,
  *      in turn, takes ownership of the File) in addition to the layout tree.
  */
@@ -271,19 +311,97 @@ MappedFrozen<T> mapFrozen(std::string&& str, bool trim = true) {
   return ret;
 }
 
+template <class T>
+MappedFrozen<T> mapFrozen(std::unique_ptr<folly::IOBuf> buf) {
+  // Frozen data is only readable when contiguous; unchained buffers, such as
+  // a binary field shared out of a single received frame, are used in place.
+  auto ret = mapFrozen<T>(buf->coalesce());
+  ret.hold(std::move(buf));
+  return ret;
+}
+
 template <class T>
 [[deprecated(
     "std::string values must be passed by move with std::move(str) or "
     "passed through non-owning StringPiece")]] MappedFrozen<T>
 mapFrozen(const std::string& str) = delete;
 
+/**
+ * Expected access pattern for a region of mapped frozen data.
+ */
+enum class FrozenAccess {
+  Normal,
+  Random, // e.g. hash table indexes, lookups by key
+  Sequential, // e.g. payloads which are scanned or thawed in full
+  WillNeed, // start reading ahead now
+};
+
+/**
+ * Counters collected by mapFrozen() when MapFrozenOptions::stats is set. Page
+ * faults are counted for the whole process, including populate threads.
+ */
+struct MapFrozenStats {
+  size_t mappedBytes{0};
+  // Bytes of the file already in the page cache when it was mapped.
+  size_t residentBytesBefore{0};
+  size_t residentBytesAfter{0};
+  int64_t minorFaults{0};
+  int64_t majorFaults{0};
+  std::chrono::microseconds elapsed{0};
+};
+
+/**
+ * Controls how mapFrozen(File, MapFrozenOptions) brings a file into memory.
+ */
+struct MapFrozenOptions {
+  // Touch every page before returning, splitting the file among this many
+  // threads. Zero leaves pages to be faulted in on first access.
+  size_t populateThreads{0};
+  // Ask for transparent huge pages, where the file system supports them.
+  bool hugePages{false};
+  // Access pattern for the whole file; use adviseFrozenRange() to refine it
+  // for parts of the mapped object.
+  FrozenAccess access{FrozenAccess::Normal};
+  bool lock{!FLAGS_thrift_frozen_util_disable_mlock};
+  folly::MemoryMapping::LockMode lockMode{
+      folly::MemoryMapping::LockMode::TRY_LOCK};
+  // If set, filled in by mapFrozen().
+  MapFrozenStats* stats{nullptr};
+};
+
+/**
+ * Applies 'access' to the pages spanned by 'range', which must lie within a
+ * mapping. Useful for parts of a mapped view with their own access pattern,
+ * such as the items of a large list of integers which is only probed.
+ */
+void adviseFrozenRange(folly::ByteRange range, FrozenAccess access);
+
+/**
+ * Reads one byte of every page of 'range' using up to 'threads' threads.
+ */
+void populateFrozenRange(folly::ByteRange range, size_t threads);
+
+/**
+ * Returns how many bytes of the pages spanned by 'range' are resident, or zero
+ * where this can't be determined.
+ */
+size_t residentFrozenBytes(folly::ByteRange range);
+
+/**
+ * Maps 'file' and prepares it according to 'options'.
+ */
+folly::MemoryMapping mapFrozenFile(
+    folly::File file,
+    const MapFrozenOptions& options);
+
+template <class T>
+MappedFrozen<T> mapFrozen(folly::File file, const MapFrozenOptions& options) {
+  return mapFrozen<T>(mapFrozenFile(std::move(file), options));
+}
+
 template <class T>
 MappedFrozen<T> mapFrozen(folly::File file) {
-  folly::MemoryMapping mapping(std::move(file), 0);
-  if (!FLAGS_thrift_frozen_util_disable_mlock) {
-    mapping.mlock(folly::MemoryMapping::LockMode::TRY_LOCK);
-  }
-  return mapFrozen<T>(std::move(mapping));
+  return mapFrozen<T>(std::move(file), MapFrozenOptions());
 }
 
 template <class T>
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -44,7 +45,58 @@ class VectorUnpacked : public std::vector<T> {
       "Unpacked storage is only available for simple item types");
   using std::vector<T>::vector;
 };
+
+/*
+ * For sorted or clustered sequences of integers, like timestamps or IDs.
+ * Values are packed in blocks of 128 as offsets from the block's minimum, at
+ * the width that block needs. Items are still randomly accessible.
+ *
+ * Use this in Thrift IDL like:
+ *
+ *   cpp_include "thrift/lib/cpp2/frozen/HintTypes.h"
+ *
+ *   struct MyStruct {
+ *     8: list<i64>
+ *        (cpp.template = "apache::thrift::frozen::VectorBlockPacked")
+ *        timestamps,
+ *   }
+ */
+template <class T>
+class VectorBlockPacked : public std::vector<T> {
+  static_assert(
+      std::is_integral<T>::value && !std::is_same<T, bool>::value,
+      "Block packed storage is only available for integral item types");
+  using std::vector<T>::vector;
+};
+
+/*
+ * For strings that repeat a lot within one frozen object, like country codes
+ * or category names. Each distinct value is stored once and every occurrence
+ * refers to it; views are plain folly::StringPiece.
+ *
+ * Use this in Thrift IDL like:
+ *
+ *   cpp_include "thrift/lib/cpp2/frozen/HintTypes.h"
+ *
+ *   typedef string
+ *     (cpp.type = "apache::thrift::frozen::InternedString") InternedString
+ *
+ *   struct MyStruct {
+ *     3: InternedString country,
+ *   }
+ */
+class InternedString : public std::string {
+ public:
+  using std::string::string;
+  InternedString() = default;
+  /* implicit */ InternedString(const std::string& s) : std::string(s) {}
+  /* implicit */ InternedString(std::string&& s) : std::string(std::move(s)) {}
+};
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
 THRIFT_DECLARE_TRAIT_TEMPLATE(IsString, apache::thrift::frozen::VectorUnpacked)
+THRIFT_DECLARE_TRAIT_TEMPLATE(
+    IsBlockPacked,
+    apache::thrift::frozen::VectorBlockPacked)
+THRIFT_DECLARE_TRAIT(IsInternedString, apache::thrift::frozen::InternedString)
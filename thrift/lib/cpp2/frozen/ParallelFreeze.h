@@ -0,0 +1,331 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+namespace detail {
+
+/**
+ * Items [begin, end) of a list, laid out and frozen by one task. Their
+ * out-of-line data goes to [dataStart, dataStart + dataSize) past the root.
+ *
+ * Packed fields are written by reading and rewriting a whole word, which may
+ * reach up to LayoutRoot::kPaddingBytes past the bytes a shard owns. So
+ * padding separates the slots from the data, and the data of every shard
+ * from the next one.
+ */
+struct ListShard {
+  size_t begin;
+  size_t end;
+  size_t dataStart;
+  size_t dataSize;
+};
+
+// Shard boundaries are multiples of 64 items, so bit-packed slots of
+// different shards never share a word of up to 64 bits.
+inline std::vector<ListShard> makeListShards(size_t count, size_t numShards) {
+  std::vector<ListShard> shards;
+  size_t per = (count + numShards - 1) / std::max<size_t>(numShards, 1);
+  per = alignBy(std::max<size_t>(per, 1), 64);
+  for (size_t begin = 0; begin < count; begin += per) {
+    shards.push_back({begin, std::min(count, begin + per), 0, 0});
+  }
+  return shards;
+}
+
+/**
+ * Runs f(s) for every 'step'-th shard index starting at 'first', and waits for
+ * all of them before rethrowing the first failure.
+ */
+template <class F>
+void forEachShard(
+    folly::Executor* executor,
+    size_t count,
+    F&& f,
+    size_t first = 0,
+    size_t step = 1) {
+  std::vector<folly::Future<folly::Unit>> tasks;
+  for (size_t s = first; s < count; s += step) {
+    tasks.push_back(folly::via(executor, [&f, s] { f(s); }));
+  }
+  for (auto& result : folly::collectAll(tasks).get()) {
+    result.throwIfFailed();
+  }
+}
+
+/**
+ * LayoutRoot for laying out a slice of a std::vector<T> root at the same
+ * positions a serial layout would use.
+ */
+template <class T>
+class ListShardLayoutRoot : public LayoutRoot {
+ public:
+  typedef Layout<std::vector<T>> ListLayout;
+
+  // An item which grew the layout, and where it was laid out.
+  struct Witness {
+    size_t index;
+    LayoutPosition write;
+    size_t cursor;
+  };
+
+  static size_t slotBytes(const ListLayout& layout, size_t count) {
+    size_t itemBytes = layout.itemField.layout.size;
+    size_t itemBits = itemBytes ? 0 : layout.itemField.layout.bits;
+    return itemBits ? (count * itemBits + 7) / 8 : count * itemBytes;
+  }
+
+  /**
+   * Mirrors ArrayLayout::layout() for the root, without the items. Sets
+   * 'slots' to the offset of the item slots and returns the offset past them.
+   */
+  size_t layoutRoot(ListLayout& layout, size_t count, size_t& slots) {
+    resized_ = false;
+    cursor_ = layout.size;
+    LayoutPosition self{0, 0};
+    FieldPosition pos = layout.startFieldPosition();
+    pos = layoutField(self, pos, layout.countField, count);
+    size_t align = IsBlitType<T>::value ? alignof(T) : 1;
+    slots = layoutBytesDistance(0, slotBytes(layout, count), align);
+    pos = layoutField(self, pos, layout.distanceField, slots);
+    resized_ = layout.resize(pos, false) || resized_;
+    return cursor_;
+  }
+
+  /**
+   * Lays out the items of 'shard' into 'layout', recording the items which
+   * made it grow. Returns the worst case size of the shard's data.
+   */
+  size_t layoutShard(
+      ListLayout& layout,
+      const std::vector<T>& items,
+      const ListShard& shard,
+      size_t slots,
+      std::vector<Witness>& witnesses) {
+    cursor_ = shard.dataStart;
+    size_t itemBytes = layout.itemField.layout.size;
+    size_t itemBits = itemBytes ? 0 : layout.itemField.layout.bits;
+    FieldPosition noField; // not really used
+    for (size_t i = shard.begin; i < shard.end; ++i) {
+      LayoutPosition write{slots + i * itemBytes, i * itemBits};
+      size_t cursor = cursor_;
+      resized_ = false;
+      layoutField(write, noField, layout.itemField, items[i]);
+      if (resized_) {
+        witnesses.push_back({i, write, cursor});
+      }
+    }
+    return cursor_ - shard.dataStart;
+  }
+
+  /**
+   * Grows 'layout' by what the witnesses of 'shard' needed, laying them out
+   * again where they were found.
+   *
+   * An InternedString may be laid out as a distance back to an earlier item
+   * of the shard, which only resolves the same way against the shard's intern
+   * table. So if the shard interned any strings, all of its items up to the
+   * last witness are laid out again instead, rebuilding the table as they go.
+   */
+  void replay(
+      ListLayout& layout,
+      const std::vector<T>& items,
+      const ListShard& shard,
+      size_t slots,
+      bool interned,
+      const std::vector<Witness>& witnesses) {
+    FieldPosition noField; // not really used
+    internedBytes_.clear();
+    if (interned && !witnesses.empty()) {
+      size_t itemBytes = layout.itemField.layout.size;
+      size_t itemBits = itemBytes ? 0 : layout.itemField.layout.bits;
+      cursor_ = shard.dataStart;
+      for (size_t i = shard.begin; i <= witnesses.back().index; ++i) {
+        LayoutPosition write{slots + i * itemBytes, i * itemBits};
+        layoutField(write, noField, layout.itemField, items[i]);
+      }
+      return;
+    }
+    for (auto& w : witnesses) {
+      cursor_ = w.cursor;
+      layoutField(w.write, noField, layout.itemField, items[w.index]);
+    }
+  }
+
+  bool resized() const {
+    return resized_;
+  }
+
+  // Whether any InternedString was laid out through this root.
+  bool interned() const {
+    return !internedBytes_.empty();
+  }
+};
+
+/**
+ * Computes a layout sufficient for 'items' with the shards laid out in
+ * parallel, and returns the number of bytes needed to freeze them.
+ *
+ * Each round lays out every shard against a copy of the current layout, at
+ * the positions a serial layout would use, then merges the growth by laying
+ * out again just the items which caused it. A round in which no shard grows
+ * its copy and no shard changes size is equivalent to a serial pass reaching
+ * its fixed point.
+ */
+template <class T>
+size_t layoutListParallel(
+    const std::vector<T>& items,
+    Layout<std::vector<T>>& layout,
+    std::vector<ListShard>& shards,
+    folly::Executor* executor) {
+  typedef ListShardLayoutRoot<T> Root;
+  for (size_t round = 0; round < 1000; ++round) {
+    Root root;
+    size_t slots;
+    size_t start = root.layoutRoot(layout, items.size(), slots);
+    bool changed = root.resized();
+    for (auto& shard : shards) {
+      start += LayoutRoot::kPaddingBytes;
+      shard.dataStart = start;
+      start += shard.dataSize;
+    }
+
+    std::vector<Layout<std::vector<T>>> layouts(shards.size(), layout);
+    std::vector<std::vector<typename Root::Witness>> witnesses(shards.size());
+    std::vector<size_t> sizes(shards.size());
+    // Not vector<bool>: shards set their flags concurrently.
+    std::vector<char> interned(shards.size());
+    forEachShard(executor, shards.size(), [&](size_t s) {
+      Root shardRoot;
+      sizes[s] = shardRoot.layoutShard(
+          layouts[s], items, shards[s], slots, witnesses[s]);
+      interned[s] = shardRoot.interned();
+    });
+
+    for (size_t s = 0; s < shards.size(); ++s) {
+      changed = changed || !witnesses[s].empty() ||
+          sizes[s] != shards[s].dataSize;
+      shards[s].dataSize = sizes[s];
+    }
+    if (!changed) {
+      return start + LayoutRoot::kPaddingBytes;
+    }
+    for (size_t s = 0; s < shards.size(); ++s) {
+      root.replay(layout, items, shards[s], slots, interned[s], witnesses[s]);
+    }
+  }
+  throw std::logic_error("Parallel layout did not reach a fixed point");
+}
+
+/**
+ * Freezes 'items' into 'root' according to a layout and shards computed by
+ * layoutListParallel(). Mirrors FreezeRoot::doFreeze() and ArrayLayout.
+ */
+template <class T>
+void freezeListParallel(
+    const std::vector<T>& items,
+    const Layout<std::vector<T>>& layout,
+    const std::vector<ListShard>& shards,
+    folly::Executor* executor,
+    folly::MutableByteRange root) {
+  size_t itemBytes = layout.itemField.layout.size;
+  size_t itemBits = itemBytes ? 0 : layout.itemField.layout.bits;
+  // Only blittable items are aligned, and those have no out-of-line data, so
+  // distances from slots into shard data never exceed those laid out.
+  size_t align = IsBlitType<T>::value ? alignof(T) : 1;
+  byte* slots = reinterpret_cast<byte*>(alignBy(
+      reinterpret_cast<intptr_t>(root.begin() + layout.size), align));
+  {
+    folly::MutableByteRange write = root;
+    ByteRangeFreezer freezer(write);
+    FreezePosition self{root.begin(), 0};
+    freezer.freezeField(self, layout.countField, items.size());
+    freezer.freezeField(
+        self, layout.distanceField, size_t(slots - root.begin()));
+  }
+
+  // A packed field of the last slot of a shard may be rewritten with the
+  // word holding the first slots of the next shard, so neighbouring shards
+  // are never frozen concurrently. Shards at least two apart never share a
+  // word: a shard has at least 64 slots, and the slots of the last shard are
+  // followed by padding rather than by the data of the first one.
+  for (size_t parity = 0; parity < 2; ++parity) {
+    forEachShard(
+        executor,
+        shards.size(),
+        [&](size_t s) {
+          auto& shard = shards[s];
+          folly::MutableByteRange write(
+              root.begin() + shard.dataStart, shard.dataSize);
+          ByteRangeFreezer freezer(write);
+          for (size_t i = shard.begin; i < shard.end; ++i) {
+            FreezePosition item{slots + i * itemBytes, i * itemBits};
+            freezer.freezeField(item, layout.itemField, items[i]);
+          }
+        },
+        parity,
+        2);
+  }
+}
+
+} // namespace detail
+
+/**
+ * Like freezeToString(), but lays out and freezes the items of the list on
+ * 'executor', in about 'numShards' slices. The output can be read with
+ * mapFrozen<std::vector<T>>() like any other.
+ */
+template <class T>
+void freezeToStringParallel(
+    const std::vector<T>& items,
+    std::string& out,
+    folly::Executor* executor,
+    size_t numShards) {
+  auto shards = detail::makeListShards(items.size(), numShards);
+  if (shards.size() <= 1) {
+    freezeToString(items, out);
+    return;
+  }
+  Layout<std::vector<T>> layout;
+  size_t contentSize =
+      detail::layoutListParallel(items, layout, shards, executor);
+  out.clear();
+  serializeRootLayout(layout, out);
+  size_t schemaSize = out.size();
+  out.resize(schemaSize + contentSize, 0);
+  detail::freezeListParallel(
+      items,
+      layout,
+      shards,
+      executor,
+      folly::MutableByteRange(
+          reinterpret_cast<byte*>(&out[schemaSize]), contentSize));
+}
+
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/frozen/StreamingFreeze.h>
+
+#include <folly/Conv.h>
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <folly/portability/Unistd.h>
+
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+namespace {
+// NB: Buffers are padded since packed integers are written a word at a time.
+std::unique_ptr<byte[]> allocateZeroed(size_t size) {
+  return std::unique_ptr<byte[]>(new byte[alignBy(size, 8) + 8]());
+}
+} // namespace
+
+StreamingFreezeRoot::StreamingFreezeRoot(folly::File file, size_t flushBytes)
+    : file_(std::move(file)), flushBytes_(flushBytes) {}
+
+void StreamingFreezeRoot::writeSchema(folly::StringPiece schema) {
+  fileOffset_ = 0;
+  writeAt(0, folly::ByteRange(schema));
+  fileOffset_ = schema.size();
+}
+
+void StreamingFreezeRoot::writeAt(size_t offset, folly::ByteRange bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  auto written = folly::pwriteFull(
+      file_.fd(), bytes.data(), bytes.size(), fileOffset_ + offset);
+  folly::checkUnixError(written, "pwrite of frozen data failed");
+}
+
+byte* StreamingFreezeRoot::openWindow(size_t offset, size_t size) {
+  window_ = Segment{offset, size, allocateZeroed(size)};
+  return window_.buffer.get();
+}
+
+void StreamingFreezeRoot::flushWindow(size_t size) {
+  writeAt(window_.offset, {window_.buffer.get(), size});
+  window_ = Segment{0, 0, nullptr};
+}
+
+void StreamingFreezeRoot::flushData() {
+  for (auto& entry : segments_) {
+    auto& segment = entry.second;
+    writeAt(segment.offset, {segment.buffer.get(), segment.size});
+  }
+  segments_.clear();
+  buffered_ = 0;
+}
+
+void StreamingFreezeRoot::finishFile() {
+  flushData();
+  byte padding[LayoutRoot::kPaddingBytes] = {};
+  writeAt(cursor_, {padding, sizeof(padding)});
+  folly::checkUnixError(
+      ftruncate(file_.fd(), fileOffset_ + cursor_ + sizeof(padding)),
+      "ftruncate of frozen file failed");
+}
+
+size_t StreamingFreezeRoot::offsetOf(const byte* ptr) const {
+  auto windowStart = window_.buffer.get();
+  if (ptr >= windowStart && ptr < windowStart + window_.size) {
+    return window_.offset + (ptr - windowStart);
+  }
+  auto it = segments_.upper_bound(ptr);
+  if (it == segments_.begin()) {
+    auto where = segments_.empty()
+        ? std::string("no segments are buffered")
+        : folly::to<std::string>(
+              "it lies ",
+              it->first - ptr,
+              " bytes before the first buffered segment (file offset ",
+              it->second.offset,
+              ", size ",
+              it->second.size,
+              ")");
+    throw std::runtime_error(folly::to<std::string>(
+        "Cannot find the file offset of a frozen object: it is outside the "
+        "current window (file offset ",
+        window_.offset,
+        ", size ",
+        window_.size,
+        ") and ",
+        where));
+  }
+  --it;
+  if (ptr > it->first + it->second.size) {
+    throw std::runtime_error(folly::to<std::string>(
+        "Cannot find the file offset of a frozen object: it is outside the "
+        "current window (file offset ",
+        window_.offset,
+        ", size ",
+        window_.size,
+        ") and lies ",
+        ptr - (it->first + it->second.size),
+        " bytes past the buffered segment before it (file offset ",
+        it->second.offset,
+        ", size ",
+        it->second.size,
+        ")"));
+  }
+  return it->second.offset + (ptr - it->first);
+}
+
+void StreamingFreezeRoot::doAppendBytes(
+    byte* origin,
+    size_t n,
+    folly::MutableByteRange& range,
+    size_t& distance,
+    size_t alignment) {
+  if (!n) {
+    distance = 0;
+    range.reset(nullptr, 0);
+    return;
+  }
+  size_t offset = alignBy(fileOffset_ + cursor_, alignment) - fileOffset_;
+  distance = offset - offsetOf(origin);
+  auto buffer = allocateZeroed(n);
+  byte* data = buffer.get();
+  range.reset(data, n);
+  segments_.emplace(data, Segment{offset, n, std::move(buffer)});
+  cursor_ = offset + n;
+  buffered_ += n;
+}
+
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <folly/File.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+
+namespace apache {
+namespace thrift {
+namespace frozen {
+
+/**
+ * Computes the layout of a std::vector<T> root from its items without holding
+ * them all in memory. Layout runs until it reaches a fixed point, so the items
+ * have to be replayed until end() returns true, usually two or three times:
+ *
+ *   StreamingLayout<Row> layout(numRows);
+ *   do {
+ *     layout.begin();
+ *     for (auto& row : readRows()) {
+ *       layout.add(row);
+ *     }
+ *   } while (!layout.end());
+ */
+template <class T>
+class StreamingLayout : private LayoutRoot {
+ public:
+  explicit StreamingLayout(size_t count) : count_(count) {}
+
+  void begin() {
+    resized_ = false;
+    cursor_ = layout_.size;
+    internedBytes_.clear();
+    added_ = 0;
+
+    // Mirrors ArrayLayout::layout() for the root.
+    LayoutPosition self{0, 0};
+    pos_ = layout_.startFieldPosition();
+    pos_ = layoutField(self, pos_, layout_.countField, count_);
+    if (!count_) {
+      pos_ = layoutField(self, pos_, layout_.distanceField, 0);
+      return;
+    }
+    size_t itemBytes = layout_.itemField.layout.size;
+    size_t itemBits = itemBytes ? 0 : layout_.itemField.layout.bits;
+    size_t align = detail::IsBlitType<T>::value ? alignof(T) : 1;
+    size_t dist = layoutBytesDistance(
+        self.start,
+        itemBits ? (count_ * itemBits + 7) / 8 : count_ * itemBytes,
+        align);
+    pos_ = layoutField(self, pos_, layout_.distanceField, dist);
+    write_ = LayoutPosition{self.start + dist, 0};
+    writeStep_ = FieldPosition(itemBytes, itemBits);
+  }
+
+  void add(const T& item) {
+    if (added_ == count_) {
+      throw std::out_of_range("More items than declared");
+    }
+    FieldPosition noField; // not really used
+    layoutField(write_, noField, layout_.itemField, item);
+    write_ = write_(writeStep_);
+    ++added_;
+    // Items don't outlive add(), so interned strings are only shared within
+    // one item. StreamingFreezer does the same.
+    internedBytes_.clear();
+  }
+
+  /**
+   * Finishes a pass over the items, returning whether the layout is final.
+   */
+  bool end() {
+    if (added_ != count_) {
+      throw std::logic_error("Fewer items than declared");
+    }
+    resized_ = layout_.resize(pos_, false) || resized_;
+    return !resized_;
+  }
+
+  const Layout<std::vector<T>>& layout() const {
+    return layout_;
+  }
+
+  /**
+   * Upper bound of the frozen size, excluding the schema.
+   */
+  size_t size() const {
+    return cursor_ + kPaddingBytes;
+  }
+
+ private:
+  Layout<std::vector<T>> layout_;
+  size_t count_;
+  size_t added_{0};
+  FieldPosition pos_;
+  LayoutPosition write_{0, 0};
+  FieldPosition writeStep_;
+};
+
+/**
+ * Base of StreamingFreezer, which handles the file and the bookkeeping of
+ * what is still in memory.
+ *
+ * Offsets are relative to the root object, which follows the schema in the
+ * file. The item slots of the list are kept in a window that is written out
+ * when full, and out-of-line data goes to individually allocated segments
+ * that are written out and freed once more than 'flushBytes' accumulate.
+ */
+class StreamingFreezeRoot : public FreezeRoot {
+ public:
+  static constexpr size_t kDefaultFlushBytes = size_t(64) << 20;
+
+ protected:
+  StreamingFreezeRoot(folly::File file, size_t flushBytes);
+
+  /**
+   * Writes the schema at the start of the file; the root object follows it.
+   */
+  void writeSchema(folly::StringPiece schema);
+
+  void writeAt(size_t offset, folly::ByteRange bytes);
+
+  /**
+   * Returns a zeroed buffer standing in for 'size' bytes at 'offset' until
+   * the next call. The previous window must have been flushed.
+   */
+  byte* openWindow(size_t offset, size_t size);
+
+  /**
+   * Writes the first 'size' bytes of the window.
+   */
+  void flushWindow(size_t size);
+
+  /**
+   * Writes out and frees all out-of-line data appended so far.
+   */
+  void flushData();
+
+  /**
+   * Flushes everything and writes the tail padding.
+   */
+  void finishFile();
+
+  size_t fileOffset() const {
+    return fileOffset_;
+  }
+
+  size_t bufferedBytes() const {
+    return buffered_;
+  }
+
+  size_t flushBytes() const {
+    return flushBytes_;
+  }
+
+  // End of everything allocated so far.
+  size_t cursor_{0};
+
+ private:
+  void doAppendBytes(
+      byte* origin,
+      size_t n,
+      folly::MutableByteRange& range,
+      size_t& distance,
+      size_t alignment) override;
+
+  int64_t distanceBetween(const byte* origin, const byte* target)
+      const override {
+    return static_cast<int64_t>(offsetOf(target)) -
+        static_cast<int64_t>(offsetOf(origin));
+  }
+
+  size_t offsetOf(const byte* ptr) const;
+
+  struct Segment {
+    size_t offset;
+    size_t size;
+    std::unique_ptr<byte[]> buffer;
+  };
+
+  folly::File file_;
+  size_t fileOffset_{0};
+  size_t flushBytes_;
+  size_t buffered_{0};
+  Segment window_{0, 0, nullptr};
+  // Keyed by buffer address.
+  std::map<const byte*, Segment> segments_;
+};
+
+/**
+ * Freezes a std::vector<T> straight to a file, one item at a time, keeping
+ * memory use bounded regardless of the number of items. The result can be
+ * read with mapFrozen<std::vector<T>>().
+ *
+ * The layout has to be sufficient for every item up front. Either compute it
+ * exactly with StreamingLayout, or use one laid out from a representative
+ * sample (or maximumLayout<std::vector<T>>() as a bound on the schema), in
+ * which case add() throws LayoutException for an item that doesn't fit.
+ *
+ *   StreamingFreezer<Row> freezer(std::move(file), layout, numRows);
+ *   for (auto& row : readRows()) {
+ *     freezer.add(row);
+ *   }
+ *   freezer.finish();
+ *
+ * Only lists can be streamed: ordered and hashed tables need all of their
+ * items to arrange them. InternedString values are only shared within an
+ * item, since items are dropped as soon as they are added.
+ */
+template <class T>
+class StreamingFreezer : private StreamingFreezeRoot {
+ public:
+  // Items per window of slots. A multiple of 8 so that windows of
+  // bit-packed items start on byte boundaries.
+  static constexpr size_t kWindowItems = 1 << 16;
+
+  StreamingFreezer(
+      folly::File file,
+      const Layout<std::vector<T>>& layout,
+      size_t count,
+      size_t flushBytes = kDefaultFlushBytes)
+      : StreamingFreezeRoot(std::move(file), flushBytes),
+        layout_(layout),
+        count_(count),
+        itemBytes_(layout_.itemField.layout.size),
+        itemBits_(itemBytes_ ? 0 : layout_.itemField.layout.bits) {
+    std::string schema;
+    serializeRootLayout(layout_, schema);
+    writeSchema(schema);
+
+    // Mirrors FreezeRoot::doFreeze() and ArrayLayout::freeze().
+    std::vector<byte> root(alignBy(layout_.size, 8));
+    FreezePosition self{root.data(), 0};
+    freezeField(self, layout_.countField, count_);
+    cursor_ = layout_.size;
+    size_t dist = 0;
+    if (count_) {
+      size_t align = detail::IsBlitType<T>::value ? alignof(T) : 1;
+      dist = alignBy(fileOffset() + cursor_, align) - fileOffset();
+      cursor_ = dist + slotBytes(count_);
+    }
+    freezeField(self, layout_.distanceField, dist);
+    writeAt(0, {root.data(), layout_.size});
+    slots_ = dist;
+  }
+
+  void add(const T& item) {
+    if (added_ == count_) {
+      throw std::out_of_range("More items than declared");
+    }
+    size_t slot = added_ % kWindowItems;
+    if (slot == 0) {
+      if (added_) {
+        flushWindow(slotBytes(kWindowItems));
+      }
+      slotWindow_ = openWindow(
+          slots_ + slotBytes(added_),
+          slotBytes(std::min(kWindowItems, count_ - added_)));
+    }
+    FreezePosition write{slotWindow_ + slot * itemBytes_, slot * itemBits_};
+    freezeField(write, layout_.itemField, item);
+    ++added_;
+    clearInternedBytes();
+    if (bufferedBytes() >= flushBytes()) {
+      flushData();
+    }
+  }
+
+  /**
+   * Writes out everything still buffered. All declared items must have been
+   * added.
+   */
+  void finish() {
+    if (added_ != count_) {
+      throw std::logic_error("Fewer items than declared");
+    }
+    if (count_) {
+      flushWindow(slotBytes((count_ - 1) % kWindowItems + 1));
+    }
+    finishFile();
+  }
+
+ private:
+  size_t slotBytes(size_t items) const {
+    return itemBits_ ? (items * itemBits_ + 7) / 8 : items * itemBytes_;
+  }
+
+  Layout<std::vector<T>> layout_;
+  size_t count_;
+  size_t itemBytes_;
+  size_t itemBits_;
+  size_t slots_{0};
+  size_t added_{0};
+  byte* slotWindow_{nullptr};
+};
+
+} // namespace frozen
+} // namespace thrift
+} // namespace apache
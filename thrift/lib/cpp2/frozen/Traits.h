@@ -22,15 +22,27 @@ namespace thrift {
 template <class>
 struct IsString : std::false_type {};
 template <class>
+struct IsInternedString : std::false_type {};
+template <class>
 struct IsHashMap : std::false_type {};
 template <class>
 struct IsHashSet : std::false_type {};
 template <class>
+struct IsSwissHashMap : std::false_type {};
+template <class>
+struct IsSwissHashSet : std::false_type {};
+template <class>
 struct IsOrderedMap : std::false_type {};
 template <class>
 struct IsOrderedSet : std::false_type {};
 template <class>
+struct IsEytzingerMap : std::false_type {};
+template <class>
+struct IsEytzingerSet : std::false_type {};
+template <class>
 struct IsList : std::false_type {};
+template <class>
+struct IsBlockPacked : std::false_type {};
 
 } // namespace thrift
 } // namespace apache
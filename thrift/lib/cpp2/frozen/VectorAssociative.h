@@ -100,6 +100,47 @@ class VectorAsHashMap : public VectorAsMap<K, V> {
   using VectorAsMap<K, V>::VectorAsMap;
 };
 
+/*
+ * Like VectorAsHashSet and VectorAsHashMap, but frozen with a Swiss table
+ * layout (see FrozenSwissTable-inl.h), which probes 16 slots per step using
+ * SIMD and typically touches one group before the item itself. Use this
+ * in Thrift IDL like:
+ *
+ *   cpp_include "thrift/lib/cpp2/frozen/VectorAssociative.h"
+ *
+ *   struct MyStruct {
+ *     1: map<i64, string>
+ *        (cpp.template = "apache::thrift::frozen::VectorAsSwissHashMap")
+ *        names,
+ *   }
+ */
+template <class V>
+class VectorAsSwissHashSet : public VectorAsSet<V> {
+  using VectorAsSet<V>::VectorAsSet;
+};
+
+template <class K, class V>
+class VectorAsSwissHashMap : public VectorAsMap<K, V> {
+  using VectorAsMap<K, V>::VectorAsMap;
+};
+
+/*
+ * Like VectorAsSet and VectorAsMap, but frozen with a small Eytzinger-ordered
+ * search index next to the sorted items (see EytzingerTableLayout in
+ * FrozenOrderedTable-inl.h). Lookups touch far fewer pages of the item array,
+ * which pays off for large tables that are mmapped rather than resident.
+ * Iteration order and the lookup API are the same as VectorAsMap's.
+ */
+template <class V>
+class VectorAsEytzingerSet : public VectorAsSet<V> {
+  using VectorAsSet<V>::VectorAsSet;
+};
+
+template <class K, class V>
+class VectorAsEytzingerMap : public VectorAsMap<K, V> {
+  using VectorAsMap<K, V>::VectorAsMap;
+};
+
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
@@ -110,5 +151,17 @@ THRIFT_DECLARE_TRAIT_TEMPLATE(
 THRIFT_DECLARE_TRAIT_TEMPLATE(
     IsHashSet,
     apache::thrift::frozen::VectorAsHashSet)
+THRIFT_DECLARE_TRAIT_TEMPLATE(
+    IsSwissHashMap,
+    apache::thrift::frozen::VectorAsSwissHashMap)
+THRIFT_DECLARE_TRAIT_TEMPLATE(
+    IsSwissHashSet,
+    apache::thrift::frozen::VectorAsSwissHashSet)
+THRIFT_DECLARE_TRAIT_TEMPLATE(
+    IsEytzingerMap,
+    apache::thrift::frozen::VectorAsEytzingerMap)
+THRIFT_DECLARE_TRAIT_TEMPLATE(
+    IsEytzingerSet,
+    apache::thrift::frozen::VectorAsEytzingerSet)
 THRIFT_DECLARE_TRAIT_TEMPLATE(IsOrderedMap, apache::thrift::frozen::VectorAsMap)
 THRIFT_DECLARE_TRAIT_TEMPLATE(IsOrderedSet, apache::thrift::frozen::VectorAsSet)
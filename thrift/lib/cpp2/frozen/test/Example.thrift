@@ -3,6 +3,7 @@ include "thrift/lib/cpp2/frozen/test/Helper.thrift"
 namespace cpp2 apache.thrift.test
 
 cpp_include "<unordered_set>"
+cpp_include "thrift/lib/cpp2/frozen/HintTypes.h"
 cpp_include "thrift/lib/cpp2/frozen/VectorAssociative.h"
 
 enum Gender {
@@ -86,4 +87,15 @@ struct VectorTest {
        aHashSet;
   5: map<i32, i32> (cpp.template = "apache::thrift::frozen::VectorAsHashMap")
        aHashMap;
+  6: set<i32>
+       (cpp.template = "apache::thrift::frozen::VectorAsSwissHashSet")
+       aSwissHashSet;
+  7: map<i32, i32>
+       (cpp.template = "apache::thrift::frozen::VectorAsSwissHashMap")
+       aSwissHashMap;
+}
+
+struct Place {
+  1: i32 id;
+  2: string (cpp.type = "apache::thrift::frozen::InternedString") country;
 }
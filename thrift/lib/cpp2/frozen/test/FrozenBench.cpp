@@ -17,6 +17,7 @@
 #include <folly/Random.h>
 #include <thrift/lib/cpp2/frozen/FrozenUtil.h>
 #include <thrift/lib/cpp2/frozen/HintTypes.h>
+#include <thrift/lib/cpp2/frozen/VectorAssociative.h>
 #include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_layouts.h>
 #include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_types.h>
 
@@ -94,6 +95,7 @@ auto fvvi64 = freeze(vvi64);
 auto fuvvi16 = freeze(makeMatrix<int16_t, VectorUnpacked<int16_t>>());
 auto fuvvi32 = freeze(makeMatrix<int32_t, VectorUnpacked<int32_t>>());
 auto fuvvi64 = freeze(makeMatrix<int64_t, VectorUnpacked<int64_t>>());
+auto fbvvi64 = freeze(makeMatrix<int64_t, VectorBlockPacked<int64_t>>());
 auto vvf32 = makeMatrix<float>();
 auto fvvf32 = freeze(vvf32);
 
@@ -106,6 +108,7 @@ BENCHMARK_RELATIVE_PARAM(benchmarkSum, fuvvi32)
 BENCHMARK_PARAM(benchmarkSum, vvi64)
 BENCHMARK_RELATIVE_PARAM(benchmarkSum, fvvi64)
 BENCHMARK_RELATIVE_PARAM(benchmarkSum, fuvvi64)
+BENCHMARK_RELATIVE_PARAM(benchmarkSum, fbvvi64)
 BENCHMARK_PARAM(benchmarkSum, vvf32)
 BENCHMARK_RELATIVE_PARAM(benchmarkSum, fvvf32)
 BENCHMARK_DRAW_LINE();
@@ -194,6 +197,22 @@ BENCHMARK_RELATIVE_PARAM(benchmarkLookup, frozenHashMap_str)
 
 BENCHMARK_DRAW_LINE();
 
+auto swissHashMap_i32 = freeze(
+    VectorAsSwissHashMap<int32_t, int>(hashMap_i32.begin(), hashMap_i32.end()));
+auto swissHashMap_i64 = freeze(
+    VectorAsSwissHashMap<int64_t, int>(hashMap_i64.begin(), hashMap_i64.end()));
+auto swissHashMap_str = freeze(VectorAsSwissHashMap<std::string, int>(
+    hashMap_str.begin(), hashMap_str.end()));
+
+BENCHMARK_PARAM(benchmarkLookup, frozenHashMap_i32)
+BENCHMARK_RELATIVE_PARAM(benchmarkLookup, swissHashMap_i32)
+BENCHMARK_PARAM(benchmarkLookup, frozenHashMap_i64)
+BENCHMARK_RELATIVE_PARAM(benchmarkLookup, swissHashMap_i64)
+BENCHMARK_PARAM(benchmarkLookup, frozenHashMap_str)
+BENCHMARK_RELATIVE_PARAM(benchmarkLookup, swissHashMap_str)
+
+BENCHMARK_DRAW_LINE();
+
 auto map_f32 = std::map<float, int>(hashMap_f32.begin(), hashMap_f32.end());
 auto map_i32 = std::map<int32_t, int>(hashMap_i32.begin(), hashMap_i32.end());
 auto map_i64 = std::map<int64_t, int>(hashMap_i64.begin(), hashMap_i64.end());
@@ -210,6 +229,18 @@ BENCHMARK_RELATIVE_PARAM(benchmarkLookup, frozenMap_i64)
 
 BENCHMARK_DRAW_LINE();
 
+auto eytzingerMap_i32 = freeze(
+    VectorAsEytzingerMap<int32_t, int>(map_i32.begin(), map_i32.end()));
+auto eytzingerMap_i64 = freeze(
+    VectorAsEytzingerMap<int64_t, int>(map_i64.begin(), map_i64.end()));
+
+BENCHMARK_PARAM(benchmarkLookup, frozenMap_i32)
+BENCHMARK_RELATIVE_PARAM(benchmarkLookup, eytzingerMap_i32)
+BENCHMARK_PARAM(benchmarkLookup, frozenMap_i64)
+BENCHMARK_RELATIVE_PARAM(benchmarkLookup, eytzingerMap_i64)
+
+BENCHMARK_DRAW_LINE();
+
 template <class T>
 void benchmarkOldFreezeDataToString(size_t iters, const T& data) {
   const auto layout = maximumLayout<T>();
@@ -13,9 +13,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <limits>
+
 #include <folly/portability/GTest.h>
 
 #include <thrift/lib/cpp2/frozen/FrozenTestUtil.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
 #include <thrift/lib/cpp2/frozen/HintTypes.h>
 
 namespace apache {
@@ -32,6 +35,91 @@ TEST(FrozenVectorTypes, Unpacked) {
   const int* raw = fiu.begin();
   EXPECT_EQ(raw[3], 7);
 }
+
+TEST(FrozenVectorTypes, BlockPacked) {
+  VectorBlockPacked<int64_t> ts;
+  std::vector<int64_t> plain;
+  int64_t t = 1500000000000;
+  for (int i = 0; i < 1000; ++i) {
+    t += i % 7;
+    ts.push_back(t);
+  }
+  plain.assign(ts.begin(), ts.end());
+  EXPECT_LT(frozenSize(ts) * 3, frozenSize(plain));
+
+  auto fts = freeze(ts);
+  ASSERT_EQ(ts.size(), fts.size());
+  for (size_t i = 0; i < ts.size(); ++i) {
+    EXPECT_EQ(ts[i], fts[i]);
+  }
+  EXPECT_TRUE(std::equal(ts.begin(), ts.end(), fts.begin()));
+  EXPECT_TRUE(std::is_sorted(fts.begin(), fts.end()));
+  EXPECT_EQ(ts.back(), fts.back());
+  EXPECT_EQ(ts, fts.thaw());
+}
+
+TEST(FrozenVectorTypes, BlockPackedWidths) {
+  // Negative values, full-width ranges and constant blocks.
+  VectorBlockPacked<int32_t> v;
+  for (int i = 0; i < 128; ++i) {
+    v.push_back(-i);
+  }
+  v.push_back(std::numeric_limits<int32_t>::min());
+  v.push_back(std::numeric_limits<int32_t>::max());
+  for (int i = 0; i < 200; ++i) {
+    v.push_back(42);
+  }
+  auto fv = freeze(v);
+  ASSERT_EQ(v.size(), fv.size());
+  for (size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(v[i], fv[i]);
+  }
+  EXPECT_EQ(v, fv.thaw());
+
+  VectorBlockPacked<uint64_t> empty;
+  auto fe = freeze(empty);
+  EXPECT_TRUE(fe.empty());
+  EXPECT_EQ(fe.begin(), fe.end());
+}
+
+namespace {
+template <class S>
+std::vector<S> makeCountries() {
+  std::vector<S> countries;
+  for (int i = 0; i < 1000; ++i) {
+    countries.push_back(i % 3 ? "United States" : "United Kingdom");
+  }
+  countries.push_back("");
+  countries.push_back("Ireland");
+  return countries;
+}
+} // namespace
+
+TEST(FrozenStringTypes, Interned) {
+  auto plain = makeCountries<std::string>();
+  auto interned = makeCountries<InternedString>();
+  EXPECT_LT(frozenSize(interned) * 3, frozenSize(plain));
+
+  auto fi = freeze(interned);
+  ASSERT_EQ(plain.size(), fi.size());
+  for (size_t i = 0; i < plain.size(); ++i) {
+    EXPECT_EQ(plain[i], fi[i]);
+  }
+  EXPECT_EQ(fi[1].begin(), fi[2].begin());
+  EXPECT_EQ(interned, fi.thaw());
+}
+
+TEST(FrozenStringTypes, InternedMalloc) {
+  // MallocFreezer writes to separate segments, so back references span them.
+  auto interned = makeCountries<InternedString>();
+  std::string frozen;
+  freezeToStringMalloc(interned, frozen);
+  auto fi = mapFrozen<std::vector<InternedString>>(frozen);
+  ASSERT_EQ(interned.size(), fi.size());
+  for (size_t i = 0; i < interned.size(); ++i) {
+    EXPECT_EQ(interned[i], fi[i]);
+  }
+}
 } // namespace frozen
 } // namespace thrift
 } // namespace apache
@@ -17,8 +17,11 @@
 #include <folly/portability/GTest.h>
 
 #include <thrift/lib/cpp2/frozen/Frozen.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <thrift/lib/cpp2/frozen/test/gen-cpp2/Binary_layouts.h>
 
+using namespace apache::thrift;
 using namespace apache::thrift::frozen;
 using namespace apache::thrift::test;
 using namespace folly;
@@ -56,3 +59,49 @@ TEST(FrozenIOBuf, IOBufChain) {
   EXPECT_TRUE(combined.startsWith(testRange));
   EXPECT_TRUE(combined.endsWith(test2Range));
 }
+
+TEST(FrozenIOBuf, FreezeToIOBuf) {
+  std::vector<std::string> original{"hello", "world", ""};
+  auto buf = freezeToIOBuf(original);
+  EXPECT_FALSE(buf->isChained());
+
+  std::string str;
+  freezeToString(original, str);
+  EXPECT_EQ(str, buf->moveToFbString().toStdString());
+}
+
+TEST(FrozenIOBuf, MapFromPayload) {
+  // Send a frozen vector as a binary field and map it without thawing.
+  std::vector<std::string> original;
+  for (int i = 0; i < 100; ++i) {
+    original.push_back(std::string(i, 'a' + i % 26));
+  }
+  Binaries response;
+  response.iobuf = freezeToIOBuf(original);
+
+  IOBufQueue queue;
+  CompactSerializer::serialize(response, &queue);
+  auto wire = queue.move();
+  wire->coalesce();
+
+  Binaries received;
+  CompactSerializer::deserialize(
+      wire.get(), received, ExternalBufferSharing::SHARE_EXTERNAL_BUFFER);
+  const byte* payload = received.iobuf->data();
+  EXPECT_GE(payload, wire->data());
+  EXPECT_LT(payload, wire->tail());
+
+  auto mapped = mapFrozen<std::vector<std::string>>(std::move(received.iobuf));
+  ASSERT_EQ(original.size(), mapped.size());
+  EXPECT_EQ(std::string(27, 'b'), mapped[27]);
+  EXPECT_EQ(original, mapped.thaw());
+}
+
+TEST(FrozenIOBuf, MapFromChain) {
+  std::vector<int64_t> original{1, -2, 3000000000};
+  auto buf = freezeToIOBuf(original);
+  auto head = IOBuf::copyBuffer(buf->data(), 3);
+  head->prependChain(IOBuf::copyBuffer(buf->data() + 3, buf->length() - 3));
+  auto mapped = mapFrozen<std::vector<int64_t>>(std::move(head));
+  EXPECT_EQ(original, mapped.thaw());
+}
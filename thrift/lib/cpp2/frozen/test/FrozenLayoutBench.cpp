@@ -0,0 +1,380 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Workload benchmarks for frozen layouts: point lookups, range scans, nested
+ * field access through views and thawing, over generated datasets. Prints
+ * time and (where perf counters are available) cache misses per operation,
+ * along with the frozen size of each layout, e.g.
+ *
+ *   frozen_layout_bench --entries=100000000 --distribution=zipf
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Random.h>
+#include <folly/hash/Hash.h>
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+#include <thrift/lib/cpp2/frozen/VectorAssociative.h>
+#include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_layouts.h>
+#include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_types.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+DEFINE_uint64(entries, 1000000, "Number of entries in each table");
+DEFINE_uint64(probes, 1000000, "Number of operations per measurement");
+DEFINE_string(distribution, "uniform", "Key distribution: uniform or zipf");
+DEFINE_double(zipf_skew, 0.99, "Skew of the zipf distribution");
+DEFINE_uint64(scan_length, 100, "Items visited per range scan");
+DEFINE_uint64(people, 100000, "Number of structs for nested access and thaw");
+
+using namespace apache::thrift;
+using namespace apache::thrift::frozen;
+using namespace apache::thrift::test;
+
+namespace {
+
+/**
+ * Counts hardware cache misses of this thread, where perf_event_open() is
+ * available and permitted.
+ */
+class CacheMissCounter {
+ public:
+  CacheMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~CacheMissCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+
+  bool available() const {
+    return fd_ >= 0;
+  }
+
+  void start() {
+#ifdef __linux__
+    if (available()) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  uint64_t stop() {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (available()) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+ private:
+  int fd_{-1};
+};
+
+CacheMissCounter& cacheMisses() {
+  static CacheMissCounter counter;
+  return counter;
+}
+
+/**
+ * Times 'ops' operations performed by 'run' and prints a result row. 'bytes'
+ * is the frozen size of the layout, or zero for unfrozen containers.
+ */
+void measure(
+    const char* workload,
+    const char* layout,
+    size_t bytes,
+    size_t ops,
+    const std::function<int64_t()>& run) {
+  folly::doNotOptimizeAway(run()); // warm up
+  cacheMisses().start();
+  auto start = std::chrono::steady_clock::now();
+  int64_t result = run();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  uint64_t misses = cacheMisses().stop();
+  folly::doNotOptimizeAway(result);
+
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  std::string missText = cacheMisses().available()
+      ? folly::sformat("{:.2f}", double(misses) / ops)
+      : "-";
+  std::string sizeText = bytes ? folly::to<std::string>(bytes) : "-";
+  printf(
+      "%-10s %-24s %12.1f %14s %16s\n",
+      workload,
+      layout,
+      ns / ops,
+      missText.c_str(),
+      sizeText.c_str());
+}
+
+// Distinct keys, in an order unrelated to their values.
+std::vector<int64_t> makeKeys(size_t n) {
+  std::vector<int64_t> keys(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = static_cast<int64_t>(folly::hash::twang_mix64(i));
+  }
+  return keys;
+}
+
+/**
+ * Draws ranks in [0, n): uniformly, or approximately following Zipf's law
+ * (inverting the CDF of the continuous power law), where rank 0 is hottest.
+ */
+size_t drawRank(size_t n) {
+  if (FLAGS_distribution == "uniform") {
+    return folly::Random::rand64(n);
+  }
+  if (FLAGS_distribution != "zipf") {
+    throw std::invalid_argument("Unknown distribution " + FLAGS_distribution);
+  }
+  double s = FLAGS_zipf_skew;
+  double u = folly::Random::randDouble01();
+  double rank = std::abs(s - 1) < 1e-9
+      ? std::exp(u * std::log(double(n)))
+      : std::pow(u * (std::pow(double(n), 1 - s) - 1) + 1, 1 / (1 - s));
+  return std::min(n - 1, static_cast<size_t>(std::max(1.0, rank)) - 1);
+}
+
+// Keys to look up; since 'keys' is unordered, hot keys are spread out.
+std::vector<int64_t> makeProbes(const std::vector<int64_t>& keys) {
+  std::vector<int64_t> probes(FLAGS_probes);
+  for (auto& probe : probes) {
+    probe = keys[drawRank(keys.size())];
+  }
+  return probes;
+}
+
+int64_t valueOf(const std::pair<const int64_t, int64_t>& item) {
+  return item.second;
+}
+
+template <class View>
+auto valueOf(const View& item) -> decltype(item.second()) {
+  return item.second();
+}
+
+template <class Map>
+std::function<int64_t()> lookups(
+    const Map& map,
+    const std::vector<int64_t>& probes) {
+  return [&map, &probes] {
+    int64_t sum = 0;
+    for (auto key : probes) {
+      auto found = map.find(key);
+      if (found != map.end()) {
+        sum += valueOf(*found);
+      }
+    }
+    return sum;
+  };
+}
+
+template <class Map>
+std::function<int64_t()> scans(
+    const Map& map,
+    const std::vector<int64_t>& probes) {
+  return [&map, &probes] {
+    int64_t sum = 0;
+    for (auto key : probes) {
+      auto it = map.lower_bound(key);
+      for (size_t i = 0; i < FLAGS_scan_length && it != map.end(); ++i, ++it) {
+        sum += valueOf(*it);
+      }
+    }
+    return sum;
+  };
+}
+
+void benchmarkTables() {
+  auto keys = makeKeys(FLAGS_entries);
+  auto probes = makeProbes(keys);
+  std::vector<std::pair<int64_t, int64_t>> items;
+  items.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    items.emplace_back(keys[i], i);
+  }
+
+  {
+    std::unordered_map<int64_t, int64_t> hashMap(items.begin(), items.end());
+    measure(
+        "lookup", "unordered_map", 0, probes.size(), lookups(hashMap, probes));
+    auto frozen = freeze(hashMap);
+    measure(
+        "lookup",
+        "frozen hash",
+        frozenSize(hashMap),
+        probes.size(),
+        lookups(frozen, probes));
+  }
+  {
+    VectorAsSwissHashMap<int64_t, int64_t> swiss(items.begin(), items.end());
+    auto frozen = freeze(swiss);
+    measure(
+        "lookup",
+        "frozen swiss hash",
+        frozenSize(swiss),
+        probes.size(),
+        lookups(frozen, probes));
+  }
+
+  std::map<int64_t, int64_t> map(items.begin(), items.end());
+  auto frozenMap = freeze(map);
+  VectorAsEytzingerMap<int64_t, int64_t> eytzinger(items.begin(), items.end());
+  auto frozenEytzinger = freeze(eytzinger);
+  std::vector<int64_t> scanProbes(
+      probes.begin(),
+      probes.begin() + std::min<size_t>(probes.size(), 100000));
+
+  measure("lookup", "map", 0, probes.size(), lookups(map, probes));
+  measure(
+      "lookup",
+      "frozen sorted",
+      frozenSize(map),
+      probes.size(),
+      lookups(frozenMap, probes));
+  measure(
+      "lookup",
+      "frozen eytzinger",
+      frozenSize(eytzinger),
+      probes.size(),
+      lookups(frozenEytzinger, probes));
+  measure("scan", "map", 0, scanProbes.size(), scans(map, scanProbes));
+  measure(
+      "scan",
+      "frozen sorted",
+      frozenSize(map),
+      scanProbes.size(),
+      scans(frozenMap, scanProbes));
+  measure(
+      "scan",
+      "frozen eytzinger",
+      frozenSize(eytzinger),
+      scanProbes.size(),
+      scans(frozenEytzinger, scanProbes));
+}
+
+std::vector<Person1> makePeople(size_t n) {
+  std::vector<Person1> people(n);
+  for (size_t i = 0; i < n; ++i) {
+    auto& person = people[i];
+    person.name = folly::to<std::string>("person", i);
+    person.height = 1.5 + (i % 50) / 100.0;
+    person.age = i % 90;
+    person.__isset.age = true;
+    person.pets.resize(1 + i % 3);
+    for (auto& pet : person.pets) {
+      pet.name = folly::to<std::string>("pet", i);
+    }
+  }
+  return people;
+}
+
+void benchmarkStructs() {
+  auto people = makePeople(FLAGS_people);
+  std::vector<size_t> probes(FLAGS_probes);
+  for (auto& probe : probes) {
+    probe = drawRank(people.size());
+  }
+  auto frozen = freeze(people);
+
+  measure("nested", "vector<Person1>", 0, probes.size(), [&] {
+    int64_t sum = 0;
+    for (auto i : probes) {
+      sum += people[i].pets.back().name.size() + people[i].age;
+    }
+    return sum;
+  });
+  measure("nested", "frozen", frozenSize(people), probes.size(), [&] {
+    int64_t sum = 0;
+    for (auto i : probes) {
+      auto person = frozen[i];
+      sum += person.pets().back().name().size() + *person.age();
+    }
+    return sum;
+  });
+
+  std::vector<std::string> serialized;
+  for (size_t i = 0; i < std::min<size_t>(people.size(), 10000); ++i) {
+    serialized.push_back(CompactSerializer::serialize<std::string>(people[i]));
+  }
+  measure("thaw", "compact deserialize", 0, serialized.size(), [&] {
+    int64_t sum = 0;
+    for (auto& str : serialized) {
+      Person1 person;
+      CompactSerializer::deserialize(str, person);
+      sum += person.pets.size();
+    }
+    return sum;
+  });
+  measure("thaw", "frozen thaw", 0, serialized.size(), [&] {
+    int64_t sum = 0;
+    for (size_t i = 0; i < serialized.size(); ++i) {
+      sum += frozen[i].thaw().pets.size();
+    }
+    return sum;
+  });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  printf(
+      "%-10s %-24s %12s %14s %16s\n",
+      "workload",
+      "layout",
+      "ns/op",
+      "misses/op",
+      "frozen bytes");
+  benchmarkTables();
+  benchmarkStructs();
+  return 0;
+}
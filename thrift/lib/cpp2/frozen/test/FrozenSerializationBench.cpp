@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+#include <thrift/lib/cpp2/frozen/ParallelFreeze.h>
 #include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_layouts.h>
 #include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_types.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
@@ -111,6 +113,41 @@ BENCHMARK_RELATIVE(FrozenThaw, iters) {
   folly::doNotOptimizeAway(s);
 }
 
+BENCHMARK_DRAW_LINE();
+
+std::vector<EveryLayout> stressList = [] {
+  std::vector<EveryLayout> x(200000, stressValue2);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i].aInt = i;
+    x[i].aList.push_back(i * 3);
+    x[i].aMap[i] = i * 5;
+  }
+  return x;
+}();
+
+BENCHMARK(FrozenFreezeList, iters) {
+  size_t s = 0;
+  while (iters--) {
+    std::string out;
+    freezeToString(stressList, out);
+    s += out.size();
+  }
+  folly::doNotOptimizeAway(s);
+}
+
+BENCHMARK_RELATIVE(FrozenFreezeListParallel, iters) {
+  size_t s = 0;
+  folly::BenchmarkSuspender setup;
+  folly::CPUThreadPoolExecutor executor(8);
+  setup.dismiss();
+  while (iters--) {
+    std::string out;
+    freezeToStringParallel(stressList, out, &executor, 32);
+    s += out.size();
+  }
+  folly::doNotOptimizeAway(s);
+}
+
 #if 0
 ============================================================================
                                                 relative  time/iter  iters/s
@@ -47,6 +47,38 @@ TEST(FrozenUtil, FreezeAndMap) {
   EXPECT_NE(original, thawed);
 }
 
+TEST(FrozenUtil, MapWithOptions) {
+  std::vector<std::string> original;
+  for (int i = 0; i < 10000; ++i) {
+    original.push_back(std::string(i % 50, 'a' + i % 26));
+  }
+  folly::test::TemporaryFile tmp;
+  freezeToFile(original, folly::File(tmp.fd()));
+
+  MapFrozenStats stats;
+  MapFrozenOptions options;
+  options.populateThreads = 4;
+  options.hugePages = true;
+  options.access = FrozenAccess::Random;
+  options.lock = false;
+  options.stats = &stats;
+  auto mapped =
+      mapFrozen<std::vector<std::string>>(folly::File(tmp.fd()), options);
+  EXPECT_EQ(original, mapped.thaw());
+
+  struct stat fileStats;
+  fstat(tmp.fd(), &fileStats);
+  EXPECT_EQ(fileStats.st_size, stats.mappedBytes);
+  EXPECT_GE(stats.minorFaults, 0);
+#ifdef __linux__
+  EXPECT_EQ(stats.mappedBytes, stats.residentBytesAfter);
+#endif
+
+  // String payloads, from the first non-empty one.
+  folly::StringPiece payloads(mapped[1].begin(), mapped.back().end());
+  adviseFrozenRange(folly::ByteRange(payloads), FrozenAccess::Sequential);
+}
+
 TEST(FrozenUtil, FutureVersion) {
   folly::test::TemporaryFile tmp;
 
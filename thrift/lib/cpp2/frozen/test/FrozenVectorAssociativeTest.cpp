@@ -112,15 +112,144 @@ TEST(FrozenVectorTypes, VectorAsHashSet) {
   EXPECT_EQ(0, fdm.count(4));
 }
 
+TEST(FrozenVectorTypes, VectorAsSwissHashMap) {
+  VectorAsSwissHashMap<int, int> dm;
+  dm.insert({1, 2});
+  dm.insert(dm.end(), {3, 4});
+  auto fdm = freeze(dm);
+  EXPECT_EQ(2, fdm.at(1));
+  EXPECT_EQ(4, fdm.at(3));
+  {
+    auto found = fdm.find(3);
+    ASSERT_NE(found, fdm.end());
+    EXPECT_EQ(found->second(), 4);
+  }
+  {
+    auto found = fdm.find(2);
+    EXPECT_EQ(found, fdm.end());
+  }
+}
+
+TEST(FrozenVectorTypes, VectorAsSwissHashSet) {
+  VectorAsSwissHashSet<int> dm;
+  dm.insert(3);
+  dm.insert(dm.end(), 7);
+  auto fdm = freeze(dm);
+  EXPECT_EQ(1, fdm.count(3));
+  EXPECT_EQ(1, fdm.count(7));
+  EXPECT_EQ(0, fdm.count(4));
+}
+
+TEST(FrozenVectorTypes, VectorAsSwissHashMapLarge) {
+  // Enough entries for many groups and long probe sequences.
+  VectorAsSwissHashMap<int64_t, std::string> dm;
+  for (int64_t i = 0; i < 10000; ++i) {
+    dm.insert({i * 64, folly::to<std::string>(i)});
+  }
+  auto fdm = freeze(dm);
+  EXPECT_EQ(10000, fdm.size());
+  for (int64_t i = 0; i < 10000; ++i) {
+    EXPECT_EQ(folly::to<std::string>(i), fdm.at(i * 64));
+    EXPECT_EQ(0, fdm.count(i * 64 + 1));
+  }
+
+  auto thawed = fdm.thaw();
+  std::sort(thawed.begin(), thawed.end());
+  std::sort(dm.begin(), dm.end());
+  EXPECT_EQ(dm, thawed);
+}
+
+TEST(FrozenVectorTypes, SwissHashMapFreezesDeterministically) {
+  VectorAsSwissHashMap<int64_t, int64_t> dm;
+  for (int64_t i = 0; i < 100; ++i) {
+    dm.insert({i, i * i});
+  }
+  std::string first;
+  std::string second;
+  freezeToString(dm, first);
+  freezeToString(dm, second);
+  EXPECT_EQ(first, second);
+}
+
+TEST(FrozenVectorTypes, EmptySwissHashMap) {
+  VectorAsSwissHashMap<int, int> dm;
+  auto fdm = freeze(dm);
+  EXPECT_EQ(0, fdm.size());
+  EXPECT_EQ(fdm.end(), fdm.find(1));
+}
+
+TEST(FrozenVectorTypes, VectorAsEytzingerMap) {
+  VectorAsEytzingerMap<int, int> dm;
+  dm.insert({3, 4});
+  dm.insert(dm.end(), {1, 2});
+  auto fdm = freeze(dm);
+  EXPECT_EQ(2, fdm.at(1));
+  EXPECT_EQ(4, fdm.at(3));
+  EXPECT_EQ(1, fdm.begin()->first());
+  {
+    auto found = fdm.find(3);
+    ASSERT_NE(found, fdm.end());
+    EXPECT_EQ(found->second(), 4);
+  }
+  {
+    auto found = fdm.find(2);
+    EXPECT_EQ(found, fdm.end());
+  }
+}
+
+TEST(FrozenVectorTypes, VectorAsEytzingerSet) {
+  VectorAsEytzingerSet<std::string> dm{"pear", "apple", "fig"};
+  auto fdm = freeze(dm);
+  EXPECT_EQ(1, fdm.count("fig"));
+  EXPECT_EQ(0, fdm.count("kiwi"));
+  EXPECT_EQ("apple", *fdm.begin());
+  EXPECT_EQ("fig", *fdm.lower_bound("banana"));
+  EXPECT_EQ(fdm.end(), fdm.upper_bound("pear"));
+}
+
+TEST(FrozenVectorTypes, VectorAsEytzingerSetBounds) {
+  // Sizes around block and tree boundaries.
+  for (int size : {0, 1, 15, 16, 17, 33, 100, 1000, 4097}) {
+    VectorAsEytzingerSet<int> dm;
+    for (int i = size - 1; i >= 0; --i) {
+      dm.insert(i * 2);
+    }
+    auto fdm = freeze(dm);
+    ASSERT_EQ(size_t(size), fdm.size());
+    std::sort(dm.begin(), dm.end());
+    EXPECT_TRUE(std::equal(dm.begin(), dm.end(), fdm.begin()));
+    for (int key = -1; key <= size * 2; ++key) {
+      auto expectedLower = std::lower_bound(dm.begin(), dm.end(), key);
+      auto expectedUpper = std::upper_bound(dm.begin(), dm.end(), key);
+      EXPECT_EQ(
+          expectedLower - dm.begin(), fdm.lower_bound(key) - fdm.begin())
+          << "size " << size << " key " << key;
+      EXPECT_EQ(
+          expectedUpper - dm.begin(), fdm.upper_bound(key) - fdm.begin())
+          << "size " << size << " key " << key;
+      EXPECT_EQ(key >= 0 && key % 2 == 0 ? 1 : 0, fdm.count(key));
+    }
+    EXPECT_EQ(dm, fdm.thaw());
+  }
+}
+
 TEST(FrozenVectorTypes, DistinctChecking) {
   VectorAsHashMap<int, int> hm{{1, 2}, {1, 3}};
   VectorAsHashSet<int> hs{4, 4};
   VectorAsMap<int, int> om{{5, 6}, {5, 7}};
   VectorAsSet<int> os{8, 8};
+  VectorAsSwissHashMap<int, int> shm{{1, 2}, {1, 3}};
+  VectorAsSwissHashSet<int> shs{4, 4};
+  VectorAsEytzingerMap<int, int> em{{5, 6}, {5, 7}};
+  VectorAsEytzingerSet<int> es{8, 8};
   EXPECT_THROW(freeze(hm), std::domain_error);
   EXPECT_THROW(freeze(hs), std::domain_error);
   EXPECT_THROW(freeze(om), std::domain_error);
   EXPECT_THROW(freeze(os), std::domain_error);
+  EXPECT_THROW(freeze(shm), std::domain_error);
+  EXPECT_THROW(freeze(shs), std::domain_error);
+  EXPECT_THROW(freeze(em), std::domain_error);
+  EXPECT_THROW(freeze(es), std::domain_error);
 }
 
 TEST(FrozenVectorTypes, DistinctCheckingShouldPass) {
@@ -145,6 +274,8 @@ void populate(TestType& x) {
   x.aMap[3] = 4;
   x.aHashSet.insert(5);
   x.aHashMap[6] = 7;
+  x.aSwissHashSet.insert(8);
+  x.aSwissHashMap[9] = 10;
 }
 
 template <class T>
@@ -172,6 +303,10 @@ TYPED_TEST_P(FrozenStructsWithVectors, Freezable) {
   EXPECT_EQ(f.aHashSet().count(6), 0);
   EXPECT_EQ(f.aHashMap().getDefault(6, 9), 7);
   EXPECT_EQ(f.aHashMap().getDefault(7, 9), 9);
+  EXPECT_EQ(f.aSwissHashSet().count(8), 1);
+  EXPECT_EQ(f.aSwissHashSet().count(9), 0);
+  EXPECT_EQ(f.aSwissHashMap().getDefault(9, 0), 10);
+  EXPECT_EQ(f.aSwissHashMap().getDefault(10, 0), 0);
 }
 
 REGISTER_TYPED_TEST_CASE_P(FrozenStructsWithVectors, Freezable, Serializable);
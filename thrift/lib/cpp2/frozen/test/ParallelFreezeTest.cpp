@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/InlineExecutor.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+#include <thrift/lib/cpp2/frozen/ParallelFreeze.h>
+#include <thrift/lib/cpp2/frozen/test/gen-cpp2/Example_layouts.h>
+
+using namespace apache::thrift;
+using namespace frozen;
+
+namespace {
+
+// Freezes 'x' in parallel and checks it maps back to the same value.
+template <class T>
+void checkParallel(
+    const std::vector<T>& x,
+    folly::Executor* executor,
+    size_t numShards) {
+  std::string parallel;
+  freezeToStringParallel(x, parallel, executor, numShards);
+  auto mapped = mapFrozen<std::vector<T>>(std::move(parallel));
+  ASSERT_EQ(x.size(), mapped.size());
+  EXPECT_EQ(x, mapped.thaw());
+}
+
+std::string makeString(size_t i) {
+  return std::string((i * 7) % 31, 'a' + i % 26);
+}
+
+} // namespace
+
+TEST(ParallelFreeze, Strings) {
+  folly::CPUThreadPoolExecutor executor(4);
+  std::vector<std::string> x;
+  for (size_t i = 0; i < 10000; ++i) {
+    x.push_back(makeString(i));
+  }
+  checkParallel(x, &executor, 4);
+  checkParallel(x, &executor, 37);
+}
+
+TEST(ParallelFreeze, InternedStrings) {
+  // Later items of a shard point back at the first copy of their country,
+  // which the layout must be able to reach from every one of them.
+  folly::CPUThreadPoolExecutor executor(4);
+  std::vector<test::Place> x;
+  for (size_t i = 0; i < 5000; ++i) {
+    test::Place place;
+    place.id = i;
+    place.country = i % 3 ? "United States" : makeString(i / 3);
+    x.push_back(std::move(place));
+  }
+  checkParallel(x, &executor, 4);
+  checkParallel(x, &executor, 37);
+
+  std::string parallel;
+  freezeToStringParallel(x, parallel, &executor, 4);
+  auto mapped = mapFrozen<std::vector<test::Place>>(std::move(parallel));
+  EXPECT_EQ(mapped[1].country().begin(), mapped[2].country().begin());
+}
+
+TEST(ParallelFreeze, PackedInts) {
+  folly::CPUThreadPoolExecutor executor(4);
+  std::vector<int64_t> x;
+  for (size_t i = 0; i < 10001; ++i) {
+    x.push_back(int64_t(i * i) - 5000);
+  }
+  checkParallel(x, &executor, 8);
+}
+
+TEST(ParallelFreeze, LateGrowth) {
+  // Only the last shard needs wide fields; earlier shards must be frozen with
+  // the grown layout.
+  folly::InlineExecutor executor;
+  std::vector<std::vector<int32_t>> x(1000, std::vector<int32_t>{1, 2});
+  x.back().assign(500, 1 << 30);
+  checkParallel(x, &executor, 10);
+}
+
+TEST(ParallelFreeze, FewItems) {
+  folly::InlineExecutor executor;
+  checkParallel(std::vector<std::string>{}, &executor, 4);
+  checkParallel(std::vector<std::string>{"a", "bc"}, &executor, 4);
+}
+
+TEST(ParallelFreeze, TinyPackedItems) {
+  // An odd number of shards puts the first and the last one in the same
+  // wave, and tiny items leave shards with only a few bytes of slots and no
+  // data at all. Shards must still never rewrite each other's words, which
+  // is best checked with TSAN.
+  folly::CPUThreadPoolExecutor executor(8);
+  std::vector<uint8_t> bits;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < 64 * 37 + 5; ++i) {
+    bits.push_back(i % 3);
+    strings.push_back(i % 5 ? "" : "a");
+  }
+  for (int repeat = 0; repeat < 20; ++repeat) {
+    checkParallel(bits, &executor, 37);
+    checkParallel(strings, &executor, 37);
+  }
+}
+
+TEST(ParallelFreeze, Shards) {
+  auto shards = detail::makeListShards(300, 3);
+  ASSERT_EQ(3, shards.size());
+  EXPECT_EQ(0, shards[0].begin);
+  EXPECT_EQ(128, shards[0].end);
+  EXPECT_EQ(256, shards[2].begin);
+  EXPECT_EQ(300, shards[2].end);
+  EXPECT_EQ(2, detail::makeListShards(100, 3).size());
+  EXPECT_TRUE(detail::makeListShards(0, 3).empty());
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/frozen/FrozenUtil.h>
+#include <thrift/lib/cpp2/frozen/StreamingFreeze.h>
+
+using namespace apache::thrift;
+using namespace frozen;
+
+namespace {
+
+template <class T, class Gen>
+Layout<std::vector<T>> layoutAll(size_t count, Gen gen) {
+  StreamingLayout<T> layout(count);
+  do {
+    layout.begin();
+    for (size_t i = 0; i < count; ++i) {
+      layout.add(gen(i));
+    }
+  } while (!layout.end());
+  return layout.layout();
+}
+
+template <class T, class Gen>
+void freezeAll(
+    const folly::test::TemporaryFile& tmp,
+    const Layout<std::vector<T>>& layout,
+    size_t count,
+    Gen gen,
+    size_t flushBytes = StreamingFreezeRoot::kDefaultFlushBytes) {
+  StreamingFreezer<T> freezer(
+      folly::File(tmp.fd()), layout, count, flushBytes);
+  for (size_t i = 0; i < count; ++i) {
+    freezer.add(gen(i));
+  }
+  freezer.finish();
+}
+
+std::string makeString(size_t i) {
+  return std::string(i % 13, 'a' + i % 26);
+}
+
+} // namespace
+
+TEST(StreamingFreeze, Strings) {
+  const size_t n = 1000;
+  folly::test::TemporaryFile tmp;
+  freezeAll<std::string>(
+      tmp, layoutAll<std::string>(n, makeString), n, makeString, 256);
+
+  auto mapped = mapFrozen<std::vector<std::string>>(folly::File(tmp.fd()));
+  ASSERT_EQ(n, mapped.size());
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(makeString(i), mapped[i]);
+  }
+}
+
+TEST(StreamingFreeze, MatchesFreezeToFile) {
+  std::vector<std::string> original;
+  for (size_t i = 0; i < 100; ++i) {
+    original.push_back(makeString(i));
+  }
+  folly::test::TemporaryFile streamed;
+  freezeAll<std::string>(
+      streamed,
+      layoutAll<std::string>(original.size(), makeString),
+      original.size(),
+      makeString);
+  auto mapped = mapFrozen<std::vector<std::string>>(folly::File(streamed.fd()));
+  EXPECT_EQ(original, mapped.thaw());
+
+  Layout<std::vector<std::string>> layout;
+  LayoutRoot::layout(original, layout);
+  std::ostringstream expected, actual;
+  expected << layout;
+  actual << layoutAll<std::string>(original.size(), makeString);
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(StreamingFreeze, PackedItemsAcrossWindows) {
+  // Bit-packed slots spanning several windows.
+  const size_t n = StreamingFreezer<int64_t>::kWindowItems * 2 + 77;
+  auto gen = [](size_t i) { return int64_t(i * 3) - 1000; };
+  folly::test::TemporaryFile tmp;
+  freezeAll<int64_t>(tmp, layoutAll<int64_t>(n, gen), n, gen);
+
+  auto mapped = mapFrozen<std::vector<int64_t>>(folly::File(tmp.fd()));
+  ASSERT_EQ(n, mapped.size());
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(gen(i), mapped[i]);
+  }
+}
+
+TEST(StreamingFreeze, Empty) {
+  auto gen = [](size_t) { return std::string(); };
+  folly::test::TemporaryFile tmp;
+  freezeAll<std::string>(tmp, layoutAll<std::string>(0, gen), 0, gen);
+  auto mapped = mapFrozen<std::vector<std::string>>(folly::File(tmp.fd()));
+  EXPECT_TRUE(mapped.empty());
+}
+
+TEST(StreamingFreeze, SampledLayoutTooSmall) {
+  std::vector<std::string> sample{"a", "b"};
+  Layout<std::vector<std::string>> layout;
+  LayoutRoot::layout(sample, layout);
+  folly::test::TemporaryFile tmp;
+  StreamingFreezer<std::string> freezer(folly::File(tmp.fd()), layout, 2);
+  freezer.add("a");
+  EXPECT_THROW(freezer.add(std::string(1000, 'x')), LayoutException);
+}
+
+TEST(StreamingFreeze, CountMismatch) {
+  StreamingLayout<int> layout(1);
+  layout.begin();
+  EXPECT_THROW(layout.end(), std::logic_error);
+  layout.add(1);
+  EXPECT_THROW(layout.add(2), std::out_of_range);
+}
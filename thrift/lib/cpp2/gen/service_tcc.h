@@ -56,7 +56,8 @@ std::unique_ptr<folly::IOBuf> process_serialize_xform_app_exn(
   queue.append(transport::THeader::transform(
       queue.move(),
       ctx->getHeader()->getWriteTransforms(),
-      ctx->getHeader()->getMinCompressBytes()));
+      ctx->getHeader()->getMinCompressBytes(),
+      ctx->getHeader()->getZstdDictionaryId()));
   return queue.move();
 }
 
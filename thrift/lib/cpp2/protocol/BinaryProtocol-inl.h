@@ -24,12 +24,63 @@
 
 #include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
 
+#include <cstring>
 #include <limits>
 #include <string>
+#include <type_traits>
 
 namespace apache {
 namespace thrift {
 
+namespace detail {
+namespace binary {
+
+template <size_t Size>
+struct FixedWidthBits;
+template <>
+struct FixedWidthBits<2> {
+  using type = uint16_t;
+};
+template <>
+struct FixedWidthBits<4> {
+  using type = uint32_t;
+};
+template <>
+struct FixedWidthBits<8> {
+  using type = uint64_t;
+};
+
+template <typename T>
+using fixed_width_bits_t = typename FixedWidthBits<sizeof(T)>::type;
+
+// Both loops below are kept branch-free over a contiguous range so that the
+// compiler turns them into vector byte shuffles.
+template <typename T>
+FOLLY_ALWAYS_INLINE void
+storeFixedArrayBE(uint8_t* out, const T* in, size_t size) {
+  using Bits = fixed_width_bits_t<T>;
+  for (size_t i = 0; i < size; ++i) {
+    Bits bits;
+    std::memcpy(&bits, &in[i], sizeof(bits));
+    folly::storeUnaligned(out + i * sizeof(bits), folly::Endian::big(bits));
+  }
+}
+
+// `in` may alias `out`, each element is loaded before it is overwritten.
+template <typename T>
+FOLLY_ALWAYS_INLINE void
+loadFixedArrayBE(T* out, const uint8_t* in, size_t size) {
+  using Bits = fixed_width_bits_t<T>;
+  for (size_t i = 0; i < size; ++i) {
+    Bits bits = folly::Endian::big(
+        folly::loadUnaligned<Bits>(in + i * sizeof(bits)));
+    std::memcpy(&out[i], &bits, sizeof(bits));
+  }
+}
+
+} // namespace binary
+} // namespace detail
+
 uint32_t BinaryProtocolWriter::writeMessageBegin(
     const std::string& name,
     MessageType messageType,
@@ -209,6 +260,22 @@ uint32_t BinaryProtocolWriter::writeSerializedData(
   return buf->computeChainDataLength();
 }
 
+template <typename T>
+uint32_t BinaryProtocolWriter::writeFixedArray(const T* data, size_t size) {
+  static_assert(
+      std::is_arithmetic<T>::value && sizeof(T) > 1,
+      "writeFixedArray() only supports multi-byte numeric types");
+
+  if (size > std::numeric_limits<uint32_t>::max() / sizeof(T)) {
+    TProtocolException::throwExceededSizeLimit();
+  }
+  size_t bytes = size * sizeof(T);
+  out_.ensure(bytes);
+  detail::binary::storeFixedArrayBE(out_.writableData(), data, size);
+  out_.append(bytes);
+  return bytes;
+}
+
 /**
  * Functions that return the serialized size
  */
@@ -547,6 +614,25 @@ void BinaryProtocolReader::readBinary(folly::IOBuf& str) {
   }
 }
 
+template <typename T>
+void BinaryProtocolReader::readFixedArray(T* data, size_t size) {
+  static_assert(
+      std::is_arithmetic<T>::value && sizeof(T) > 1,
+      "readFixedArray() only supports multi-byte numeric types");
+
+  size_t bytes = size * sizeof(T);
+  if (LIKELY(in_.length() >= bytes)) {
+    detail::binary::loadFixedArrayBE(data, in_.data(), size);
+    in_.skipNoAdvance(bytes);
+  } else {
+    // Spans several IOBufs: gather the raw bytes first, then swap in place.
+    // pull() throws if the input is too short, just like readI64() would.
+    in_.pull(data, bytes);
+    detail::binary::loadFixedArrayBE(
+        data, reinterpret_cast<const uint8_t*>(data), size);
+  }
+}
+
 template <typename StrType>
 void BinaryProtocolReader::readStringBody(StrType& str, int32_t size) {
   checkStringSize(size);
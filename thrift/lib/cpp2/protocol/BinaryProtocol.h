@@ -109,6 +109,15 @@ class BinaryProtocolWriter {
   inline uint32_t writeSerializedData(
       const std::unique_ptr<folly::IOBuf>& data);
 
+  /**
+   * Writes `size` fixed-width numbers (i16/i32/i64/float/double) back to back,
+   * byte-swapping them into a single contiguous region of the output. The
+   * result is identical to calling writeI64() etc. once per element; the
+   * caller is still responsible for writeListBegin()/writeSetBegin().
+   */
+  template <typename T>
+  inline uint32_t writeFixedArray(const T* data, size_t size);
+
   /**
    * Functions that return the [estimated] serialized size
    * Notes:
@@ -258,6 +267,14 @@ class BinaryProtocolReader {
   inline void readBinary(StrType& str);
   inline void readBinary(std::unique_ptr<folly::IOBuf>& str);
   inline void readBinary(folly::IOBuf& str);
+
+  /**
+   * Reads `size` fixed-width numbers written by writeFixedArray() (or by the
+   * equivalent sequence of writeI64() etc.) with a single bounds check.
+   */
+  template <typename T>
+  inline void readFixedArray(T* data, size_t size);
+
   bool peekMap() {
     return false;
   }
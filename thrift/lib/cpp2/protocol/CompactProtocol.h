@@ -168,6 +168,14 @@ class CompactProtocolWriter {
     return 0;
   }
 
+  /**
+   * Writes `size` integers exactly as the same number of writeI32()/writeI64()
+   * calls would, but reserves output space once per batch of elements rather
+   * than once per element.
+   */
+  inline uint32_t writeVarintArray(const int32_t* data, size_t size);
+  inline uint32_t writeVarintArray(const int64_t* data, size_t size);
+
   /**
    * Functions that return the serialized size
    *
@@ -329,6 +337,15 @@ class CompactProtocolReader {
   inline void readBinary(StrType& str);
   inline void readBinary(std::unique_ptr<IOBuf>& str);
   inline void readBinary(IOBuf& str);
+
+  /**
+   * Reads `size` integers written by writeVarintArray() or by the equivalent
+   * sequence of writeI32()/writeI64(). Runs of single-byte varints are
+   * decoded in bulk.
+   */
+  inline void readVarintArray(int32_t* data, size_t size);
+  inline void readVarintArray(int64_t* data, size_t size);
+
   void skip(TType type) {
     apache::thrift::skip(*this, type);
   }
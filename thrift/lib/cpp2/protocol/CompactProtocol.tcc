@@ -91,6 +91,29 @@ const TType CTypeToTType[14] = {
     TType::T_FLOAT, // CT_FLOAT
 };
 
+// Number of elements zigzag-encoded per writeVarintArray() batch; bounds the
+// output space reserved at once to 256 * 10 bytes.
+constexpr size_t kVarintArrayBatchSize = 256;
+
+template <typename T, typename Zigzag>
+uint32_t writeZigzagVarintArray(
+    QueueAppender& out,
+    const T* data,
+    size_t size,
+    Zigzag toZigzag) {
+  using Encoded = decltype(toZigzag(T()));
+  Encoded encoded[kVarintArrayBatchSize];
+  uint32_t wsize = 0;
+  for (size_t i = 0; i < size; i += kVarintArrayBatchSize) {
+    size_t n = std::min(kVarintArrayBatchSize, size - i);
+    for (size_t j = 0; j < n; ++j) {
+      encoded[j] = toZigzag(data[i + j]);
+    }
+    wsize += apache::thrift::util::writeVarintArray(out, encoded, n);
+  }
+  return wsize;
+}
+
 } // namespace compact
 } // namespace detail
 
@@ -271,6 +294,24 @@ uint32_t CompactProtocolWriter::writeI64(int64_t i64) {
       out_, apache::thrift::util::i64ToZigzag(i64));
 }
 
+uint32_t CompactProtocolWriter::writeVarintArray(
+    const int32_t* data,
+    size_t size) {
+  return detail::compact::writeZigzagVarintArray(
+      out_, data, size, [](int32_t v) {
+        return apache::thrift::util::i32ToZigzag(v);
+      });
+}
+
+uint32_t CompactProtocolWriter::writeVarintArray(
+    const int64_t* data,
+    size_t size) {
+  return detail::compact::writeZigzagVarintArray(
+      out_, data, size, [](int64_t v) {
+        return apache::thrift::util::i64ToZigzag(v);
+      });
+}
+
 uint32_t CompactProtocolWriter::writeDouble(double dub) {
   static_assert(sizeof(double) == sizeof(uint64_t), "");
   static_assert(std::numeric_limits<double>::is_iec559, "");
@@ -646,6 +687,20 @@ void CompactProtocolReader::readI64(int64_t& i64) {
   i64 = apache::thrift::util::zigzagToI64(value);
 }
 
+void CompactProtocolReader::readVarintArray(int32_t* data, size_t size) {
+  apache::thrift::util::readVarintArray(in_, data, size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = apache::thrift::util::zigzagToI32(data[i]);
+  }
+}
+
+void CompactProtocolReader::readVarintArray(int64_t* data, size_t size) {
+  apache::thrift::util::readVarintArray(in_, data, size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = apache::thrift::util::zigzagToI64(static_cast<uint64_t>(data[i]));
+  }
+}
+
 void CompactProtocolReader::readDouble(double& dub) {
   static_assert(sizeof(double) == sizeof(uint64_t), "");
   static_assert(std::numeric_limits<double>::is_iec559, "");
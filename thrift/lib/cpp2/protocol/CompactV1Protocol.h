@@ -61,6 +61,7 @@ class CompactV1ProtocolWriter : protected CompactProtocolWriter {
   using CompactProtocolWriter::writeSetEnd;
   using CompactProtocolWriter::writeStructBegin;
   using CompactProtocolWriter::writeStructEnd;
+  using CompactProtocolWriter::writeVarintArray;
   inline uint32_t writeDouble(double dub);
   using CompactProtocolWriter::writeBinary;
   using CompactProtocolWriter::writeFloat;
@@ -122,6 +123,7 @@ class CompactV1ProtocolReader : protected CompactProtocolReader {
   using CompactProtocolReader::readSetEnd;
   using CompactProtocolReader::readStructBegin;
   using CompactProtocolReader::readStructEnd;
+  using CompactProtocolReader::readVarintArray;
   inline void readDouble(double& dub);
   using CompactProtocolReader::peekList;
   using CompactProtocolReader::peekMap;
@@ -298,8 +298,19 @@ uint32_t JSONProtocolWriterCommon::writeJSONString(folly::StringPiece str) {
   uint32_t ret = 2;
 
   out_.write(detail::json::kJSONStringDelimiter);
-  for (auto c : str) {
-    ret += writeJSONChar(c);
+  folly::ByteRange rest(str);
+  while (!rest.empty()) {
+    // Copy runs of plain characters in bulk, escaping the ones between them.
+    auto plain = detail::json::unescapedPrefixLength(rest);
+    if (plain) {
+      out_.push(rest.data(), plain);
+      rest.advance(plain);
+      ret += plain;
+    }
+    if (!rest.empty()) {
+      ret += writeJSONChar(rest.front());
+      rest.advance(1);
+    }
   }
   out_.write(detail::json::kJSONStringDelimiter);
 
@@ -310,25 +321,16 @@ uint32_t JSONProtocolWriterCommon::writeJSONBase64(folly::ByteRange v) {
   uint32_t ret = 2;
 
   out_.write(detail::json::kJSONStringDelimiter);
-  auto bytes = v.data();
-  auto len = v.size();
-  uint8_t b[4];
-  while (len >= 3) {
-    // Encode 3 bytes at a time
-    base64_encode(bytes, 3, b);
-    for (int i = 0; i < 4; i++) {
-      out_.write(b[i]);
-    }
-    ret += 4;
-    bytes += 3;
-    len -= 3;
-  }
-  if (len) { // Handle remainder
-    base64_encode(bytes, len, b);
-    for (uint32_t i = 0; i < len + 1; i++) {
-      out_.write(b[i]);
-    }
-    ret += len + 1;
+  // Encode through a small buffer, a multiple of 3 bytes at a time.
+  constexpr size_t kChunk = 3 * 256;
+  uint8_t encoded[detail::json::base64EncodedSize(kChunk)];
+  while (!v.empty()) {
+    auto chunk = v.subpiece(0, kChunk);
+    auto size = detail::json::base64EncodedSize(chunk.size());
+    detail::json::base64Encode(chunk, encoded);
+    out_.push(encoded, size);
+    ret += size;
+    v.advance(chunk.size());
   }
   out_.write(detail::json::kJSONStringDelimiter);
 
@@ -775,20 +777,13 @@ template <typename StrType>
 void JSONProtocolReaderCommon::readJSONBase64(StrType& str) {
   std::string tmp;
   readJSONString(tmp);
-  uint8_t* b = (uint8_t*)tmp.c_str();
-  uint32_t len = tmp.length();
+  // A single leftover character is invalid base64 but legal for skip of
+  // regular string type; base64DecodedSize() ignores it.
   str.clear();
-  while (len >= 4) {
-    base64_decode(b, 4);
-    str.append((const char*)b, 3);
-    b += 4;
-    len -= 4;
-  }
-  // Don't decode if we hit the end or got a single leftover byte (invalid
-  // base64 but legal for skip of regular string type)
-  if (len > 1) {
-    base64_decode(b, len);
-    str.append((const char*)b, len - 1);
+  str.resize(detail::json::base64DecodedSize(tmp.size()));
+  if (!str.empty()) {
+    detail::json::base64Decode(
+        folly::StringPiece(tmp), reinterpret_cast<uint8_t*>(&str[0]));
   }
 }
 
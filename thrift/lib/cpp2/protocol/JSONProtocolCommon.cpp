@@ -16,9 +16,16 @@
 
 #include <thrift/lib/cpp2/protocol/JSONProtocolCommon.h>
 
+#include <cmath>
 #include <type_traits>
 
 #include <fmt/core.h>
+#include <folly/Portability.h>
+#include <folly/lang/Bits.h>
+
+#if FOLLY_SSE >= 2
+#include <emmintrin.h>
+#endif
 
 namespace {
 
@@ -64,6 +71,97 @@ struct IsSomeString<WrappedIOBufQueueAppender> : std::true_type {};
 namespace apache {
 namespace thrift {
 
+namespace detail {
+namespace json {
+
+namespace {
+
+inline bool needsEscape(uint8_t ch) {
+  return ch < 0x20 || ch == kJSONStringDelimiter || ch == kJSONBackslash;
+}
+
+constexpr char kBase64EncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Maps characters to their 6 bit values; invalid characters map to 0xff, as
+// in protocol::base64_decode().
+struct Base64DecodeTable {
+  uint8_t values[256];
+
+  constexpr Base64DecodeTable() : values{} {
+    for (auto& value : values) {
+      value = 0xff;
+    }
+    for (uint8_t i = 0; i < 64; ++i) {
+      values[static_cast<uint8_t>(kBase64EncodeTable[i])] = i;
+    }
+  }
+};
+
+constexpr Base64DecodeTable kBase64DecodeTable;
+
+} // namespace
+
+size_t unescapedPrefixLength(folly::ByteRange str) {
+  const uint8_t* p = str.begin();
+  const uint8_t* end = str.end();
+#if FOLLY_SSE >= 2
+  // 16 characters at a time: flag quotes, backslashes and (by unsigned max)
+  // control characters, then find the first flagged one.
+  const __m128i quote = _mm_set1_epi8(kJSONStringDelimiter);
+  const __m128i backslash = _mm_set1_epi8(kJSONBackslash);
+  const __m128i lastControl = _mm_set1_epi8(0x1f);
+  for (; end - p >= 16; p += 16) {
+    auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    auto special = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash)),
+        _mm_cmpeq_epi8(_mm_max_epu8(chars, lastControl), lastControl));
+    if (auto mask = _mm_movemask_epi8(special)) {
+      return (p - str.begin()) + folly::findFirstSet(mask) - 1;
+    }
+  }
+#endif
+  while (p != end && !needsEscape(*p)) {
+    ++p;
+  }
+  return p - str.begin();
+}
+
+void base64Encode(folly::ByteRange in, uint8_t* out) {
+  const uint8_t* p = in.begin();
+  for (size_t n = in.size() / 3; n; --n, p += 3, out += 4) {
+    uint32_t bits = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+    out[0] = kBase64EncodeTable[bits >> 18];
+    out[1] = kBase64EncodeTable[(bits >> 12) & 0x3f];
+    out[2] = kBase64EncodeTable[(bits >> 6) & 0x3f];
+    out[3] = kBase64EncodeTable[bits & 0x3f];
+  }
+  if (size_t rest = in.end() - p) {
+    apache::thrift::protocol::base64_encode(p, rest, out);
+  }
+}
+
+void base64Decode(folly::ByteRange in, uint8_t* out) {
+  const auto& table = kBase64DecodeTable.values;
+  const uint8_t* p = in.begin();
+  for (size_t n = in.size() / 4; n; --n, p += 4, out += 3) {
+    uint8_t a = table[p[0]], b = table[p[1]], c = table[p[2]], d = table[p[3]];
+    out[0] = (a << 2) | (b >> 4);
+    out[1] = ((b << 4) & 0xf0) | (c >> 2);
+    out[2] = ((c << 6) & 0xc0) | d;
+  }
+  size_t rest = in.end() - p;
+  if (rest > 1) {
+    uint8_t tail[4] = {p[0], p[1], rest > 2 ? p[2] : uint8_t(0), 0};
+    apache::thrift::protocol::base64_decode(tail, rest);
+    std::copy(tail, tail + rest - 1, out);
+  }
+}
+
+} // namespace json
+} // namespace detail
+
 // This table describes the handling for the first 0x30 characters
 //  0 : escape using "\u00xx" notation
 //  1 : just output index
@@ -90,7 +188,14 @@ const uint8_t JSONProtocolReaderCommon::kEscapeCharVals[8] = {
 
 uint32_t JSONProtocolWriterCommon::writeJSONDoubleInternal(double dbl) {
   WrappedIOBufQueueAppender appender(out_);
-  folly::toAppend(dbl, &appender);
+  // The shortest representation of an integral double below 1e21 is its
+  // digits, which are much cheaper to produce as an integer. Keep -0 as is.
+  if (std::abs(dbl) < 1e15 && dbl == std::trunc(dbl) &&
+      !(dbl == 0 && std::signbit(dbl))) {
+    folly::toAppend(static_cast<int64_t>(dbl), &appender);
+  } else {
+    folly::toAppend(dbl, &appender);
+  }
   return appender.size();
 }
 
@@ -61,6 +61,35 @@ constexpr folly::StringPiece kThriftNan("NaN");
 constexpr folly::StringPiece kThriftNegativeNan("-NaN");
 constexpr folly::StringPiece kThriftInfinity("Infinity");
 constexpr folly::StringPiece kThriftNegativeInfinity("-Infinity");
+
+/**
+ * Returns the length of the longest prefix of 'str' which can be written to a
+ * JSON string without escaping.
+ */
+size_t unescapedPrefixLength(folly::ByteRange str);
+
+/**
+ * Thrift's base64 omits padding: a trailing group of n < 3 bytes is encoded as
+ * n + 1 characters.
+ */
+constexpr size_t base64EncodedSize(size_t n) {
+  return n / 3 * 4 + (n % 3 ? n % 3 + 1 : 0);
+}
+
+constexpr size_t base64DecodedSize(size_t n) {
+  return n / 4 * 3 + (n % 4 > 1 ? n % 4 - 1 : 0);
+}
+
+/**
+ * Encodes 'in' into base64EncodedSize(in.size()) bytes at 'out'.
+ */
+void base64Encode(folly::ByteRange in, uint8_t* out);
+
+/**
+ * Decodes 'in' into base64DecodedSize(in.size()) bytes at 'out'. Like
+ * protocol::base64_decode(), invalid characters aren't detected.
+ */
+void base64Decode(folly::ByteRange in, uint8_t* out);
 } // namespace json
 } // namespace detail
 
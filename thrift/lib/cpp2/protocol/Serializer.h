@@ -31,16 +31,31 @@
 #include <thrift/lib/cpp2/protocol/SimpleJSONProtocol.h>
 #include <thrift/lib/cpp2/protocol/Cpp2Ops.tcc>
 
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
 namespace apache {
 namespace thrift {
 
-template <typename Reader, typename Writer>
+/**
+ * `DefaultSharing` is the ExternalBufferSharing used by every overload that
+ * isn't given one. With SHARE_EXTERNAL_BUFFER, binary fields stored as
+ * folly::IOBuf always point into the input buffer instead of copying from it,
+ * whatever their size and however the input is chained, so the input must
+ * outlive the deserialized objects. Strings and binary fields stored in
+ * std::string are always copied.
+ */
+template <
+    typename Reader,
+    typename Writer,
+    ExternalBufferSharing DefaultSharing = COPY_EXTERNAL_BUFFER>
 struct Serializer {
   template <class T>
   static folly::io::Cursor deserialize(
       const folly::io::Cursor& cursor,
       T& obj,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     Reader reader(sharing);
     reader.setInput(cursor);
 
@@ -54,7 +69,7 @@ struct Serializer {
   static size_t deserialize(
       const folly::IOBuf* buf,
       T& obj,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     return deserialize(folly::io::Cursor{buf}, obj, sharing)
         .getCurrentPosition();
   }
@@ -63,7 +78,7 @@ struct Serializer {
   static size_t deserialize(
       folly::ByteRange range,
       T& obj,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     folly::IOBuf buf(folly::IOBuf::WRAP_BUFFER, range);
     return deserialize(&buf, obj, sharing);
   }
@@ -72,7 +87,7 @@ struct Serializer {
   static size_t deserialize(
       folly::StringPiece range,
       T& obj,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     return deserialize(folly::ByteRange(range), obj, sharing);
   }
 
@@ -108,7 +123,7 @@ struct Serializer {
   static T deserialize(
       folly::ByteRange range,
       size_t* size = nullptr,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     return returning<T>(
         [&](T& obj) { set(size, deserialize(range, obj, sharing)); });
   }
@@ -117,15 +132,46 @@ struct Serializer {
   static T deserialize(
       folly::StringPiece range,
       size_t* size = nullptr,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     return deserialize<T>(folly::ByteRange(range), size, sharing);
   }
 
+#if __has_include(<memory_resource>)
+  /**
+   * Deserialize an object whose strings and containers are allocated from
+   * `arena` rather than the global heap. Only types generated with the
+   * `allocator_aware` option pick up the arena; anything else is deserialized
+   * as usual. The arena must outlive the returned object.
+   */
+  template <class T>
+  static T deserializeInArena(
+      std::pmr::memory_resource* arena,
+      const folly::IOBuf* buf,
+      size_t* size = nullptr) {
+    T obj = detail::st::construct_with_allocator<T>(
+        std::pmr::polymorphic_allocator<char>(arena));
+    set(size, deserialize(buf, obj));
+    return obj;
+  }
+
+  template <class T>
+  static T deserializeInArena(
+      std::pmr::memory_resource* arena,
+      folly::ByteRange range,
+      size_t* size = nullptr,
+      ExternalBufferSharing sharing = DefaultSharing) {
+    T obj = detail::st::construct_with_allocator<T>(
+        std::pmr::polymorphic_allocator<char>(arena));
+    set(size, deserialize(range, obj, sharing));
+    return obj;
+  }
+#endif
+
   template <class T>
   static void serialize(
       const T& obj,
       folly::IOBufQueue* out,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     Writer writer(sharing);
     writer.setOutput(out);
 
@@ -138,7 +184,7 @@ struct Serializer {
   static void serialize(
       const T& obj,
       folly::io::QueueAppender&& out,
-      ExternalBufferSharing sharing = COPY_EXTERNAL_BUFFER) {
+      ExternalBufferSharing sharing = DefaultSharing) {
     Writer writer(sharing);
     writer.setOutput(std::move(out));
 
@@ -198,6 +244,18 @@ typedef Serializer<JSONProtocolReader, JSONProtocolWriter> JSONSerializer;
 typedef Serializer<SimpleJSONProtocolReader, SimpleJSONProtocolWriter>
     SimpleJSONSerializer;
 
+// Never copy folly::IOBuf binary fields, on reads or writes.
+typedef Serializer<
+    CompactProtocolReader,
+    CompactProtocolWriter,
+    SHARE_EXTERNAL_BUFFER>
+    ZeroCopyCompactSerializer;
+typedef Serializer<
+    BinaryProtocolReader,
+    BinaryProtocolWriter,
+    SHARE_EXTERNAL_BUFFER>
+    ZeroCopyBinarySerializer;
+
 // Serialization code specific to handling errors
 template <typename ProtIn, typename ProtOut>
 std::unique_ptr<folly::IOBuf> serializeErrorProtocol(
@@ -0,0 +1,502 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <folly/Likely.h>
+#include <folly/Range.h>
+#include <folly/Traits.h>
+
+#include <thrift/lib/cpp/protocol/TType.h>
+#include <thrift/lib/cpp2/GeneratedSerializationCodeHelper.h>
+#include <thrift/lib/cpp2/TypeClass.h>
+#include <thrift/lib/cpp2/protocol/ProtocolReaderStructReadState.h>
+
+/**
+ * Table-driven (de)serialization of generated structs.
+ *
+ * With the `table_based` generator option, a struct's readNoXfer(), write(),
+ * serializedSize() and serializedSizeZC() do not unroll a code path per field.
+ * Instead the generator emits a constexpr array describing each field (id,
+ * wire type, byte offset, isset flag offset) and the methods hand it to the
+ * interpreters below, which are instantiated once per protocol and shared by
+ * every table-based struct.
+ *
+ * Fields of primitive type and std::string are handled inline by the
+ * interpreters; everything else (containers, nested structs, custom cpp.type
+ * and indirections) goes through a per-field function pointer that forwards
+ * to the usual protocol_methods / Cpp2Ops code.
+ */
+
+namespace apache {
+namespace thrift {
+namespace detail {
+namespace table {
+
+enum class FieldKind : uint8_t {
+  Bool,
+  Byte,
+  I16,
+  I32,
+  I64,
+  Float,
+  Double,
+  String,
+  Binary,
+  Enum,
+  Custom,
+};
+
+template <typename Protocol, typename = void>
+struct is_reader : std::false_type {};
+
+template <typename Protocol>
+struct is_reader<
+    Protocol,
+    folly::void_t<decltype(std::declval<Protocol&>().readStructEnd())>>
+    : std::true_type {};
+
+/*
+ * Out-of-line (de)serializers for FieldKind::Custom fields. Readers and
+ * writers need different entry points, so the table for a reader only
+ * carries the former and the table for a writer only the latter.
+ */
+template <typename Protocol, bool = is_reader<Protocol>::value>
+struct CustomOps {
+  void (*read)(Protocol& prot, void* value);
+};
+
+template <typename Protocol>
+struct CustomOps<Protocol, false> {
+  uint32_t (*write)(Protocol& prot, const void* value);
+  uint32_t (*serializedSize)(const Protocol& prot, const void* value);
+  uint32_t (*serializedSizeZC)(const Protocol& prot, const void* value);
+};
+
+template <typename Protocol>
+struct FieldInfo {
+  int16_t id;
+  protocol::TType type;
+  FieldKind kind;
+  bool optional;
+  const char* name;
+  uint32_t offset;
+  // Offset of the field's flag in `__isset`, or -1 if it does not have one.
+  int32_t issetOffset;
+  CustomOps<Protocol> ops;
+};
+
+template <typename Protocol>
+struct StructInfo {
+  const char* name;
+  const FieldInfo<Protocol>* fields;
+  uint32_t numFields;
+  void (*translateFieldName)(
+      folly::StringPiece fname,
+      int16_t& fid,
+      protocol::TType& ftype);
+};
+
+/**
+ * Specialized by generated code for every table-based struct, with a static
+ * constexpr StructInfo<Protocol> member named `info`.
+ */
+template <typename Struct, typename Protocol>
+struct StructTable;
+
+template <typename TypeClass, typename T, typename = void>
+struct field_kind {
+  static constexpr FieldKind value = FieldKind::Custom;
+};
+
+#define THRIFT_TABLE_FIELD_KIND(TypeClass, Type, Kind)   \
+  template <>                                            \
+  struct field_kind<type_class::TypeClass, Type> {       \
+    static constexpr FieldKind value = FieldKind::Kind; \
+  }
+
+THRIFT_TABLE_FIELD_KIND(integral, bool, Bool);
+THRIFT_TABLE_FIELD_KIND(integral, std::int8_t, Byte);
+THRIFT_TABLE_FIELD_KIND(integral, std::int16_t, I16);
+THRIFT_TABLE_FIELD_KIND(integral, std::int32_t, I32);
+THRIFT_TABLE_FIELD_KIND(integral, std::int64_t, I64);
+THRIFT_TABLE_FIELD_KIND(floating_point, float, Float);
+THRIFT_TABLE_FIELD_KIND(floating_point, double, Double);
+THRIFT_TABLE_FIELD_KIND(string, std::string, String);
+THRIFT_TABLE_FIELD_KIND(binary, std::string, Binary);
+
+#undef THRIFT_TABLE_FIELD_KIND
+
+template <typename T>
+struct field_kind<
+    type_class::enumeration,
+    T,
+    std::enable_if_t<std::is_same<
+        std::underlying_type_t<T>,
+        std::int32_t>::value>> {
+  static constexpr FieldKind value = FieldKind::Enum;
+};
+
+// Unions are serialized through their Cpp2Ops, like structs.
+template <typename TypeClass, typename T>
+struct value_methods : pm::protocol_methods<TypeClass, T> {};
+
+template <typename T>
+struct value_methods<type_class::variant, T>
+    : pm::protocol_methods<type_class::structure, T> {};
+
+// Containers are cleared before being read into; everything else is read
+// into the existing value, matching the unrolled readNoXfer.
+template <typename TypeClass>
+struct is_container_class : std::false_type {};
+template <typename ElemClass>
+struct is_container_class<type_class::list<ElemClass>> : std::true_type {};
+template <typename ElemClass>
+struct is_container_class<type_class::set<ElemClass>> : std::true_type {};
+template <typename KeyClass, typename MappedClass>
+struct is_container_class<type_class::map<KeyClass, MappedClass>>
+    : std::true_type {};
+template <typename KeyClass, typename MappedClass>
+struct is_container_class<
+    type_class::map_forward_compatibility<KeyClass, MappedClass>>
+    : std::true_type {};
+
+template <typename T>
+void resetBeforeRead(std::true_type, T& value) {
+  value = T();
+}
+
+template <typename T>
+void resetBeforeRead(std::false_type, T&) {}
+
+template <typename TypeClass, typename T, typename Protocol>
+struct CustomField {
+  using methods = value_methods<TypeClass, T>;
+
+  static void read(Protocol& prot, void* value) {
+    auto& v = *static_cast<T*>(value);
+    resetBeforeRead(is_container_class<TypeClass>{}, v);
+    methods::read(prot, v);
+  }
+
+  static uint32_t write(Protocol& prot, const void* value) {
+    return methods::write(prot, *static_cast<const T*>(value));
+  }
+
+  static uint32_t serializedSize(const Protocol& prot, const void* value) {
+    return methods::template serializedSize<false>(
+        prot, *static_cast<const T*>(value));
+  }
+
+  static uint32_t serializedSizeZC(const Protocol& prot, const void* value) {
+    return methods::template serializedSize<true>(
+        prot, *static_cast<const T*>(value));
+  }
+};
+
+template <typename TypeClass, typename T, typename Protocol>
+constexpr CustomOps<Protocol> makeOps(std::false_type) {
+  return {};
+}
+
+template <typename TypeClass, typename T, typename Protocol>
+constexpr std::enable_if_t<is_reader<Protocol>::value, CustomOps<Protocol>>
+makeOps(std::true_type) {
+  return {&CustomField<TypeClass, T, Protocol>::read};
+}
+
+template <typename TypeClass, typename T, typename Protocol>
+constexpr std::enable_if_t<!is_reader<Protocol>::value, CustomOps<Protocol>>
+makeOps(std::true_type) {
+  return {&CustomField<TypeClass, T, Protocol>::write,
+          &CustomField<TypeClass, T, Protocol>::serializedSize,
+          &CustomField<TypeClass, T, Protocol>::serializedSizeZC};
+}
+
+/**
+ * Builds the table entry for a field of C++ type T and type class TypeClass.
+ * Only FieldKind::Custom entries carry function pointers.
+ */
+template <typename TypeClass, typename T, typename Protocol>
+constexpr FieldInfo<Protocol> makeField(
+    int16_t id,
+    const char* name,
+    bool optional,
+    std::size_t offset,
+    std::ptrdiff_t issetOffset) {
+  return {id,
+          value_methods<TypeClass, T>::ttype_value,
+          field_kind<TypeClass, T>::value,
+          optional,
+          name,
+          static_cast<uint32_t>(offset),
+          static_cast<int32_t>(issetOffset),
+          makeOps<TypeClass, T, Protocol>(
+              std::integral_constant<
+                  bool,
+                  field_kind<TypeClass, T>::value == FieldKind::Custom>{})};
+}
+
+template <typename T>
+T& at(void* object, uint32_t offset) {
+  return *reinterpret_cast<T*>(static_cast<char*>(object) + offset);
+}
+
+template <typename T>
+const T& at(const void* object, uint32_t offset) {
+  return *reinterpret_cast<const T*>(
+      static_cast<const char*>(object) + offset);
+}
+
+template <typename Protocol>
+void readField(Protocol& prot, const FieldInfo<Protocol>& field, void* object) {
+  switch (field.kind) {
+    case FieldKind::Bool:
+      prot.readBool(at<bool>(object, field.offset));
+      break;
+    case FieldKind::Byte:
+      prot.readByte(at<int8_t>(object, field.offset));
+      break;
+    case FieldKind::I16:
+      prot.readI16(at<int16_t>(object, field.offset));
+      break;
+    case FieldKind::I32:
+      prot.readI32(at<int32_t>(object, field.offset));
+      break;
+    case FieldKind::I64:
+      prot.readI64(at<int64_t>(object, field.offset));
+      break;
+    case FieldKind::Float:
+      prot.readFloat(at<float>(object, field.offset));
+      break;
+    case FieldKind::Double:
+      prot.readDouble(at<double>(object, field.offset));
+      break;
+    case FieldKind::String:
+      prot.readString(at<std::string>(object, field.offset));
+      break;
+    case FieldKind::Binary:
+      prot.readBinary(at<std::string>(object, field.offset));
+      break;
+    case FieldKind::Enum: {
+      // The member is an enum; copy the bytes instead of aliasing it as an
+      // int32_t.
+      int32_t value;
+      prot.readI32(value);
+      std::memcpy(static_cast<char*>(object) + field.offset, &value, 4);
+      break;
+    }
+    case FieldKind::Custom:
+      field.ops.read(prot, static_cast<char*>(object) + field.offset);
+      break;
+  }
+  if (field.issetOffset >= 0) {
+    at<bool>(object, field.issetOffset) = true;
+  }
+}
+
+/**
+ * Replaces the unrolled readNoXfer(). Fields are expected in table order,
+ * which is declaration order, and each one is first tried through
+ * advanceToNextField(); anything else goes through a lookup by id and
+ * unknown or mistyped fields are skipped.
+ */
+template <typename Protocol>
+void read(Protocol* iprot, void* object, const StructInfo<Protocol>& info) {
+  ProtocolReaderStructReadState<Protocol> readState;
+  readState.readStructBegin(iprot);
+
+  int16_t currId = 0;
+  uint32_t next = 0;
+  while (true) {
+    if (next < info.numFields) {
+      const auto& field = info.fields[next];
+      if (LIKELY(readState.advanceToNextField(
+              iprot, currId, field.id, field.type))) {
+        readField(*iprot, field, object);
+        currId = field.id;
+        ++next;
+        continue;
+      }
+    } else if (LIKELY(readState.advanceToNextField(
+                   iprot, currId, 0, protocol::T_STOP))) {
+      break;
+    }
+
+    // The state now holds whatever field header is next on the wire.
+    while (true) {
+      if (readState.fieldType == protocol::T_STOP) {
+        readState.readStructEnd(iprot);
+        return;
+      }
+      if (iprot->kUsesFieldNames()) {
+        info.translateFieldName(
+            readState.fieldName(), readState.fieldId, readState.fieldType);
+      }
+      uint32_t i = 0;
+      while (i < info.numFields && info.fields[i].id != readState.fieldId) {
+        ++i;
+      }
+      if (i < info.numFields &&
+          LIKELY(readState.isCompatibleWithType(iprot, info.fields[i].type))) {
+        readField(*iprot, info.fields[i], object);
+        currId = info.fields[i].id;
+        next = i + 1;
+        break;
+      }
+      iprot->skip(readState.fieldType);
+      readState.readFieldEnd(iprot);
+      readState.readFieldBeginNoInline(iprot);
+    }
+  }
+
+  readState.readStructEnd(iprot);
+}
+
+template <typename Protocol>
+bool isSkipped(const FieldInfo<Protocol>& field, const void* object) {
+  return field.optional && !at<bool>(object, field.issetOffset);
+}
+
+template <typename Protocol>
+uint32_t writeField(
+    Protocol& prot,
+    const FieldInfo<Protocol>& field,
+    const void* object) {
+  switch (field.kind) {
+    case FieldKind::Bool:
+      return prot.writeBool(at<bool>(object, field.offset));
+    case FieldKind::Byte:
+      return prot.writeByte(at<int8_t>(object, field.offset));
+    case FieldKind::I16:
+      return prot.writeI16(at<int16_t>(object, field.offset));
+    case FieldKind::I32:
+      return prot.writeI32(at<int32_t>(object, field.offset));
+    case FieldKind::I64:
+      return prot.writeI64(at<int64_t>(object, field.offset));
+    case FieldKind::Float:
+      return prot.writeFloat(at<float>(object, field.offset));
+    case FieldKind::Double:
+      return prot.writeDouble(at<double>(object, field.offset));
+    case FieldKind::String:
+      return prot.writeString(at<std::string>(object, field.offset));
+    case FieldKind::Binary:
+      return prot.writeBinary(at<std::string>(object, field.offset));
+    case FieldKind::Enum: {
+      int32_t value;
+      std::memcpy(&value, static_cast<const char*>(object) + field.offset, 4);
+      return prot.writeI32(value);
+    }
+    case FieldKind::Custom:
+      return field.ops.write(
+          prot, static_cast<const char*>(object) + field.offset);
+  }
+  return 0;
+}
+
+template <bool ZeroCopy, typename Protocol>
+uint32_t fieldSize(
+    const Protocol& prot,
+    const FieldInfo<Protocol>& field,
+    const void* object) {
+  switch (field.kind) {
+    case FieldKind::Bool:
+      return prot.serializedSizeBool(at<bool>(object, field.offset));
+    case FieldKind::Byte:
+      return prot.serializedSizeByte(at<int8_t>(object, field.offset));
+    case FieldKind::I16:
+      return prot.serializedSizeI16(at<int16_t>(object, field.offset));
+    case FieldKind::I32:
+      return prot.serializedSizeI32(at<int32_t>(object, field.offset));
+    case FieldKind::I64:
+      return prot.serializedSizeI64(at<int64_t>(object, field.offset));
+    case FieldKind::Float:
+      return prot.serializedSizeFloat(at<float>(object, field.offset));
+    case FieldKind::Double:
+      return prot.serializedSizeDouble(at<double>(object, field.offset));
+    case FieldKind::String:
+      return prot.serializedSizeString(at<std::string>(object, field.offset));
+    case FieldKind::Binary:
+      return ZeroCopy
+          ? prot.serializedSizeZCBinary(at<std::string>(object, field.offset))
+          : prot.serializedSizeBinary(at<std::string>(object, field.offset));
+    case FieldKind::Enum: {
+      int32_t value;
+      std::memcpy(&value, static_cast<const char*>(object) + field.offset, 4);
+      return prot.serializedSizeI32(value);
+    }
+    case FieldKind::Custom:
+      return (ZeroCopy ? field.ops.serializedSizeZC : field.ops.serializedSize)(
+          prot, static_cast<const char*>(object) + field.offset);
+  }
+  return 0;
+}
+
+/**
+ * Replaces the unrolled write().
+ */
+template <typename Protocol>
+uint32_t
+write(Protocol* prot, const void* object, const StructInfo<Protocol>& info) {
+  uint32_t xfer = 0;
+  xfer += prot->writeStructBegin(info.name);
+  for (uint32_t i = 0; i < info.numFields; ++i) {
+    const auto& field = info.fields[i];
+    if (isSkipped(field, object)) {
+      continue;
+    }
+    xfer += prot->writeFieldBegin(field.name, field.type, field.id);
+    xfer += writeField(*prot, field, object);
+    xfer += prot->writeFieldEnd();
+  }
+  xfer += prot->writeFieldStop();
+  xfer += prot->writeStructEnd();
+  return xfer;
+}
+
+/**
+ * Replaces the unrolled serializedSize() and serializedSizeZC().
+ */
+template <bool ZeroCopy, typename Protocol>
+uint32_t serializedSize(
+    const Protocol* prot,
+    const void* object,
+    const StructInfo<Protocol>& info) {
+  uint32_t xfer = 0;
+  xfer += prot->serializedStructSize(info.name);
+  for (uint32_t i = 0; i < info.numFields; ++i) {
+    const auto& field = info.fields[i];
+    if (isSkipped(field, object)) {
+      continue;
+    }
+    xfer += prot->serializedFieldSize(field.name, field.type, field.id);
+    xfer += fieldSize<ZeroCopy>(*prot, field, object);
+  }
+  xfer += prot->serializedSizeStop();
+  return xfer;
+}
+
+} // namespace table
+} // namespace detail
+} // namespace thrift
+} // namespace apache
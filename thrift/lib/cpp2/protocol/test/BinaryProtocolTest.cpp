@@ -13,8 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <memory_resource>
+#include <set>
+
 #include <folly/portability/GTest.h>
 
+#include <thrift/lib/cpp2/GeneratedSerializationCodeHelper.h>
+#include <thrift/lib/cpp2/Thrift.h>
 #include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
 
 using namespace apache::thrift;
@@ -38,4 +43,139 @@ TEST_F(BinaryProtocolTest, readInvalidBool) {
   EXPECT_THROW(inprot.readBool(value), TProtocolException);
 }
 
+TEST_F(BinaryProtocolTest, writeFixedArrayMatchesPerElementWrites) {
+  std::vector<int64_t> values{0, 1, -1, 0x0102030405060708, INT64_MIN};
+
+  folly::IOBufQueue bulk;
+  BinaryProtocolWriter bulkprot;
+  bulkprot.setOutput(&bulk);
+  EXPECT_EQ(
+      values.size() * sizeof(int64_t),
+      bulkprot.writeFixedArray(values.data(), values.size()));
+
+  folly::IOBufQueue single;
+  BinaryProtocolWriter singleprot;
+  singleprot.setOutput(&single);
+  for (auto v : values) {
+    singleprot.writeI64(v);
+  }
+
+  EXPECT_TRUE(folly::IOBufEqualTo()(*bulk.move(), *single.move()));
+}
+
+TEST_F(BinaryProtocolTest, fixedArrayRoundTripAcrossChain) {
+  using methods = detail::pm::protocol_methods<
+      type_class::list<type_class::floating_point>,
+      std::vector<double>>;
+  std::vector<double> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(i * 0.5 - 100);
+  }
+
+  folly::IOBufQueue queue;
+  BinaryProtocolWriter outprot;
+  outprot.setOutput(&queue);
+  methods::write(outprot, values);
+
+  // Split the payload so the elements straddle IOBuf boundaries.
+  auto buf = queue.move();
+  buf->coalesce();
+  auto tail = buf->cloneOne();
+  buf->trimEnd(buf->length() - 13);
+  tail->trimStart(13);
+  buf->prependChain(std::move(tail));
+
+  BinaryProtocolReader inprot;
+  inprot.setInput(buf.get());
+  std::vector<double> result;
+  methods::read(inprot, result);
+  EXPECT_EQ(values, result);
+}
+
+TEST_F(BinaryProtocolTest, readFixedArrayTruncated) {
+  uint8_t data[] = {0, 0, 0, 1, 0, 0};
+  auto buf = folly::IOBuf::wrapBufferAsValue(folly::range(data));
+
+  BinaryProtocolReader inprot;
+  inprot.setInput(&buf);
+  int32_t values[2];
+  EXPECT_THROW(inprot.readFixedArray(values, 2), std::out_of_range);
+}
+
+TEST_F(BinaryProtocolTest, fixedArraySetRoundTrip) {
+  using methods = detail::pm::protocol_methods<
+      type_class::set<type_class::integral>,
+      std::set<int64_t>>;
+  // More elements than are decoded in one chunk.
+  std::set<int64_t> values;
+  for (int64_t i = 0; i < 3000; ++i) {
+    values.insert(i * 7 - 1000);
+  }
+
+  folly::IOBufQueue queue;
+  BinaryProtocolWriter outprot;
+  outprot.setOutput(&queue);
+  methods::write(outprot, values);
+
+  auto buf = queue.move();
+  BinaryProtocolReader inprot;
+  inprot.setInput(buf.get());
+  std::set<int64_t> result;
+  methods::read(inprot, result);
+  EXPECT_EQ(values, result);
+}
+
+TEST_F(BinaryProtocolTest, fixedArraySetSizeExceedsPayload) {
+  using methods = detail::pm::protocol_methods<
+      type_class::set<type_class::integral>,
+      std::set<int64_t>>;
+  folly::IOBufQueue queue;
+  BinaryProtocolWriter outprot;
+  outprot.setOutput(&queue);
+  outprot.writeSetBegin(T_I64, 1 << 30);
+  outprot.writeI64(1);
+  outprot.writeI64(2);
+
+  // Fails on the missing elements instead of allocating for all of them.
+  auto buf = queue.move();
+  BinaryProtocolReader inprot;
+  inprot.setInput(buf.get());
+  std::set<int64_t> result;
+  EXPECT_THROW(methods::read(inprot, result), std::out_of_range);
+}
+
+TEST_F(BinaryProtocolTest, arenaBackedContainersRoundTrip) {
+  using Map = std::pmr::
+      map<std::pmr::string, std::pmr::vector<std::pmr::string>>;
+  using methods = detail::pm::protocol_methods<
+      type_class::map<type_class::string, type_class::list<type_class::binary>>,
+      Map>;
+  std::string const big(64, 'x'); // defeat the small string optimization
+  Map values;
+  values[std::pmr::string(big + "a")] = {std::pmr::string(big), "b"};
+  values[std::pmr::string(big + "c")] = {};
+
+  folly::IOBufQueue queue;
+  BinaryProtocolWriter outprot;
+  outprot.setOutput(&queue);
+  methods::write(outprot, values);
+  auto buf = queue.move();
+
+  std::pmr::monotonic_buffer_resource arena;
+  auto result = detail::st::construct_with_allocator<Map>(
+      std::pmr::polymorphic_allocator<char>(&arena));
+  BinaryProtocolReader inprot;
+  inprot.setInput(buf.get());
+  methods::read(inprot, result);
+
+  EXPECT_EQ(values, result);
+  for (auto const& kv : result) {
+    EXPECT_EQ(&arena, kv.first.get_allocator().resource());
+    EXPECT_EQ(&arena, kv.second.get_allocator().resource());
+    for (auto const& s : kv.second) {
+      EXPECT_EQ(&arena, s.get_allocator().resource());
+    }
+  }
+}
+
 } // namespace
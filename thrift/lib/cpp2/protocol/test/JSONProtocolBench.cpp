@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <thrift/lib/cpp2/protocol/JSONProtocol.h>
+#include <thrift/lib/cpp2/protocol/SimpleJSONProtocol.h>
+
+using namespace apache::thrift;
+
+namespace {
+
+const std::string kPlain = [] {
+  std::string str;
+  for (size_t i = 0; i < 4096; ++i) {
+    str.push_back('a' + i % 26);
+  }
+  return str;
+}();
+
+// One character in 64 needs escaping.
+const std::string kSparseEscapes = [] {
+  std::string str = kPlain;
+  for (size_t i = 0; i < str.size(); i += 64) {
+    str[i] = i % 128 ? '"' : '\n';
+  }
+  return str;
+}();
+
+const std::string kBinary = [] {
+  std::string str;
+  for (size_t i = 0; i < 4096; ++i) {
+    str.push_back(static_cast<char>(i * 131));
+  }
+  return str;
+}();
+
+template <class Writer, class F>
+void benchmarkWrite(size_t iters, F&& write) {
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  Writer writer;
+  writer.setOutput(&queue);
+  while (iters--) {
+    write(writer);
+    if (queue.chainLength() > (1 << 20)) {
+      queue.reset();
+      writer.setOutput(&queue);
+    }
+  }
+  folly::doNotOptimizeAway(queue.chainLength());
+}
+
+} // namespace
+
+BENCHMARK(JSON_writeString_plain, iters) {
+  benchmarkWrite<JSONProtocolWriter>(
+      iters, [](auto& w) { w.writeString(kPlain); });
+}
+
+BENCHMARK(JSON_writeString_sparseEscapes, iters) {
+  benchmarkWrite<JSONProtocolWriter>(
+      iters, [](auto& w) { w.writeString(kSparseEscapes); });
+}
+
+BENCHMARK(SimpleJSON_writeString_plain, iters) {
+  benchmarkWrite<SimpleJSONProtocolWriter>(
+      iters, [](auto& w) { w.writeString(kPlain); });
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(JSON_writeBinary, iters) {
+  benchmarkWrite<JSONProtocolWriter>(
+      iters, [](auto& w) { w.writeBinary(folly::StringPiece(kBinary)); });
+}
+
+BENCHMARK(JSON_readBinary, iters) {
+  folly::BenchmarkSuspender setup;
+  folly::IOBufQueue queue;
+  JSONProtocolWriter writer;
+  writer.setOutput(&queue);
+  writer.writeBinary(folly::StringPiece(kBinary));
+  auto buf = queue.move();
+  setup.dismiss();
+  std::string out;
+  while (iters--) {
+    JSONProtocolReader reader;
+    reader.setInput(buf.get());
+    reader.readBinary(out);
+  }
+  folly::doNotOptimizeAway(out.size());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(JSON_writeDouble_integral, iters) {
+  size_t i = 0;
+  benchmarkWrite<JSONProtocolWriter>(
+      iters, [&](auto& w) { w.writeDouble(double(i++ % 100000)); });
+}
+
+BENCHMARK(JSON_writeDouble_fraction, iters) {
+  size_t i = 0;
+  benchmarkWrite<JSONProtocolWriter>(
+      iters, [&](auto& w) { w.writeDouble(i++ % 100000 / 7.0); });
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
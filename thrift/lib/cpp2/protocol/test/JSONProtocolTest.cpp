@@ -128,6 +128,16 @@ TEST_F(JSONProtocolTest, writeDouble) {
   EXPECT_EQ(expected, writing_cpp2([](W& p) { p.writeDouble(5.25); }));
 }
 
+TEST_F(JSONProtocolTest, writeDouble_integral) {
+  EXPECT_EQ("3", writing_cpp2([](W& p) { p.writeDouble(3.0); }));
+  EXPECT_EQ("-1024", writing_cpp2([](W& p) { p.writeDouble(-1024.0); }));
+  EXPECT_EQ("0", writing_cpp2([](W& p) { p.writeDouble(0.0); }));
+  for (double d : {-0.0, 1e15, 123456789012345.0, 0.5, -1e300}) {
+    EXPECT_EQ(
+        folly::to<string>(d), writing_cpp2([&](W& p) { p.writeDouble(d); }));
+  }
+}
+
 TEST_F(JSONProtocolTest, writeFloat) {
   auto expected = "5.25";
   EXPECT_EQ(expected, writing_cpp2([](W& p) { p.writeFloat(5.25f); }));
@@ -140,6 +150,19 @@ TEST_F(JSONProtocolTest, writeString) {
   EXPECT_EQ(expected, writing_cpp2([](W& p) { p.writeString("foobar"); }));
 }
 
+TEST_F(JSONProtocolTest, writeString_escapes) {
+  // Escapes at every offset of runs longer than a vector of characters.
+  for (size_t i = 0; i < 40; ++i) {
+    string input(40, 'x');
+    input[i] = i % 3 == 0 ? '"' : i % 3 == 1 ? '\\' : '\n';
+    input += "\xc3\xa9\x01";
+    string expected = "\"" + input.substr(0, i) +
+        (i % 3 == 0 ? "\\\"" : i % 3 == 1 ? "\\\\" : "\\n") +
+        input.substr(i + 1, 39 - i) + "\xc3\xa9\\u0001\"";
+    EXPECT_EQ(expected, writing_cpp2([&](W& p) { p.writeString(input); }));
+  }
+}
+
 TEST_F(JSONProtocolTest, writeBinary) {
   auto expected = R"("Zm9vYmFy")";
   EXPECT_EQ(
@@ -154,6 +177,20 @@ TEST_F(JSONProtocolTest, writeBinary) {
       }));
 }
 
+TEST_F(JSONProtocolTest, binary_roundtrip) {
+  for (size_t size = 0; size < 2000; size += size < 10 ? 1 : 97) {
+    string input;
+    for (size_t i = 0; i < size; ++i) {
+      input.push_back(static_cast<char>(i * 37));
+    }
+    auto encoded = writing_cpp2([&](W& p) { p.writeBinary(input); });
+    EXPECT_EQ(2 + (size * 4 + 2) / 3, encoded.size());
+    EXPECT_EQ(input, reading_cpp2<string>(encoded, [](R& p) {
+                return returning([&](string& _) { p.readBinary(_); });
+              }));
+  }
+}
+
 TEST_F(JSONProtocolTest, writeSerializedData) {
   auto expected = "foobar";
   EXPECT_EQ(expected, writing_cpp2([](W& p) {
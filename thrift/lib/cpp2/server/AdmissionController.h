@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <unordered_map>
@@ -51,6 +52,16 @@ class AdmissionController {
    */
   virtual void returnedResponse(std::chrono::nanoseconds) = 0;
 
+  /**
+   * Indicate to the controller that a request it admitted is done, either
+   * because it was processed (after dequeue() and returnedResponse()) or
+   * because it was dropped before being processed (after dequeue() only).
+   * `sinceAdmission` is the total time the request spent in the server.
+   */
+  virtual void requestFinished(
+      std::chrono::nanoseconds /*sinceAdmission*/,
+      bool /*processed*/) {}
+
   /**
    * Delegate reporting the metrics to the underlying implementation
    * The last argument must contain the current metric values in case the
@@ -61,6 +72,39 @@ class AdmissionController {
       const std::string& /*prefix*/,
       const std::unordered_map<std::string, double>& /*previousValues*/ = {},
       uint32_t /*previousValueCount*/ = 0) {}
+
+ protected:
+  /**
+   * Report the metrics and aggregate it with the previous value if metrics is
+   * non-empty.
+   * This can be useful for aggregating metrics accros similar admission
+   * controllers, e.g. the priority admission controller creates *many*
+   * sub-controllers (controller.A.1.xyz, controller.A.2.xyz, ...,
+   * controller.A.128.xyz)
+   * Those metrics are aggregated under controller.A.xyz
+   */
+  static void reportAggregate(
+      const std::string& metricName,
+      const std::unordered_map<std::string, double>& metrics,
+      const MetricReportFn& report,
+      AggregationType aggType,
+      double newValue,
+      uint32_t count) {
+    auto value = 0.0;
+    auto it = metrics.find(metricName);
+    if (it != metrics.end()) {
+      value = it->second;
+    }
+    switch (aggType) {
+      case AggregationType::SUM:
+        value = value + newValue;
+        break;
+      case AggregationType::AVG:
+        value = (value * (count - 1) + newValue) / std::max(1U, count);
+        break;
+    }
+    report(metricName, value);
+  }
 };
 
 class DenyAllAdmissionController : public AdmissionController {
@@ -32,6 +32,7 @@
 #include <thrift/lib/cpp/server/TServerEventHandler.h>
 #include <thrift/lib/cpp/server/TServerObserver.h>
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp2/Thrift.h>
 #include <thrift/lib/cpp2/async/AsyncProcessor.h>
 #include <thrift/lib/cpp2/server/ServerAttribute.h>
@@ -140,6 +141,10 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
 
   ServerAttribute<bool> enableCodel_{false};
 
+  //! Number of task queue shards of the default thread manager (0 = one per
+  //  io worker thread)
+  ServerAttribute<size_t> nThreadManagerShards_{1};
+
   //! Milliseconds we'll wait for data to appear (0 = infinity)
   ServerAttribute<std::chrono::milliseconds> timeout_{DEFAULT_TIMEOUT};
 
@@ -203,6 +208,12 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
   // transformed response, headers not included. 0 (default) means no limit.
   ServerAttribute<uint64_t> maxResponseSize_{0};
 
+  // Max size a compressed request may uncompress to. Unlike the response
+  // limit this one can't be disabled: without it a tiny compressed request
+  // can make the server allocate arbitrarily much.
+  ServerAttribute<uint64_t> maxUncompressedRequestSize_{
+      transport::ZstdDictionary::kDefaultMaxUncompressedBytes};
+
   // Admission strategy use for accepting new requests
   ServerAttribute<std::shared_ptr<AdmissionStrategy>> admissionStrategy_;
 
@@ -436,6 +447,21 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
     maxResponseSize_.set(size, source);
   }
 
+  uint64_t getMaxUncompressedRequestSize() const final {
+    return maxUncompressedRequestSize_.get();
+  }
+
+  /**
+   * Set the maximum size a compressed request may uncompress to. Larger
+   * requests are rejected as they are uncompressed, before the whole
+   * uncompressed size is allocated.
+   */
+  void setMaxUncompressedRequestSize(
+      uint64_t size,
+      AttributeSource source = AttributeSource::OVERRIDE) {
+    maxUncompressedRequestSize_.set(size, source);
+  }
+
   bool getUseClientTimeout() const {
     return useClientTimeout_.get();
   }
@@ -680,6 +706,25 @@ class BaseThriftServer : public apache::thrift::concurrency::Runnable,
     return enableCodel_.get();
   }
 
+  /**
+   * Split the task queue of the default thread manager into this many shards.
+   * Each IO thread adds tasks to the shard it maps to and idle CPU threads
+   * steal from the other shards, which avoids contention on a single queue
+   * with many IO threads. Codel is tracked per shard. 0 means one shard per
+   * IO worker thread. Defaults to 1, a single queue.
+   * Must be called before serve() for it to take effect, and is ignored if
+   * setThreadManager() is called.
+   */
+  void setNumThreadManagerShards(
+      size_t numShards,
+      AttributeSource source = AttributeSource::OVERRIDE) {
+    nThreadManagerShards_.set(numShards, source);
+  }
+
+  size_t getNumThreadManagerShards() const {
+    return nThreadManagerShards_.get();
+  }
+
   /**
    * Set the processor factory as the one built into the
    * ServerInterface.
@@ -16,8 +16,11 @@
 #ifndef THRIFT_ASYNC_CPP2CONNCONTEXT_H_
 #define THRIFT_ASYNC_CPP2CONNCONTEXT_H_ 1
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
+#include <folly/Optional.h>
 #include <folly/SocketAddress.h>
 #include <thrift/lib/cpp/async/TAsyncTransport.h>
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
@@ -266,6 +269,28 @@ class Cpp2RequestContext : public apache::thrift::server::TConnectionContext {
     requestTimeout_ = requestTimeout;
   }
 
+  // Point in time after which the caller no longer waits for the response,
+  // from the client timeout and the deadline budget of the request.
+  const folly::Optional<std::chrono::steady_clock::time_point>& getDeadline()
+      const {
+    return deadline_;
+  }
+
+  void setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadline_ = deadline;
+  }
+
+  // Time left until the deadline (zero once it has passed), if any.
+  folly::Optional<std::chrono::milliseconds> getTimeRemaining() const {
+    if (!deadline_) {
+      return folly::none;
+    }
+    return std::max(
+        std::chrono::milliseconds::zero(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            *deadline_ - std::chrono::steady_clock::now()));
+  }
+
   void setMethodName(std::string methodName) {
     methodName_ = std::move(methodName);
   }
@@ -299,6 +324,7 @@ class Cpp2RequestContext : public apache::thrift::server::TConnectionContext {
   bool startedProcessing_ = false;
   std::chrono::milliseconds requestTimeout_{0};
   folly::Optional<std::chrono::steady_clock::time_point> processingStartTime_;
+  folly::Optional<std::chrono::steady_clock::time_point> deadline_;
   std::string methodName_;
   int32_t protoSeqId_{0};
   uint32_t messageBeginSize_{0};
@@ -18,6 +18,7 @@
 
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/GeneratedCodeHelper.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/protocol/BinaryProtocol.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/server/Cpp2Worker.h>
@@ -371,6 +372,15 @@ void Cpp2Connection::requestReceived(unique_ptr<ResponseChannelRequest>&& req) {
   auto reqContext = t2r->getContext();
   reqContext->setRequestTimeout(taskTimeout);
 
+  // The caller stops waiting at its own timeout, which it clamps to the
+  // deadline it is itself serving, if any.  Oneway callers do not wait.
+  auto clientTimeout = hreq->getHeader()->getClientTimeout();
+  if (clientTimeout > std::chrono::milliseconds(0) && !hreq->isOneway()) {
+    auto deadline = std::chrono::steady_clock::now() + clientTimeout;
+    reqContext->setDeadline(deadline);
+    RequestDeadline::set(deadline);
+  }
+
   try {
     if (!apache::thrift::detail::ap::deserializeMessageBegin(
             protoId, up2r, buf.get(), reqContext, worker_->getEventBase())) {
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include <glog/logging.h>
+
+#include <folly/concurrency/CacheLocality.h>
+#include <folly/lang/Align.h>
+#include <thrift/lib/cpp2/server/AdmissionController.h>
+
+namespace apache {
+namespace thrift {
+
+struct GradientAdmissionOptions {
+  // Limit used until the first latency measurements come in.
+  uint32_t initialLimit{100};
+  // Also the fewest finished requests an update is based on: an interval in
+  // which fewer finished counts towards the next one, so that neither the
+  // drop ratio nor the latency rests on a handful of requests.
+  uint32_t minLimit{10};
+  uint32_t maxLimit{10000};
+  // How much the current latency may exceed the minimum latency before the
+  // limit starts shrinking. Absorbs normal latency noise.
+  double tolerance{2.0};
+  // Weight of each update in the limit, between 0 and 1.
+  double smoothing{0.2};
+  // Factor applied to the limit for an interval in which admitted requests
+  // were dropped before being processed (e.g. they expired in the queue).
+  double dropBackoff{0.9};
+  // Fraction of the requests finished in an interval that must have been
+  // dropped for the backoff to apply, so that a few requests cancelled by
+  // their clients do not shrink the limit.
+  double dropThreshold{0.05};
+  std::chrono::milliseconds updateInterval{100};
+  // The minimum latency is forgotten after between one and two of these, so
+  // that it follows the workload when requests get more expensive.
+  std::chrono::seconds minLatencyWindow{30};
+};
+
+/**
+ * This admission controller limits the number of requests in the server
+ * (queued or processing) and adapts that limit to the measured latency,
+ * in the spirit of TCP Vegas and of gradient concurrency limiters:
+ *
+ * - The minimum latency seen recently approximates the latency of an
+ *   unloaded server.
+ * - Every `updateInterval`, the average latency of the finished requests is
+ *   compared to it. gradient = tolerance * minLatency / latency, clamped to
+ *   [0.5, 1].
+ * - newLimit = limit * gradient + sqrt(limit): when latency does not inflate
+ *   the limit probes upwards by a queue of sqrt(limit) requests, when it does
+ *   the limit shrinks proportionally.
+ *
+ * The limit only grows while the server actually uses at least half of it,
+ * so that an idle server doesn't accumulate an arbitrarily large limit.
+ *
+ * Unlike QIAdmissionController, there is no timeout or window to tune per
+ * service: the latency the limit converges to is relative to the service's
+ * own minimum latency.
+ *
+ * Like QIAdmissionController, the request path is lock-free: latency samples
+ * go to striped accumulators that one thread folds into the limit per
+ * `updateInterval`.
+ */
+template <class Clock = std::chrono::steady_clock>
+class GradientAdmissionController : public AdmissionController {
+ public:
+  using Duration = typename Clock::duration;
+  using TimePoint = typename Clock::time_point;
+
+  explicit GradientAdmissionController(
+      GradientAdmissionOptions options = GradientAdmissionOptions())
+      : options_(std::move(options)),
+        updateInterval_(
+            std::chrono::duration_cast<Duration>(options_.updateInterval)),
+        minLatencyWindow_(
+            std::chrono::duration_cast<Duration>(options_.minLatencyWindow)),
+        lastUpdate_(Clock::now()),
+        minLatencyWindowStart_(lastUpdate_) {
+    CHECK_LE(options_.minLimit, options_.maxLimit);
+    CHECK(options_.smoothing > 0 && options_.smoothing <= 1);
+    CHECK(options_.dropThreshold >= 0 && options_.dropThreshold < 1);
+    limit_ = clampLimit(options_.initialLimit);
+    limitAtomic_.store(
+        static_cast<uint32_t>(std::lround(limit_)), std::memory_order_relaxed);
+    nextUpdateNanos_.store(
+        toNanos(lastUpdate_ + updateInterval_), std::memory_order_relaxed);
+  }
+
+  ~GradientAdmissionController() override {}
+
+  bool admit() override {
+    const auto limit = limitAtomic_.load(std::memory_order_relaxed);
+    auto inflight = inflight_.load(std::memory_order_relaxed);
+    do {
+      if (inflight >= limit) {
+        FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: inflight(" << inflight
+                                    << ") >= limit(" << limit << ")";
+        return false;
+      }
+    } while (!inflight_.compare_exchange_weak(
+        inflight, inflight + 1, std::memory_order_relaxed));
+
+    auto peak = peakInflight_.load(std::memory_order_relaxed);
+    while (inflight + 1 > peak &&
+           !peakInflight_.compare_exchange_weak(
+               peak, inflight + 1, std::memory_order_relaxed)) {
+    }
+    return true;
+  }
+
+  // Queueing time is part of the latency measured by requestFinished().
+  void dequeue() override {}
+
+  void returnedResponse(std::chrono::nanoseconds) override {}
+
+  void requestFinished(std::chrono::nanoseconds sinceAdmission, bool processed)
+      override {
+    auto& stripe = stripes_[folly::AccessSpreader<>::current(kNumStripes)];
+    if (processed) {
+      stripe.samples.fetch_add(1, std::memory_order_relaxed);
+      stripe.latencyNanos.fetch_add(
+          sinceAdmission.count(), std::memory_order_relaxed);
+    } else {
+      stripe.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto previous = inflight_.fetch_sub(1, std::memory_order_relaxed);
+    DCHECK_GE(previous, 1u);
+    maybeUpdate(Clock::now());
+  }
+
+  /**
+   * Maximum number of admitted requests (queued or processing) allowed at
+   * once.
+   */
+  uint32_t getLimit() const {
+    return limitAtomic_.load(std::memory_order_relaxed);
+  }
+
+  void reportMetrics(
+      const AdmissionController::MetricReportFn& report,
+      const std::string& prefix,
+      const std::unordered_map<std::string, double>& metrics,
+      uint32_t count) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    reportAggregate(prefix + "limit", metrics, report, SUM, getLimit(), count);
+    reportAggregate(
+        prefix + "inflight",
+        metrics,
+        report,
+        SUM,
+        inflight_.load(std::memory_order_relaxed),
+        count);
+    reportAggregate(
+        prefix + "latency_ms", metrics, report, AVG, toMillis(latency_), count);
+    reportAggregate(
+        prefix + "min_latency_ms",
+        metrics,
+        report,
+        AVG,
+        toMillis(getMinLatency()),
+        count);
+    reportAggregate(
+        prefix + "gradient", metrics, report, AVG, gradient_, count);
+  }
+
+ private:
+  static constexpr size_t kNumStripes = 64;
+  static constexpr double kMinGradient = 0.5;
+
+  struct alignas(folly::hardware_destructive_interference_size) Stripe {
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> latencyNanos{0};
+    std::atomic<uint64_t> dropped{0};
+  };
+
+  void maybeUpdate(TimePoint now) {
+    if (toNanos(now) < nextUpdateNanos_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || now < lastUpdate_ + updateInterval_) {
+      return;
+    }
+    lastUpdate_ = now;
+    nextUpdateNanos_.store(
+        toNanos(now + updateInterval_), std::memory_order_relaxed);
+
+    uint64_t finished = 0;
+    for (auto& stripe : stripes_) {
+      finished += stripe.samples.load(std::memory_order_relaxed) +
+          stripe.dropped.load(std::memory_order_relaxed);
+    }
+    if (finished < options_.minLimit) {
+      return;
+    }
+
+    uint64_t samples = 0;
+    uint64_t latencyNanos = 0;
+    uint64_t dropped = 0;
+    for (auto& stripe : stripes_) {
+      samples += stripe.samples.exchange(0, std::memory_order_relaxed);
+      latencyNanos +=
+          stripe.latencyNanos.exchange(0, std::memory_order_relaxed);
+      dropped += stripe.dropped.exchange(0, std::memory_order_relaxed);
+    }
+    const auto peak = peakInflight_.exchange(
+        inflight_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    double newLimit = limit_;
+    if (dropped > options_.dropThreshold * (samples + dropped)) {
+      newLimit = limit_ * options_.dropBackoff;
+    } else if (samples > 0) {
+      latency_ = double(latencyNanos) / samples;
+      updateMinLatency(now, latency_);
+      gradient_ = std::max(
+          kMinGradient,
+          std::min(1.0, options_.tolerance * getMinLatency() / latency_));
+      newLimit = limit_ * gradient_ + std::sqrt(limit_);
+      if (peak < limit_ / 2) {
+        newLimit = std::min(newLimit, limit_);
+      }
+    } else {
+      return;
+    }
+
+    limit_ = clampLimit(
+        (1 - options_.smoothing) * limit_ + options_.smoothing * newLimit);
+    limitAtomic_.store(
+        static_cast<uint32_t>(std::lround(limit_)), std::memory_order_relaxed);
+  }
+
+  /**
+   * Windowed minimum over the interval averages: the minimum of the current
+   * window and of the previous one, so the estimate never covers less than a
+   * full window.
+   */
+  void updateMinLatency(TimePoint now, double latency) {
+    if (now - minLatencyWindowStart_ >= minLatencyWindow_) {
+      previousMinLatency_ = currentMinLatency_;
+      currentMinLatency_ = kNoLatency;
+      minLatencyWindowStart_ = now;
+    }
+    currentMinLatency_ = std::min(currentMinLatency_, latency);
+  }
+
+  double getMinLatency() const {
+    auto minLatency = std::min(previousMinLatency_, currentMinLatency_);
+    return minLatency == kNoLatency ? 0 : minLatency;
+  }
+
+  double clampLimit(double limit) const {
+    return std::max<double>(
+        options_.minLimit, std::min<double>(options_.maxLimit, limit));
+  }
+
+  static int64_t toNanos(TimePoint time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
+  }
+
+  static double toMillis(double nanos) {
+    return nanos / 1e6;
+  }
+
+  static constexpr double kNoLatency = std::numeric_limits<double>::max();
+
+  const GradientAdmissionOptions options_;
+  const Duration updateInterval_;
+  const Duration minLatencyWindow_;
+
+  std::mutex mutex_;
+  // Accesses to the following members should lock mutex_
+  double limit_;
+  double latency_{0};
+  double gradient_{1};
+  double previousMinLatency_{kNoLatency};
+  double currentMinLatency_{kNoLatency};
+  TimePoint lastUpdate_;
+  TimePoint minLatencyWindowStart_;
+
+  // Lock-free state shared by admit() and requestFinished().
+  std::atomic<uint32_t> inflight_{0};
+  std::atomic<uint32_t> peakInflight_{0};
+  std::atomic<uint32_t> limitAtomic_{0};
+  std::atomic<int64_t> nextUpdateNanos_{0};
+  std::array<Stripe, kNumStripes> stripes_;
+};
+
+template <class Clock>
+constexpr size_t GradientAdmissionController<Clock>::kNumStripes;
+
+template <class Clock>
+constexpr double GradientAdmissionController<Clock>::kMinGradient;
+
+template <class Clock>
+constexpr double GradientAdmissionController<Clock>::kNoLatency;
+
+} // namespace thrift
+} // namespace apache
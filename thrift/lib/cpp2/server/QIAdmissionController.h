@@ -17,12 +17,16 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <thread>
 
 #include <glog/logging.h>
 
+#include <folly/concurrency/CacheLocality.h>
+#include <folly/lang/Align.h>
 #include <folly/stats/BucketedTimeSeries-defs.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/server/AdmissionController.h>
@@ -49,6 +53,12 @@ namespace thrift {
  *
  * It is somewhat inspired by a PID controller which would be continuously
  * and dynamically tuned (without a derivative component).
+ *
+ * admit(), dequeue() and returnedResponse() run on every IO thread for every
+ * request, so they don't take a lock: the queue size is a single atomic, and
+ * responses and the queue integral go to striped accumulators that are folded
+ * into the time series (and the queue limit recomputed) at most once per
+ * time series bucket, by whichever thread gets there first.
  */
 template <class Clock = std::chrono::steady_clock>
 class QIAdmissionController : public AdmissionController {
@@ -65,9 +75,19 @@ class QIAdmissionController : public AdmissionController {
       : windowSec_(toDoubleSecond(window)),
         processTimeoutSec_(toDoubleSecond(processTimeout)),
         minQueueLength_(minQueueLength),
-        outgoingRate_(folly::BucketedTimeSeries<double, Clock>(128U, window)),
-        integral_(folly::BucketedTimeSeries<double, Clock>(128U, window)),
-        queueSize_(0) {}
+        foldInterval_(std::max(
+            Duration(1),
+            window / static_cast<typename Duration::rep>(kNumBuckets))),
+        outgoingRate_(
+            folly::BucketedTimeSeries<double, Clock>(kNumBuckets, window)),
+        integral_(
+            folly::BucketedTimeSeries<double, Clock>(kNumBuckets, window)),
+        lastFold_(Clock::now()) {
+    lastFoldNanos_.store(toNanos(lastFold_), std::memory_order_relaxed);
+    nextFoldNanos_.store(
+        toNanos(lastFold_ + foldInterval_), std::memory_order_relaxed);
+    queueLimit_.store(getQueueLimit(), std::memory_order_relaxed);
+  }
 
   /**
    * Return true if the message should be admitted.
@@ -75,16 +95,19 @@ class QIAdmissionController : public AdmissionController {
    * queueSize is unchanged.
    */
   bool admit() override {
-    std::lock_guard<std::mutex> guard(mutex_);
     auto now = Clock::now();
-    updateIntegral(queueSize_, now);
-    const auto qLimit = getQueueLimit();
-    if (queueSize_ >= qLimit) {
-      FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: q(" << queueSize_
-                                  << ") >= qlimit(" << qLimit << ")";
-      return reject();
-    }
-    return accept();
+    maybeFold(now);
+    const auto qLimit = queueLimit_.load(std::memory_order_relaxed);
+    auto queueSize = queueSize_.load(std::memory_order_relaxed);
+    do {
+      if (queueSize >= qLimit) {
+        FB_LOG_EVERY_MS(INFO, 1000) << "LoadShedding: q(" << queueSize
+                                    << ") >= qlimit(" << qLimit << ")";
+        return reject();
+      }
+    } while (!queueSize_.compare_exchange_weak(
+        queueSize, queueSize + 1, std::memory_order_relaxed));
+    return accept(now);
   }
 
   /**
@@ -92,11 +115,13 @@ class QIAdmissionController : public AdmissionController {
    * currently processing it.
    */
   void dequeue() override {
-    std::lock_guard<std::mutex> guard(mutex_);
     auto now = Clock::now();
-    CHECK(queueSize_ >= 1);
-    updateIntegral(queueSize_, now);
-    queueSize_ -= 1;
+    maybeFold(now);
+    // Recorded first, so a fold which sees the smaller queue size also sees
+    // the change (see fold()).
+    recordQueueChange(-1, now);
+    auto previous = queueSize_.fetch_sub(1, std::memory_order_release);
+    CHECK(previous >= 1);
   }
 
   /**
@@ -105,17 +130,22 @@ class QIAdmissionController : public AdmissionController {
    */
   void returnedResponse(std::chrono::nanoseconds) override {
     auto now = Clock::now();
-    std::lock_guard<std::mutex> guard(mutex_);
-    outgoingRate_.addValue(now, 1.0);
+    maybeFold(now);
+    stripe().responses.fetch_add(1, std::memory_order_relaxed);
   }
 
  private:
+  // Matches the time series granularity: folding more often than once per
+  // bucket would not change what the estimates can resolve.
+  static constexpr size_t kNumBuckets = 128;
+  static constexpr size_t kNumStripes = 64;
+
   double getResponseRate() const {
     return outgoingRate_.sum() / windowSec_;
   }
 
   size_t getQueueSize() const {
-    return queueSize_;
+    return queueSize_.load(std::memory_order_relaxed);
   }
 
   double getIntegral() const {
@@ -165,6 +195,9 @@ class QIAdmissionController : public AdmissionController {
       const std::string& prefix,
       const std::unordered_map<std::string, double>& metrics,
       uint32_t count) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // Report current values rather than the ones as of the last fold.
+    fold(Clock::now());
     // Except `integral_ratio`, all of the aggregations below use sum,
     // because the requests are dispatched to each admission controller, thus
     // things like max are actually computed on a per controller basis.
@@ -218,52 +251,84 @@ class QIAdmissionController : public AdmissionController {
     return false;
   }
 
-  bool accept() {
-    queueSize_ += 1;
+  bool accept(TimePoint now) {
+    recordQueueChange(1, now);
     return true;
   }
 
+  struct alignas(folly::hardware_destructive_interference_size) Stripe {
+    std::atomic<uint64_t> responses{0};
+    // Sum of (queue size change * nanoseconds since the last fold).
+    std::atomic<int64_t> weightedChanges{0};
+  };
+
+  Stripe& stripe() {
+    return stripes_[folly::AccessSpreader<>::current(kNumStripes)];
+  }
+
   /**
-   * Report the metrics and aggregate it with the previous value if metrics is
-   * non-empty.
-   * This can be useful for aggregating metrics accros similar admission
-   * controllers, e.g. the priority admission controller creates *many*
-   * sub-controllers (controller.A.1.xyz, controller.A.2.xyz, ...,
-   * controller.A.128.xyz)
-   * Those metrics are aggregated under controller.A.xyz
+   * Record that the queue size changed by 'delta' at 'now'. The integral of
+   * the queue size over [lastFold, fold] is
+   *   queueSize(fold) * (fold - lastFold) - sum(delta_i * (t_i - lastFold))
+   * so this is all a fold needs besides the queue size itself.
+   *
+   * Nothing stops a fold from running between a change of the queue size and
+   * its record, so a fold may count a change in the wrong interval. Each such
+   * race is off by one request for at most one fold interval, which the
+   * integral over the whole window absorbs. A change taking place before a
+   * concurrent fold is counted from the start of the next interval.
    */
-  void reportAggregate(
-      const std::string& metricName,
-      const std::unordered_map<std::string, double>& metrics,
-      const AdmissionController::MetricReportFn& report,
-      AdmissionController::AggregationType aggType,
-      double newValue,
-      uint32_t count) {
-    auto value = 0.0;
-    auto it = metrics.find(metricName);
-    if (it != metrics.end()) {
-      value = it->second;
+  void recordQueueChange(int64_t delta, TimePoint now) {
+    auto sinceFold = std::max<int64_t>(
+        0, toNanos(now) - lastFoldNanos_.load(std::memory_order_relaxed));
+    stripe().weightedChanges.fetch_add(
+        delta * sinceFold, std::memory_order_relaxed);
+  }
+
+  void maybeFold(TimePoint now) {
+    if (toNanos(now) < nextFoldNanos_.load(std::memory_order_relaxed)) {
+      return;
     }
-    switch (aggType) {
-      case AdmissionController::AggregationType::SUM:
-        value = value + newValue;
-        break;
-      case AdmissionController::AggregationType::AVG:
-        value = (value * (count - 1) + newValue) / std::max(1U, count);
-        break;
+    // Whoever holds the lock is folding already; the estimates it computes
+    // are as fresh as ours would be.
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || now < lastFold_ + foldInterval_) {
+      return;
     }
-    report(metricName, value);
+    fold(now);
   }
 
-  /**
-   * Update the integral value with the queue value for the last interval
-   */
-  void updateIntegral(
-      size_t valueForLastInterval,
-      typename Clock::time_point now) {
-    double dt =
-        std::chrono::duration<double>(now - integral_.getLatestTime()).count();
-    integral_.addValue(now, valueForLastInterval * dt);
+  // Must hold mutex_.
+  void fold(TimePoint now) {
+    // Pairs with dequeue(), which records its change before publishing it.
+    // admit() can only record after its compare-exchange succeeds.
+    const auto queueSize = queueSize_.load(std::memory_order_acquire);
+    uint64_t responses = 0;
+    int64_t weightedChanges = 0;
+    for (auto& stripe : stripes_) {
+      responses += stripe.responses.exchange(0, std::memory_order_relaxed);
+      weightedChanges +=
+          stripe.weightedChanges.exchange(0, std::memory_order_relaxed);
+    }
+    if (responses > 0) {
+      outgoingRate_.addValue(now, responses);
+    }
+    const double elapsedNanos = toNanos(now) - toNanos(lastFold_);
+    const double integralNanos =
+        queueSize * elapsedNanos - double(weightedChanges);
+    integral_.addValue(now, std::max(0.0, integralNanos) / 1e9);
+
+    lastFold_ = now;
+    lastFoldNanos_.store(toNanos(now), std::memory_order_relaxed);
+    nextFoldNanos_.store(
+        toNanos(now + foldInterval_), std::memory_order_relaxed);
+    queueLimit_.store(getQueueLimit(), std::memory_order_relaxed);
+  }
+
+  static int64_t toNanos(TimePoint time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
   }
 
   static double toDoubleSecond(Duration duration) {
@@ -274,13 +339,27 @@ class QIAdmissionController : public AdmissionController {
   const double windowSec_;
   const double processTimeoutSec_;
   const double minQueueLength_;
+  const Duration foldInterval_;
 
   std::mutex mutex_;
   // Accesses to the following members should lock mutex_
   folly::BucketedTimeSeries<double, Clock> outgoingRate_;
   folly::BucketedTimeSeries<double, Clock> integral_;
-  size_t queueSize_;
+  TimePoint lastFold_;
+
+  // Lock-free state shared by admit(), dequeue() and returnedResponse().
+  std::atomic<size_t> queueSize_{0};
+  std::atomic<double> queueLimit_{0};
+  std::atomic<int64_t> lastFoldNanos_{0};
+  std::atomic<int64_t> nextFoldNanos_{0};
+  std::array<Stripe, kNumStripes> stripes_;
 };
 
+template <class Clock>
+constexpr size_t QIAdmissionController<Clock>::kNumBuckets;
+
+template <class Clock>
+constexpr size_t QIAdmissionController<Clock>::kNumStripes;
+
 } // namespace thrift
 } // namespace apache
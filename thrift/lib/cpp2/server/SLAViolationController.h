@@ -102,6 +102,11 @@ class SLAViolationController : public AdmissionController {
     innerController_.returnedResponse(latency);
   }
 
+  void requestFinished(std::chrono::nanoseconds sinceAdmission, bool processed)
+      override {
+    innerController_.requestFinished(sinceAdmission, processed);
+  }
+
  private:
   InnerAdmissionController innerController_;
   const std::chrono::nanoseconds sla_;
@@ -44,6 +44,11 @@ class ServerConfigs {
    */
   virtual uint64_t getMaxResponseSize() const = 0;
 
+  /**
+   * @see BaseThriftServer::getMaxUncompressedRequestSize function.
+   */
+  virtual uint64_t getMaxUncompressedRequestSize() const = 0;
+
   /**
    * @see BaseThriftServer::getTaskExpireTimeForRequest function.
    */
@@ -68,6 +73,11 @@ class ServerConfigs {
       const std::string& counter = "",
       bool check_custom = true) const = 0;
 
+  // @see ThriftServer::getMinCompressBytes function.
+  virtual uint32_t getMinCompressBytes() const {
+    return 0;
+  }
+
   // @see @BaseThriftServer::getOverloadedErrorCode function.
   virtual const std::string& getOverloadedErrorCode() const = 0;
 
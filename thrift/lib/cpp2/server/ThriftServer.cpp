@@ -356,9 +356,13 @@ void ThriftServer::setupThreadManager() {
   if (!threadManager_) {
     auto nPoolThreads = getNumCPUWorkerThreads();
     int numThreads = nPoolThreads > 0 ? nPoolThreads : getNumIOWorkerThreads();
+    auto numShards = getNumThreadManagerShards();
+    if (numShards == 0) {
+      numShards = getNumIOWorkerThreads();
+    }
     std::shared_ptr<apache::thrift::concurrency::ThreadManager> threadManager(
         PriorityThreadManager::newPriorityThreadManager(
-            numThreads, true /*stats*/));
+            numThreads, true /*stats*/, numShards));
     threadManager->enableCodel(getEnableCodel());
     // If a thread factory has been specified, use it.
     if (threadFactory_) {
@@ -36,6 +36,7 @@
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 #include <thrift/lib/cpp/server/TServerObserver.h>
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp2/Thrift.h>
 #include <thrift/lib/cpp2/async/AsyncProcessor.h>
 #include <thrift/lib/cpp2/async/HeaderServerChannel.h>
@@ -571,13 +572,13 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
    *
    * @return minimum response compression size
    */
-  uint32_t getMinCompressBytes() const {
+  uint32_t getMinCompressBytes() const override {
     return minCompressBytes_;
   }
 
   /**
-   * Set the minimum compressioin size
-   *
+   * Set the minimum compression size. Applies to header transforms and to
+   * rocket responses whose client accepts payload compression.
    */
   void setMinCompressBytes(uint32_t bytes) {
     minCompressBytes_ = bytes;
@@ -606,6 +607,15 @@ class ThriftServer : public apache::thrift::BaseThriftServer,
     writeTrans_.clear();
   }
 
+  /**
+   * Loads a dictionary trained by ZstdDictionaryTrainer, so that ZSTD_TRANSFORM
+   * requests compressed against it can be read. Replies reuse the request's
+   * dictionary. Loaded dictionaries are shared by the whole process.
+   */
+  void loadZstdDictionary(folly::ByteRange dictionary) {
+    transport::registerZstdDictionary(dictionary);
+  }
+
   /**
    * Call this to complete initialization
    */
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <folly/Synchronized.h>
+
+#include <thrift/lib/cpp2/server/AdmissionController.h>
+#include <thrift/lib/cpp2/server/GradientAdmissionController.h>
+#include <thrift/lib/cpp2/server/admission_strategy/AdmissionStrategy.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * GradientAdmissionStrategy gives every (method, clientId) pair its own
+ * GradientAdmissionController, so each one converges to a concurrency limit
+ * matching its own latency profile without any per-service tuning.
+ *
+ * Requests without a clientId (or if `clientIdHeaderName` is empty) share one
+ * controller per method. Method names and clientIds come from the wire, so
+ * to bound memory:
+ * - if `knownMethods` is not empty, any other method shares the "*" method's
+ *   controllers (pass e.g. the keys of the generated processor's
+ *   getBinaryProtocolProcessMap()),
+ * - methods beyond `maxMethods` share the "*" method's controllers,
+ * - clients beyond `maxClientsPerMethod` share their method's "*" controller.
+ *
+ * reportMetrics() exports at most `maxReportedClientsPerMethod` per-client
+ * controllers per method, besides the method's "*" controller.
+ */
+class GradientAdmissionStrategy : public AdmissionStrategy {
+ public:
+  using AdmissionControllerFactoryFn =
+      folly::Function<std::shared_ptr<AdmissionController>(
+          const std::string& methodName,
+          const std::string& clientId)>;
+
+  explicit GradientAdmissionStrategy(
+      const std::string& clientIdHeaderName,
+      GradientAdmissionOptions options = GradientAdmissionOptions(),
+      std::unordered_set<std::string> knownMethods = {})
+      : GradientAdmissionStrategy(
+            [options](auto&, auto&) {
+              return std::make_shared<GradientAdmissionController<>>(options);
+            },
+            clientIdHeaderName,
+            1000,
+            100,
+            std::move(knownMethods)) {}
+
+  GradientAdmissionStrategy(
+      AdmissionControllerFactoryFn factory,
+      const std::string& clientIdHeaderName,
+      size_t maxMethods = 1000,
+      size_t maxClientsPerMethod = 100,
+      std::unordered_set<std::string> knownMethods = {},
+      size_t maxReportedClientsPerMethod = 10)
+      : factory_(std::move(factory)),
+        clientIdHeaderName_(clientIdHeaderName),
+        maxMethods_(maxMethods),
+        maxClientsPerMethod_(maxClientsPerMethod),
+        knownMethods_(std::move(knownMethods)),
+        maxReportedClientsPerMethod_(maxReportedClientsPerMethod) {}
+
+  ~GradientAdmissionStrategy() {}
+
+  /**
+   * Select an AdmissionController to be used for this specific request.
+   * It returns one shared AdmissionController per (method, clientId).
+   */
+  std::shared_ptr<AdmissionController> select(
+      const std::string& methodName,
+      const transport::THeader* theader) override {
+    const std::string* clientId = getClientId(theader);
+    const std::string& methodKey = getMethodKey(methodName);
+    {
+      // Fast path
+      auto readOnlyControllers = controllers_.rlock();
+      auto methodIt = readOnlyControllers->find(methodKey);
+      if (methodIt == readOnlyControllers->end() &&
+          readOnlyControllers->size() >= maxMethods_) {
+        methodIt = readOnlyControllers->find(kWildcard);
+      }
+      if (methodIt != readOnlyControllers->end()) {
+        const auto& method = methodIt->second;
+        if (clientId == nullptr) {
+          return method.wildcard;
+        }
+        auto clientIt = method.clients.find(*clientId);
+        if (clientIt != method.clients.end()) {
+          return clientIt->second;
+        }
+        if (method.clients.size() >= maxClientsPerMethod_) {
+          return method.wildcard;
+        }
+      }
+    }
+
+    // Slow path, initialization of the admission controller
+    auto readWriteControllers = controllers_.wlock();
+    auto methodIt = readWriteControllers->find(methodKey);
+    if (methodIt == readWriteControllers->end()) {
+      std::string key =
+          readWriteControllers->size() >= maxMethods_ ? kWildcard : methodKey;
+      methodIt = readWriteControllers->emplace(key, MethodControllers()).first;
+    }
+    auto& method = methodIt->second;
+    if (!method.wildcard) {
+      method.wildcard = factory_(methodIt->first, kWildcard);
+    }
+    if (clientId == nullptr) {
+      return method.wildcard;
+    }
+    auto clientIt = method.clients.find(*clientId);
+    if (clientIt != method.clients.end()) {
+      return clientIt->second;
+    }
+    if (method.clients.size() >= maxClientsPerMethod_) {
+      return method.wildcard;
+    }
+    auto admController = factory_(methodIt->first, *clientId);
+    method.clients.emplace(*clientId, admController);
+    return admController;
+  }
+
+  void reportMetrics(
+      const AdmissionStrategy::MetricReportFn& report,
+      const std::string& prefix) override {
+    auto controllers = controllers_.rlock();
+    for (const auto& methodEntry : *controllers) {
+      const auto methodPrefix = prefix + "gradient." + methodEntry.first + ".";
+      const auto& method = methodEntry.second;
+      method.wildcard->reportMetrics(report, methodPrefix + kWildcard + ".");
+      size_t reportedClients = 0;
+      for (const auto& clientEntry : method.clients) {
+        if (reportedClients++ >= maxReportedClientsPerMethod_) {
+          break;
+        }
+        clientEntry.second->reportMetrics(
+            report, methodPrefix + clientEntry.first + ".");
+      }
+    }
+  }
+
+  Type getType() override {
+    return AdmissionStrategy::GRADIENT;
+  }
+
+ private:
+  struct MethodControllers {
+    // Shared by requests without a clientId and by clients beyond
+    // maxClientsPerMethod_.
+    std::shared_ptr<AdmissionController> wildcard;
+    std::unordered_map<std::string, std::shared_ptr<AdmissionController>>
+        clients;
+  };
+
+  const std::string& getMethodKey(const std::string& methodName) const {
+    if (knownMethods_.empty() || knownMethods_.count(methodName)) {
+      return methodName;
+    }
+    return wildcardMethod_;
+  }
+
+  const std::string* getClientId(const transport::THeader* theader) const {
+    if (theader == nullptr || clientIdHeaderName_.empty()) {
+      return nullptr;
+    }
+    const auto& headers = theader->getHeaders();
+    auto it = headers.find(clientIdHeaderName_);
+    if (it == headers.end() || it->second == kWildcard) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  AdmissionControllerFactoryFn factory_;
+  folly::Synchronized<std::unordered_map<std::string, MethodControllers>>
+      controllers_;
+  const std::string clientIdHeaderName_;
+  const size_t maxMethods_;
+  const size_t maxClientsPerMethod_;
+  const std::unordered_set<std::string> knownMethods_;
+  const size_t maxReportedClientsPerMethod_;
+  const std::string wildcardMethod_{kWildcard};
+};
+
+} // namespace thrift
+} // namespace apache
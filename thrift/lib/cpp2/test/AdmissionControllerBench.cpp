@@ -0,0 +1,138 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/portability/GFlags.h>
+
+#include <thrift/lib/cpp2/server/AdmissionController.h>
+#include <thrift/lib/cpp2/server/QIAdmissionController.h>
+
+using namespace apache::thrift;
+
+namespace {
+
+/**
+ * Serializes every call through one mutex, which is what every IO thread of
+ * a server paid per request before QIAdmissionController went lock-free.
+ */
+class SerializedAdmissionController : public AdmissionController {
+ public:
+  explicit SerializedAdmissionController(
+      std::unique_ptr<AdmissionController> controller)
+      : controller_(std::move(controller)) {}
+
+  bool admit() override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return controller_->admit();
+  }
+
+  void dequeue() override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    controller_->dequeue();
+  }
+
+  void returnedResponse(std::chrono::nanoseconds latency) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    controller_->returnedResponse(latency);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unique_ptr<AdmissionController> controller_;
+};
+
+std::unique_ptr<AdmissionController> makeQI() {
+  // A large minimum queue keeps every request admitted, so each iteration
+  // runs the full admit/dequeue/returnedResponse sequence.
+  return std::make_unique<QIAdmissionController<>>(
+      std::chrono::seconds(1), std::chrono::seconds(10), 1 << 20);
+}
+
+void runRequests(
+    AdmissionController& controller,
+    size_t iters,
+    size_t numThreads) {
+  std::vector<std::thread> threads;
+  auto perThread = std::max<size_t>(1, iters / numThreads);
+  for (size_t t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&controller, perThread] {
+      for (size_t i = 0; i < perThread; ++i) {
+        if (controller.admit()) {
+          controller.dequeue();
+          controller.returnedResponse(std::chrono::microseconds(100));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void acceptAll(size_t iters, size_t numThreads) {
+  std::unique_ptr<AdmissionController> controller;
+  BENCHMARK_SUSPEND {
+    controller = std::make_unique<AcceptAllAdmissionController>();
+  }
+  runRequests(*controller, iters, numThreads);
+}
+
+void qi(size_t iters, size_t numThreads) {
+  std::unique_ptr<AdmissionController> controller;
+  BENCHMARK_SUSPEND {
+    controller = makeQI();
+  }
+  runRequests(*controller, iters, numThreads);
+}
+
+void serializedQI(size_t iters, size_t numThreads) {
+  std::unique_ptr<AdmissionController> controller;
+  BENCHMARK_SUSPEND {
+    controller = std::make_unique<SerializedAdmissionController>(makeQI());
+  }
+  runRequests(*controller, iters, numThreads);
+}
+
+} // namespace
+
+BENCHMARK_PARAM(acceptAll, 1)
+BENCHMARK_RELATIVE_PARAM(qi, 1)
+BENCHMARK_RELATIVE_PARAM(serializedQI, 1)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(acceptAll, 16)
+BENCHMARK_RELATIVE_PARAM(qi, 16)
+BENCHMARK_RELATIVE_PARAM(serializedQI, 16)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(acceptAll, 64)
+BENCHMARK_RELATIVE_PARAM(qi, 64)
+BENCHMARK_RELATIVE_PARAM(serializedQI, 64)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(acceptAll, 128)
+BENCHMARK_RELATIVE_PARAM(qi, 128)
+BENCHMARK_RELATIVE_PARAM(serializedQI, 128)
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -19,10 +19,14 @@
  * under the License.
  */
 
+#include <thrift/lib/cpp2/server/GradientAdmissionController.h>
 #include <thrift/lib/cpp2/server/QIAdmissionController.h>
 #include <thrift/lib/cpp2/server/SLAViolationController.h>
 
+#include <atomic>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -178,6 +182,158 @@ TEST_F(AdmissionControllerTest, steadyMaxRPS) {
   ASSERT_NEAR(rejected, 10, 4);
 }
 
+TEST_F(AdmissionControllerTest, concurrentAdmitNeverExceedsLimit) {
+  constexpr int minQueueLength = 10;
+  QIAdmissionController<FakeClock> controller(
+      seconds(1), seconds(5), minQueueLength);
+
+  // Without dequeues the queue limit holds exactly, however many threads race
+  // to fill it.
+  std::atomic<int> admitted{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 64; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 100; i++) {
+        if (controller.admit()) {
+          admitted++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(minQueueLength, admitted.load());
+
+  for (int i = 0; i < minQueueLength; i++) {
+    controller.dequeue();
+  }
+  ASSERT_TRUE(controller.admit());
+}
+
+namespace {
+
+/**
+ * Admit up to `concurrency` requests, let `updateInterval` pass and finish
+ * them all with `latency`. Returns the number of admitted requests.
+ */
+uint32_t runGradientInterval(
+    GradientAdmissionController<FakeClock>& controller,
+    uint32_t concurrency,
+    milliseconds latency) {
+  uint32_t admitted = 0;
+  for (uint32_t i = 0; i < concurrency; i++) {
+    if (controller.admit()) {
+      admitted++;
+    }
+  }
+  FakeClock::advance(milliseconds(100));
+  for (uint32_t i = 0; i < admitted; i++) {
+    controller.dequeue();
+    controller.returnedResponse(latency);
+    controller.requestFinished(latency, true);
+  }
+  return admitted;
+}
+
+} // namespace
+
+TEST_F(AdmissionControllerTest, gradientAdmitRespectsLimit) {
+  GradientAdmissionOptions options;
+  options.initialLimit = 10;
+  options.minLimit = 10;
+  options.maxLimit = 10;
+  GradientAdmissionController<FakeClock> controller(options);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(controller.admit());
+  }
+  ASSERT_FALSE(controller.admit());
+
+  controller.dequeue();
+  controller.requestFinished(milliseconds(1), false);
+  ASSERT_TRUE(controller.admit());
+  ASSERT_FALSE(controller.admit());
+}
+
+TEST_F(AdmissionControllerTest, gradientLimitFollowsLatency) {
+  GradientAdmissionOptions options;
+  options.initialLimit = 20;
+  options.minLimit = 5;
+  GradientAdmissionController<FakeClock> controller(options);
+
+  // Latency doesn't inflate while the limit is used: probe upwards.
+  for (int i = 0; i < 30; i++) {
+    runGradientInterval(controller, controller.getLimit(), milliseconds(10));
+  }
+  const auto grownLimit = controller.getLimit();
+  ASSERT_GT(grownLimit, 20u);
+
+  // Latency is 10x the minimum: back off towards the minimum limit.
+  for (int i = 0; i < 50; i++) {
+    auto limit = controller.getLimit();
+    ASSERT_EQ(
+        limit, runGradientInterval(controller, 2 * limit, milliseconds(100)));
+  }
+  const auto shrunkLimit = controller.getLimit();
+  ASSERT_LT(shrunkLimit, grownLimit / 2);
+  ASSERT_GE(shrunkLimit, options.minLimit);
+  ASSERT_EQ(shrunkLimit, runGradientInterval(controller, 1000, seconds(1)));
+
+  // Latency recovers: the limit grows again.
+  for (int i = 0; i < 30; i++) {
+    runGradientInterval(controller, controller.getLimit(), milliseconds(10));
+  }
+  ASSERT_GT(controller.getLimit(), shrunkLimit);
+}
+
+TEST_F(AdmissionControllerTest, gradientDroppedRequestsBackOff) {
+  GradientAdmissionOptions options;
+  options.initialLimit = 100;
+  GradientAdmissionController<FakeClock> controller(options);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(controller.admit());
+  }
+  FakeClock::advance(milliseconds(100));
+  for (int i = 0; i < 10; i++) {
+    controller.dequeue();
+    controller.requestFinished(milliseconds(100), false);
+  }
+  // The update ran on the first drop, too few to evaluate.
+  ASSERT_EQ(100, controller.getLimit());
+
+  FakeClock::advance(milliseconds(100));
+  ASSERT_TRUE(controller.admit());
+  controller.dequeue();
+  controller.requestFinished(milliseconds(100), false);
+  ASSERT_LT(controller.getLimit(), 100);
+}
+
+TEST_F(AdmissionControllerTest, gradientRareDropsDoNotBackOff) {
+  GradientAdmissionOptions options;
+  options.initialLimit = 100;
+  GradientAdmissionController<FakeClock> controller(options);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(controller.admit());
+  }
+  FakeClock::advance(milliseconds(100));
+  controller.dequeue();
+  controller.requestFinished(milliseconds(100), false);
+  for (int i = 1; i < 100; i++) {
+    controller.dequeue();
+    controller.requestFinished(milliseconds(10), true);
+  }
+
+  // Evaluates the drop with the 99 processed requests, and one more.
+  FakeClock::advance(milliseconds(100));
+  ASSERT_TRUE(controller.admit());
+  controller.dequeue();
+  controller.requestFinished(milliseconds(10), true);
+  ASSERT_GE(controller.getLimit(), 100);
+}
+
 TEST_F(AdmissionControllerTest, SLAViolationControllerTest) {
   auto n = 1000;
   auto tolerance = 0.2;
@@ -24,6 +24,7 @@
 #include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/server/QIAdmissionController.h>
 #include <thrift/lib/cpp2/server/admission_strategy/GlobalAdmissionStrategy.h>
+#include <thrift/lib/cpp2/server/admission_strategy/GradientAdmissionStrategy.h>
 #include <thrift/lib/cpp2/server/admission_strategy/PerClientIdAdmissionStrategy.h>
 #include <thrift/lib/cpp2/server/admission_strategy/PriorityAdmissionStrategy.h>
 #include <thrift/lib/cpp2/server/admission_strategy/WhitelistAdmissionStrategy.h>
@@ -199,6 +200,109 @@ TEST_F(AdmissionControllerSelectorTest, whiteListAdmission) {
       nullptr);
 }
 
+TEST_F(AdmissionControllerSelectorTest, gradientAdmission) {
+  GradientAdmissionStrategy selector(
+      [](auto&, auto&) { return std::make_shared<DummyController>(); },
+      kClientId,
+      2 /* maxMethods */,
+      1 /* maxClientsPerMethod */);
+
+  THeader headerA;
+  headerA.setReadHeaders({{kClientId, "A"}});
+  THeader headerB;
+  headerB.setReadHeaders({{kClientId, "B"}});
+  THeader headerNoClientId;
+
+  auto controllerA1 = selector.select("method1", &headerA);
+  ASSERT_EQ(controllerA1, selector.select("method1", &headerA));
+  ASSERT_NE(controllerA1, selector.select("method2", &headerA));
+
+  // Clients beyond maxClientsPerMethod share the method's wildcard
+  auto wildcard1 = selector.select("method1", &headerNoClientId);
+  ASSERT_NE(controllerA1, wildcard1);
+  ASSERT_EQ(wildcard1, selector.select("method1", &headerB));
+  ASSERT_EQ(wildcard1, selector.select("method1", nullptr));
+
+  // Methods beyond maxMethods share the wildcard method
+  auto controllerA3 = selector.select("method3", &headerA);
+  ASSERT_EQ(controllerA3, selector.select("method4", &headerA));
+  ASSERT_NE(controllerA3, controllerA1);
+}
+
+TEST_F(AdmissionControllerSelectorTest, gradientUnknownMethodsShareWildcard) {
+  GradientAdmissionStrategy selector(
+      [](auto&, auto&) { return std::make_shared<DummyController>(); },
+      kClientId,
+      1000 /* maxMethods */,
+      100 /* maxClientsPerMethod */,
+      {"method1"} /* knownMethods */);
+
+  THeader headerA;
+  headerA.setReadHeaders({{kClientId, "A"}});
+
+  auto controllerA1 = selector.select("method1", &headerA);
+  auto controllerA2 = selector.select("method2", &headerA);
+  ASSERT_NE(controllerA1, controllerA2);
+  ASSERT_EQ(controllerA2, selector.select("method3", &headerA));
+  ASSERT_EQ(controllerA2, selector.select("*", &headerA));
+}
+
+TEST_F(AdmissionControllerSelectorTest, gradientReportedClientsBounded) {
+  GradientAdmissionStrategy selector(
+      [](auto&, auto&) {
+        return std::make_shared<GradientAdmissionController<>>();
+      },
+      kClientId,
+      1000 /* maxMethods */,
+      100 /* maxClientsPerMethod */,
+      {} /* knownMethods */,
+      2 /* maxReportedClientsPerMethod */);
+
+  for (const auto& client : {"A", "B", "C", "D"}) {
+    THeader header;
+    header.setReadHeaders({{kClientId, client}});
+    selector.select("myThriftMethod", &header);
+  }
+
+  std::unordered_map<std::string, double> metrics;
+  selector.reportMetrics(
+      [&metrics](auto key, auto value) { metrics.emplace(key, value); },
+      "my_prefix.");
+
+  const std::string prefix = "my_prefix.gradient.myThriftMethod.";
+  ASSERT_EQ(1, metrics.count(prefix + "*.limit"));
+  size_t reportedClients = 0;
+  for (const auto& client : {"A", "B", "C", "D"}) {
+    reportedClients += metrics.count(prefix + client + ".limit");
+  }
+  ASSERT_EQ(2, reportedClients);
+}
+
+TEST_F(AdmissionControllerSelectorTest, gradientMetricsCreated) {
+  GradientAdmissionStrategy selector(kClientId);
+
+  THeader header;
+  header.setReadHeaders({{kClientId, "A"}});
+  selector.select("myThriftMethod", &header);
+
+  std::unordered_map<std::string, double> metrics;
+  selector.reportMetrics(
+      [&metrics](auto key, auto value) { metrics.emplace(key, value); },
+      "my_prefix.");
+
+  const std::string prefix = "my_prefix.gradient.myThriftMethod.";
+  for (const auto& client : {"A", "*"}) {
+    ASSERT_EQ(
+        GradientAdmissionOptions().initialLimit,
+        metrics.at(prefix + client + ".limit"));
+    ASSERT_EQ(0, metrics.at(prefix + client + ".inflight"));
+    ASSERT_NE(metrics.find(prefix + client + ".latency_ms"), metrics.end());
+    ASSERT_NE(
+        metrics.find(prefix + client + ".min_latency_ms"), metrics.end());
+    ASSERT_NE(metrics.find(prefix + client + ".gradient"), metrics.end());
+  }
+}
+
 TEST_F(AdmissionControllerSelectorTest, metricsCreated) {
   GlobalAdmissionStrategy selector(
       std::make_shared<QIAdmissionController<FakeClock>>(
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <thrift/lib/cpp2/test/gen-cpp2/ProtocolBenchDataTableBased_types.h>
 #include <thrift/lib/cpp2/test/gen-cpp2/ProtocolBenchData_types.h>
 
 #include <folly/portability/GFlags.h>
@@ -86,6 +87,29 @@ template <> LargeListMixed create<LargeListMixed>() {
   return LargeListMixed(FRAGILE, vector<Mixed>(1000000, create<Mixed>()));
 }
 
+// The same structs, (de)serialized through the table-driven interpreter.
+using TableBasedSmallInt = table_based::SmallInt;
+using TableBasedSmallString = table_based::SmallString;
+using TableBasedMixed = table_based::Mixed;
+using TableBasedBigListMixed = table_based::BigListMixed;
+
+template <> TableBasedSmallInt create<TableBasedSmallInt>() {
+  return TableBasedSmallInt(FRAGILE, 5);
+}
+
+template <> TableBasedSmallString create<TableBasedSmallString>() {
+  return TableBasedSmallString(FRAGILE, "small string");
+}
+
+template <> TableBasedMixed create<TableBasedMixed>() {
+  return TableBasedMixed(FRAGILE, 5, 12345, true, "hello");
+}
+
+template <> TableBasedBigListMixed create<TableBasedBigListMixed>() {
+  return TableBasedBigListMixed(
+      FRAGILE, vector<TableBasedMixed>(10000, create<TableBasedMixed>()));
+}
+
 template <typename Serializer, typename Struct>
 void writeBench(size_t iters) {
   BenchmarkSuspender susp;
@@ -136,6 +160,10 @@ void readBench(size_t iters) {
   X2(proto, BigListInt) \
   X2(proto, BigListMixed) \
   X2(proto, LargeListMixed) \
+  X2(proto, TableBasedSmallInt) \
+  X2(proto, TableBasedSmallString) \
+  X2(proto, TableBasedMixed) \
+  X2(proto, TableBasedBigListMixed) \
 
 X(Binary)
 X(Compact)
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Same shapes as ProtocolBenchData.thrift, generated with the `table_based`
+// option so ProtocolBench can compare both code paths.
+
+namespace cpp2 table_based
+
+struct SmallInt {
+  1: i32 smallint;
+}
+
+struct SmallString {
+  1: string str;
+}
+
+struct Mixed {
+  1: i32 int32;
+  2: i64 int64;
+  3: bool b;
+  4: string str;
+}
+
+struct BigListMixed {
+  1: list<Mixed> lst;
+}
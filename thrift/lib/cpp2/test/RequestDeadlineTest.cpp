@@ -0,0 +1,135 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+
+#include <folly/io/async/Request.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/async/RequestChannel.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
+#include <thrift/lib/cpp2/transport/core/RpcMetadataUtil.h>
+
+using namespace apache::thrift;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+RequestRpcMetadata makeMetadata(
+    std::chrono::milliseconds timeout,
+    RpcKind kind = RpcKind::SINGLE_REQUEST_SINGLE_RESPONSE,
+    bool inheritDeadline = true) {
+  RpcOptions rpcOptions;
+  rpcOptions.setTimeout(timeout);
+  rpcOptions.setInheritDeadline(inheritDeadline);
+  transport::THeader header;
+  return detail::makeRequestRpcMetadata(
+      rpcOptions, kind, ProtocolId::COMPACT, 0ms, header, {});
+}
+
+} // namespace
+
+TEST(RequestDeadline, noDeadline) {
+  folly::RequestContextScopeGuard rctx;
+  EXPECT_FALSE(RequestDeadline::get());
+  EXPECT_FALSE(RequestDeadline::remaining());
+  EXPECT_EQ(5000ms, RequestDeadline::clampTimeout(5000ms));
+  EXPECT_EQ(0ms, RequestDeadline::clampTimeout(0ms));
+}
+
+TEST(RequestDeadline, keepsEarliest) {
+  folly::RequestContextScopeGuard rctx;
+  auto deadline = Clock::now() + 10s;
+  RequestDeadline::set(deadline);
+  RequestDeadline::set(deadline + 1s);
+  EXPECT_EQ(deadline, *RequestDeadline::get());
+  RequestDeadline::set(deadline - 1s);
+  EXPECT_EQ(deadline - 1s, *RequestDeadline::get());
+}
+
+TEST(RequestDeadline, clampTimeout) {
+  folly::RequestContextScopeGuard rctx;
+  RequestDeadline::set(Clock::now() + 10s);
+  EXPECT_EQ(100ms, RequestDeadline::clampTimeout(100ms));
+  EXPECT_LE(RequestDeadline::clampTimeout(20s), 10s);
+  EXPECT_GT(RequestDeadline::clampTimeout(20s), 9s);
+  // No timeout still waits no longer than the deadline.
+  EXPECT_LE(RequestDeadline::clampTimeout(0ms), 10s);
+  EXPECT_GT(RequestDeadline::clampTimeout(0ms), 9s);
+
+  RequestDeadline::set(Clock::now() - 1s);
+  EXPECT_EQ(0ms, *RequestDeadline::remaining());
+  EXPECT_EQ(1ms, RequestDeadline::clampTimeout(100ms));
+  EXPECT_EQ(1ms, RequestDeadline::clampTimeout(0ms));
+}
+
+TEST(RequestDeadline, makeContext) {
+  folly::RequestContextScopeGuard rctx;
+  auto current = folly::RequestContext::saveContext();
+  EXPECT_EQ(current, RequestDeadline::makeContext(folly::none));
+
+  auto deadline = Clock::now() + 10s;
+  auto context = RequestDeadline::makeContext(deadline);
+  EXPECT_NE(current, context);
+  EXPECT_FALSE(RequestDeadline::get());
+  {
+    folly::RequestContextScopeGuard withDeadline(context);
+    EXPECT_EQ(deadline, *RequestDeadline::get());
+  }
+  EXPECT_FALSE(RequestDeadline::get());
+}
+
+TEST(RequestDeadline, propagatedInRequestMetadata) {
+  folly::RequestContextScopeGuard rctx;
+  auto metadata = makeMetadata(20000ms);
+  EXPECT_EQ(20000, *metadata.clientTimeoutMs_ref());
+  EXPECT_FALSE(metadata.deadlineBudgetMs_ref());
+
+  RequestDeadline::set(Clock::now() + 10s);
+  metadata = makeMetadata(20000ms);
+  EXPECT_LE(*metadata.clientTimeoutMs_ref(), 10000);
+  EXPECT_GT(*metadata.clientTimeoutMs_ref(), 9000);
+  EXPECT_LE(*metadata.deadlineBudgetMs_ref(), 10000);
+  EXPECT_GT(*metadata.deadlineBudgetMs_ref(), 9000);
+
+  // A shorter timeout of the call itself is kept.
+  metadata = makeMetadata(100ms);
+  EXPECT_EQ(100, *metadata.clientTimeoutMs_ref());
+  EXPECT_GT(*metadata.deadlineBudgetMs_ref(), 9000);
+}
+
+TEST(RequestDeadline, notPropagatedWhenDisabled) {
+  folly::RequestContextScopeGuard rctx;
+  RequestDeadline::set(Clock::now() + 10s);
+  auto metadata =
+      makeMetadata(20000ms, RpcKind::SINGLE_REQUEST_SINGLE_RESPONSE, false);
+  EXPECT_EQ(20000, *metadata.clientTimeoutMs_ref());
+  EXPECT_FALSE(metadata.deadlineBudgetMs_ref());
+}
+
+TEST(RequestDeadline, notPropagatedToOnewayOrStreams) {
+  folly::RequestContextScopeGuard rctx;
+  RequestDeadline::set(Clock::now() + 10s);
+  for (auto kind : {RpcKind::SINGLE_REQUEST_NO_RESPONSE,
+                    RpcKind::SINGLE_REQUEST_STREAMING_RESPONSE}) {
+    auto metadata = makeMetadata(20000ms, kind);
+    EXPECT_EQ(20000, *metadata.clientTimeoutMs_ref());
+    EXPECT_FALSE(metadata.deadlineBudgetMs_ref());
+  }
+}
@@ -420,6 +420,44 @@ TEST(SerializationTest, BinarySerializerIOBufSharingManagedBuffer) {
   testIOBufSharingManagedBuffer<BinarySerializer>();
 }
 
+namespace {
+
+template <class Serializer>
+void testZeroCopySerializer() {
+  // Fields split across the chain must still be linked, not copied.
+  char first[kBufSize];
+  char second[kBufSize];
+  memset(first, 'a', sizeof(first));
+  memset(second, 'b', sizeof(second));
+  TestStructIOBuf s;
+  s.buf = folly::IOBuf(folly::IOBuf::WRAP_BUFFER, first, sizeof(first));
+  s.buf.prependChain(folly::IOBuf::wrapBuffer(second, sizeof(second)));
+
+  folly::IOBufQueue q;
+  Serializer::serialize(s, &q);
+  auto s2 = Serializer::template deserialize<TestStructIOBuf>(q.front());
+
+  std::vector<const uint8_t*> expected{s.buf.data(), s.buf.next()->data()};
+  std::vector<const uint8_t*> actual;
+  for (auto& br : s2.buf) {
+    if (!br.empty()) {
+      actual.push_back(br.data());
+    }
+  }
+  EXPECT_EQ(expected, actual);
+  EXPECT_EQ(s.buf.computeChainDataLength(), s2.buf.computeChainDataLength());
+}
+
+} // namespace
+
+TEST(SerializationTest, ZeroCopyCompactSerializerSharesUnmanagedBuffers) {
+  testZeroCopySerializer<ZeroCopyCompactSerializer>();
+}
+
+TEST(SerializationTest, ZeroCopyBinarySerializerSharesUnmanagedBuffers) {
+  testZeroCopySerializer<ZeroCopyBinarySerializer>();
+}
+
 TEST(SerializationTest, UnsignedIntStruct) {
   TestUnsignedIntStruct s;
 
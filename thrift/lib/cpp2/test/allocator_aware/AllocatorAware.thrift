@@ -0,0 +1,33 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated with the `allocator_aware` option.
+
+namespace cpp2 apache.thrift.test
+
+struct Leaf {
+  1: string name;
+  2: list<string> tags;
+}
+
+struct Tree {
+  1: string label;
+  2: list<Leaf> leaves;
+  3: map<string, list<string>> index;
+  4: set<string> names;
+  5: Leaf root;
+  6: i32 version;
+}
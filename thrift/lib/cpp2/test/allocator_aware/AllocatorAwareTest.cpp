@@ -0,0 +1,199 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory_resource>
+#include <string>
+
+#include <folly/io/IOBufQueue.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <thrift/lib/cpp2/test/allocator_aware/gen-cpp2/AllocatorAware_types.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+namespace {
+
+// Long enough to defeat the small string optimization, so that every string
+// below owns an allocation.
+const std::string kLong(64, 'x');
+
+// Arena that records how much was allocated from it.
+class CountingArena : public std::pmr::memory_resource {
+ public:
+  size_t allocated() const {
+    return allocated_;
+  }
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    allocated_ += bytes;
+    return upstream_.allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    upstream_.deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::monotonic_buffer_resource upstream_;
+  size_t allocated_{0};
+};
+
+std::pmr::string longString(const std::string& suffix) {
+  return std::pmr::string(kLong + suffix);
+}
+
+Leaf makeLeaf(const std::string& name) {
+  Leaf leaf;
+  leaf.set_name(longString(name));
+  leaf.tags.push_back(longString(name + "-tag"));
+  return leaf;
+}
+
+// Built on the default heap.
+Tree makeTree() {
+  Tree tree;
+  tree.set_label(longString("label"));
+  tree.leaves.push_back(makeLeaf("a"));
+  tree.leaves.push_back(makeLeaf("b"));
+  tree.index[longString("key")].push_back(longString("value"));
+  tree.names.insert(longString("name"));
+  tree.set_root(makeLeaf("root"));
+  tree.set_version(3);
+  return tree;
+}
+
+// Lower bound on the size of the strings in makeTree(), all of which should
+// end up on the arena when a copy is placed there.
+size_t stringBytes() {
+  return 10 * kLong.size();
+}
+
+template <typename T>
+std::pmr::memory_resource* resourceOf(const T& value) {
+  return value.get_allocator().resource();
+}
+
+void expectOnArena(const Leaf& leaf, std::pmr::memory_resource* arena) {
+  EXPECT_EQ(arena, resourceOf(leaf.get_name()));
+  EXPECT_EQ(arena, resourceOf(leaf.get_tags()));
+  for (const auto& tag : leaf.get_tags()) {
+    EXPECT_EQ(arena, resourceOf(tag));
+  }
+}
+
+void expectOnArena(const Tree& tree, std::pmr::memory_resource* arena) {
+  EXPECT_EQ(arena, resourceOf(tree.get_label()));
+  EXPECT_EQ(arena, resourceOf(tree.get_leaves()));
+  for (const auto& leaf : tree.get_leaves()) {
+    expectOnArena(leaf, arena);
+  }
+  EXPECT_EQ(arena, resourceOf(tree.get_index()));
+  for (const auto& kv : tree.get_index()) {
+    EXPECT_EQ(arena, resourceOf(kv.first));
+    EXPECT_EQ(arena, resourceOf(kv.second));
+    for (const auto& value : kv.second) {
+      EXPECT_EQ(arena, resourceOf(value));
+    }
+  }
+  EXPECT_EQ(arena, resourceOf(tree.get_names()));
+  for (const auto& name : tree.get_names()) {
+    EXPECT_EQ(arena, resourceOf(name));
+  }
+  expectOnArena(tree.get_root(), arena);
+}
+
+template <typename Serializer>
+void checkDeserializeInArena() {
+  auto tree = makeTree();
+  auto bytes = Serializer::template serialize<std::string>(tree);
+
+  CountingArena arena;
+  size_t size = 0;
+  auto copy = Serializer::template deserializeInArena<Tree>(
+      &arena, folly::ByteRange(folly::StringPiece(bytes)), &size);
+  EXPECT_EQ(bytes.size(), size);
+  EXPECT_EQ(tree, copy);
+  expectOnArena(copy, &arena);
+  EXPECT_GE(arena.allocated(), stringBytes());
+
+  folly::IOBufQueue queue;
+  Serializer::serialize(tree, &queue);
+  auto buf = queue.move();
+  CountingArena other;
+  auto fromBuf =
+      Serializer::template deserializeInArena<Tree>(&other, buf.get());
+  EXPECT_EQ(tree, fromBuf);
+  expectOnArena(fromBuf, &other);
+  EXPECT_GE(other.allocated(), stringBytes());
+}
+
+} // namespace
+
+TEST(AllocatorAwareTest, allocatorConstructor) {
+  CountingArena arena;
+  Tree tree(std::allocator_arg, Tree::allocator_type(&arena));
+  expectOnArena(tree, &arena);
+  EXPECT_EQ(0, tree.get_version());
+
+  tree.set_label(longString("label"));
+  tree.leaves.emplace_back();
+  tree.leaves.back().set_name(longString("leaf"));
+  expectOnArena(tree, &arena);
+  EXPECT_GE(arena.allocated(), 2 * kLong.size());
+}
+
+TEST(AllocatorAwareTest, allocatorCopyAndMove) {
+  auto tree = makeTree();
+
+  CountingArena arena;
+  Tree copy(std::allocator_arg, Tree::allocator_type(&arena), tree);
+  EXPECT_EQ(tree, copy);
+  expectOnArena(copy, &arena);
+  EXPECT_GE(arena.allocated(), stringBytes());
+
+  CountingArena other;
+  Tree moved(
+      std::allocator_arg, Tree::allocator_type(&other), std::move(copy));
+  EXPECT_EQ(tree, moved);
+  expectOnArena(moved, &other);
+  EXPECT_GE(other.allocated(), stringBytes());
+}
+
+TEST(AllocatorAwareTest, elementOfArenaContainer) {
+  CountingArena arena;
+  std::pmr::vector<Tree> trees(&arena);
+  trees.push_back(makeTree());
+  trees.emplace_back();
+  EXPECT_EQ(makeTree(), trees.front());
+  for (const auto& tree : trees) {
+    expectOnArena(tree, &arena);
+  }
+}
+
+TEST(AllocatorAwareTest, deserializeInArenaBinary) {
+  checkDeserializeInArena<BinarySerializer>();
+}
+
+TEST(AllocatorAwareTest, deserializeInArenaCompact) {
+  checkDeserializeInArena<CompactSerializer>();
+}
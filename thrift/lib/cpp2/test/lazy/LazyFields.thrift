@@ -0,0 +1,30 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+namespace cpp2 apache.thrift.test
+
+struct Payload {
+  1: string name;
+  2: list<i64> values;
+}
+
+struct Envelope {
+  1: i64 id;
+  2: string route;
+  3: binary blob (cpp.lazy);
+  4: map<string, Payload> payloads (cpp.lazy);
+  5: optional Payload extra (cpp.lazy);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include <vector>
+
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <thrift/lib/cpp2/test/lazy/gen-cpp2/LazyFields_types.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+namespace {
+
+Envelope makeEnvelope() {
+  Envelope env;
+  env.set_id(7);
+  env.set_route("backend");
+  env.set_blob(std::string(1000, 'b'));
+  std::map<std::string, Payload> payloads;
+  for (int i = 0; i < 10; ++i) {
+    Payload p;
+    p.set_name("p" + std::to_string(i));
+    p.set_values(std::vector<int64_t>(100, i));
+    payloads.emplace(p.get_name(), std::move(p));
+  }
+  env.set_payloads(std::move(payloads));
+  Payload extra;
+  extra.set_name("extra");
+  env.extra_ref() = extra;
+  return env;
+}
+
+template <typename Serializer>
+void checkRoundTrip() {
+  auto const original = makeEnvelope();
+  auto const bytes = Serializer::template serialize<std::string>(original);
+
+  auto lazy = Serializer::template deserialize<Envelope>(bytes);
+  EXPECT_EQ(7, lazy.get_id());
+  EXPECT_EQ("backend", lazy.get_route());
+  EXPECT_TRUE(lazy.__lazy.blob.pending());
+  EXPECT_TRUE(lazy.__lazy.payloads.pending());
+  EXPECT_TRUE(lazy.__lazy.extra.pending());
+
+  // Untouched lazy fields are written back out verbatim.
+  EXPECT_EQ(bytes, Serializer::template serialize<std::string>(lazy));
+  EXPECT_TRUE(lazy.__lazy.payloads.pending());
+
+  // Accessors decode on first use.
+  EXPECT_EQ(original.get_payloads(), lazy.get_payloads());
+  EXPECT_FALSE(lazy.__lazy.payloads.pending());
+  EXPECT_EQ("extra", lazy.extra_ref()->get_name());
+  EXPECT_EQ(original, lazy);
+}
+
+} // namespace
+
+TEST(LazyFieldsTest, binaryRoundTrip) {
+  checkRoundTrip<BinarySerializer>();
+}
+
+TEST(LazyFieldsTest, compactRoundTrip) {
+  checkRoundTrip<CompactSerializer>();
+}
+
+TEST(LazyFieldsTest, crossProtocolDecodesLazyFields) {
+  auto const original = makeEnvelope();
+  auto lazy = CompactSerializer::deserialize<Envelope>(
+      CompactSerializer::serialize<std::string>(original));
+  auto const binary = BinarySerializer::serialize<std::string>(lazy);
+  EXPECT_EQ(BinarySerializer::serialize<std::string>(original), binary);
+  EXPECT_EQ(original, BinarySerializer::deserialize<Envelope>(binary));
+}
+
+TEST(LazyFieldsTest, setterDiscardsCapturedBytes) {
+  auto lazy = BinarySerializer::deserialize<Envelope>(
+      BinarySerializer::serialize<std::string>(makeEnvelope()));
+  lazy.set_blob("replaced");
+  EXPECT_FALSE(lazy.__lazy.blob.pending());
+
+  auto const copy = BinarySerializer::deserialize<Envelope>(
+      BinarySerializer::serialize<std::string>(lazy));
+  EXPECT_EQ("replaced", copy.get_blob());
+}
+
+TEST(LazyFieldsTest, writeAfterLazyRead) {
+  auto const original = makeEnvelope();
+  auto lazy = CompactSerializer::deserialize<Envelope>(
+      CompactSerializer::serialize<std::string>(original));
+  ASSERT_TRUE(lazy.__lazy.payloads.pending());
+
+  // Once an accessor has decoded the field, changes to the data member are
+  // kept and written out.
+  EXPECT_EQ(original.get_payloads().size(), lazy.get_payloads().size());
+  EXPECT_FALSE(lazy.__lazy.payloads.pending());
+  lazy.payloads["added"].set_name("added");
+  auto blob = lazy.get_blob();
+  lazy.set_blob(blob + "tail");
+  lazy.extra_ref()->set_name("changed");
+
+  auto const copy = CompactSerializer::deserialize<Envelope>(
+      CompactSerializer::serialize<std::string>(lazy));
+  EXPECT_EQ(lazy.get_payloads(), copy.get_payloads());
+  EXPECT_EQ("added", copy.get_payloads().at("added").get_name());
+  EXPECT_EQ(original.get_blob() + "tail", copy.get_blob());
+  EXPECT_EQ("changed", copy.extra_ref()->get_name());
+}
+
+TEST(LazyFieldsTest, copiesShareCapturedBytes) {
+  auto lazy = CompactSerializer::deserialize<Envelope>(
+      CompactSerializer::serialize<std::string>(makeEnvelope()));
+  Envelope copy = lazy;
+  EXPECT_TRUE(copy.__lazy.payloads.pending());
+  EXPECT_EQ(lazy.get_payloads(), copy.get_payloads());
+}
+
+TEST(LazyFieldsTest, concurrentConstAccess) {
+  auto const original = makeEnvelope();
+  auto const compact = CompactSerializer::serialize<std::string>(original);
+  auto const binary = BinarySerializer::serialize<std::string>(original);
+  for (int round = 0; round < 20; ++round) {
+    auto const lazy = CompactSerializer::deserialize<Envelope>(compact);
+    // Readers, verbatim and re-encoding writers, and copies all race for
+    // the first decode.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&, i] {
+        switch (i % 4) {
+          case 0:
+            EXPECT_EQ(original.get_payloads(), lazy.get_payloads());
+            break;
+          case 1:
+            EXPECT_EQ(compact, CompactSerializer::serialize<std::string>(lazy));
+            break;
+          case 2:
+            EXPECT_EQ(binary, BinarySerializer::serialize<std::string>(lazy));
+            break;
+          default: {
+            Envelope copy = lazy;
+            EXPECT_EQ(original, copy);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_FALSE(lazy.__lazy.payloads.pending());
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated with the `table_based` option.
+
+namespace cpp2 apache.thrift.test
+
+cpp_include "thrift/lib/cpp2/test/table_based/Wrappers.h"
+
+enum Color {
+  RED = 1,
+  GREEN = 2,
+}
+
+struct Inner {
+  1: string name;
+  2: list<i64> values;
+}
+
+typedef binary (cpp.type = "std::unique_ptr<folly::IOBuf>") IOBufPtr
+typedef i64 (cpp.type = "::apache::thrift::test::CppId",
+             cpp.indirection = ".value") Id
+typedef string (cpp.type = "::apache::thrift::test::CppLabel",
+                cpp.indirection = ".value") Label
+
+struct Outer {
+  1: bool flag;
+  2: byte tiny;
+  3: i16 small;
+  4: i32 medium;
+  5: i64 large;
+  6: float ratio;
+  7: double precise;
+  8: string text;
+  9: binary raw;
+  10: Color color;
+  11: list<i32> numbers;
+  12: map<string, Inner> inners;
+  13: Inner inner;
+  14: optional string note;
+  15: required i32 version;
+  16: IOBufPtr buf;
+  17: Id id;
+  18: Label label;
+  19: list<Id> ids;
+}
+
+// Outer without fields 3 through 13 and 17 through 19, so that reading an
+// Outer as a Sparse skips them.
+struct Sparse {
+  1: bool flag;
+  2: byte tiny;
+  14: optional string note;
+  15: required i32 version;
+  16: IOBufPtr buf;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <type_traits>
+
+#include <folly/io/IOBuf.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <thrift/lib/cpp2/test/table_based/gen-cpp2/TableBased_types.h>
+#include <thrift/lib/cpp2/test/table_based/gen-cpp2/Unrolled_types.h>
+
+using namespace apache::thrift;
+using namespace apache::thrift::test;
+
+namespace {
+
+// Builds the same value as either a table-based or an unrolled Outer.
+template <typename OuterT = Outer>
+OuterT makeOuter() {
+  using InnerT = std::decay_t<decltype(std::declval<OuterT>().get_inner())>;
+  using ColorT = decltype(std::declval<OuterT>().get_color());
+  OuterT outer;
+  outer.set_flag(true);
+  outer.set_tiny(-3);
+  outer.set_small(1234);
+  outer.set_medium(-123456);
+  outer.set_large(1LL << 40);
+  outer.set_ratio(0.5f);
+  outer.set_precise(3.25);
+  outer.set_text("text");
+  outer.set_raw(std::string("\0\1\2", 3));
+  outer.set_color(ColorT::GREEN);
+  outer.set_numbers(std::vector<int32_t>{1, 2, 3});
+  InnerT inner;
+  inner.set_name("inner");
+  inner.set_values(std::vector<int64_t>{4, 5});
+  outer.set_inners(std::map<std::string, InnerT>{{"a", inner}});
+  outer.set_inner(inner);
+  outer.set_version(2);
+  outer.buf = folly::IOBuf::copyBuffer("buf");
+  outer.set_id(CppId{42});
+  outer.set_label(CppLabel{"label"});
+  outer.set_ids(std::vector<CppId>{CppId{7}, CppId{-8}});
+  return outer;
+}
+
+template <typename Serializer>
+void checkRoundTrip() {
+  auto outer = makeOuter();
+  auto bytes = Serializer::template serialize<std::string>(outer);
+
+  auto copy = Serializer::template deserialize<Outer>(bytes);
+  EXPECT_EQ(outer.get_flag(), copy.get_flag());
+  EXPECT_EQ(outer.get_tiny(), copy.get_tiny());
+  EXPECT_EQ(outer.get_small(), copy.get_small());
+  EXPECT_EQ(outer.get_medium(), copy.get_medium());
+  EXPECT_EQ(outer.get_large(), copy.get_large());
+  EXPECT_EQ(outer.get_ratio(), copy.get_ratio());
+  EXPECT_EQ(outer.get_precise(), copy.get_precise());
+  EXPECT_EQ(outer.get_text(), copy.get_text());
+  EXPECT_EQ(outer.get_raw(), copy.get_raw());
+  EXPECT_EQ(Color::GREEN, copy.get_color());
+  EXPECT_EQ(outer.get_numbers(), copy.get_numbers());
+  EXPECT_EQ(outer.get_inners(), copy.get_inners());
+  EXPECT_EQ(outer.get_inner(), copy.get_inner());
+  EXPECT_FALSE(copy.note_ref().has_value());
+  EXPECT_EQ(2, copy.get_version());
+  EXPECT_EQ("buf", copy.buf->moveToFbString().toStdString());
+  EXPECT_EQ(outer.get_id(), copy.get_id());
+  EXPECT_EQ(outer.get_label(), copy.get_label());
+  EXPECT_EQ(outer.get_ids(), copy.get_ids());
+  EXPECT_TRUE(copy.__isset.text);
+
+  outer.note_ref() = "note";
+  copy = Serializer::template deserialize<Outer>(
+      Serializer::template serialize<std::string>(outer));
+  EXPECT_EQ("note", *copy.note_ref());
+}
+
+// The table-based serializer must produce the same bytes as the unrolled one,
+// and each must read what the other wrote.
+template <typename Serializer>
+void checkMatchesUnrolled() {
+  auto outer = makeOuter<Outer>();
+  auto reference = makeOuter<unrolled::Outer>();
+  for (bool withNote : {false, true}) {
+    if (withNote) {
+      outer.note_ref() = "note";
+      reference.note_ref() = "note";
+    }
+    auto bytes = Serializer::template serialize<std::string>(outer);
+    auto expected = Serializer::template serialize<std::string>(reference);
+    EXPECT_EQ(expected, bytes);
+
+    auto fromUnrolled = Serializer::template deserialize<Outer>(expected);
+    EXPECT_EQ(
+        expected, Serializer::template serialize<std::string>(fromUnrolled));
+    EXPECT_EQ(42, fromUnrolled.get_id().value);
+    EXPECT_EQ("label", fromUnrolled.get_label().value);
+    EXPECT_EQ(2u, fromUnrolled.get_ids().size());
+
+    auto fromTable = Serializer::template deserialize<unrolled::Outer>(bytes);
+    EXPECT_EQ(bytes, Serializer::template serialize<std::string>(fromTable));
+  }
+}
+
+template <typename Serializer>
+void checkSkipsUnknownFields() {
+  auto outer = makeOuter();
+  outer.note_ref() = "note";
+  auto sparse = Serializer::template deserialize<Sparse>(
+      Serializer::template serialize<std::string>(outer));
+  EXPECT_TRUE(sparse.get_flag());
+  EXPECT_EQ(-3, sparse.get_tiny());
+  EXPECT_EQ("note", *sparse.note_ref());
+  EXPECT_EQ(2, sparse.get_version());
+  EXPECT_EQ("buf", sparse.buf->moveToFbString().toStdString());
+}
+
+} // namespace
+
+TEST(TableBasedTest, binaryRoundTrip) {
+  checkRoundTrip<BinarySerializer>();
+}
+
+TEST(TableBasedTest, compactRoundTrip) {
+  checkRoundTrip<CompactSerializer>();
+}
+
+TEST(TableBasedTest, jsonRoundTrip) {
+  checkRoundTrip<JSONSerializer>();
+}
+
+TEST(TableBasedTest, simpleJsonRoundTrip) {
+  checkRoundTrip<SimpleJSONSerializer>();
+}
+
+TEST(TableBasedTest, binaryMatchesUnrolled) {
+  checkMatchesUnrolled<BinarySerializer>();
+}
+
+TEST(TableBasedTest, compactMatchesUnrolled) {
+  checkMatchesUnrolled<CompactSerializer>();
+}
+
+TEST(TableBasedTest, jsonMatchesUnrolled) {
+  checkMatchesUnrolled<JSONSerializer>();
+}
+
+// SimpleJSON identifies fields by name, so reading it goes through
+// translateFieldName.
+TEST(TableBasedTest, simpleJsonMatchesUnrolled) {
+  checkMatchesUnrolled<SimpleJSONSerializer>();
+}
+
+TEST(TableBasedTest, binarySkipsUnknownFields) {
+  checkSkipsUnknownFields<BinarySerializer>();
+}
+
+TEST(TableBasedTest, compactSkipsUnknownFields) {
+  checkSkipsUnknownFields<CompactSerializer>();
+}
+
+TEST(TableBasedTest, serializedSizeMatchesWrite) {
+  auto outer = makeOuter();
+  BinaryProtocolWriter writer;
+  folly::IOBufQueue queue;
+  writer.setOutput(&queue);
+  auto written = outer.write(&writer);
+  EXPECT_EQ(written, queue.chainLength());
+  EXPECT_EQ(written, outer.serializedSize(&writer));
+  EXPECT_EQ(
+      makeOuter<unrolled::Outer>().serializedSize(&writer),
+      outer.serializedSize(&writer));
+}
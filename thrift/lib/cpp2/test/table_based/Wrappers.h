@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace apache {
+namespace thrift {
+namespace test {
+
+// Wrappers for fields with a `cpp.indirection` to the wrapped value.
+
+struct CppId {
+  int64_t value{0};
+};
+
+inline bool operator==(const CppId& lhs, const CppId& rhs) {
+  return lhs.value == rhs.value;
+}
+
+inline bool operator<(const CppId& lhs, const CppId& rhs) {
+  return lhs.value < rhs.value;
+}
+
+struct CppLabel {
+  std::string value;
+};
+
+inline bool operator==(const CppLabel& lhs, const CppLabel& rhs) {
+  return lhs.value == rhs.value;
+}
+
+inline bool operator<(const CppLabel& lhs, const CppLabel& rhs) {
+  return lhs.value < rhs.value;
+}
+
+} // namespace test
+} // namespace thrift
+} // namespace apache
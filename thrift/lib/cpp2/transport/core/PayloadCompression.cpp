@@ -0,0 +1,340 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
+
+#include <array>
+#include <atomic>
+
+#include <fmt/core.h>
+#include <folly/Varint.h>
+#include <folly/compression/Compression.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/portability/Time.h>
+
+#include <thrift/lib/cpp/transport/TTransportException.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
+
+namespace apache {
+namespace thrift {
+
+namespace {
+
+constexpr size_t kNumAlgorithms =
+    static_cast<size_t>(CompressionAlgorithm::LZ4) + 1;
+
+struct AtomicCounters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> bytesIn{0};
+  std::atomic<uint64_t> bytesOut{0};
+  std::atomic<uint64_t> cpuNanos{0};
+
+  void add(uint64_t in, uint64_t out, uint64_t nanos) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    bytesIn.fetch_add(in, std::memory_order_relaxed);
+    bytesOut.fetch_add(out, std::memory_order_relaxed);
+    cpuNanos.fetch_add(nanos, std::memory_order_relaxed);
+  }
+
+  PayloadCompressionStats::Counters load() const {
+    PayloadCompressionStats::Counters ret;
+    ret.calls = calls.load(std::memory_order_relaxed);
+    ret.bytesIn = bytesIn.load(std::memory_order_relaxed);
+    ret.bytesOut = bytesOut.load(std::memory_order_relaxed);
+    ret.cpuNanos = cpuNanos.load(std::memory_order_relaxed);
+    return ret;
+  }
+};
+
+struct AlgorithmCounters {
+  AtomicCounters compress;
+  AtomicCounters uncompress;
+};
+
+std::array<AlgorithmCounters, kNumAlgorithms>& counters() {
+  static auto* instance = new std::array<AlgorithmCounters, kNumAlgorithms>();
+  return *instance;
+}
+
+size_t indexOf(CompressionAlgorithm algorithm) {
+  auto index = static_cast<size_t>(algorithm);
+  if (index >= kNumAlgorithms) {
+    throw transport::TTransportException(
+        transport::TTransportException::CORRUPTED_DATA,
+        fmt::format("Unknown compression algorithm: {}", index));
+  }
+  return index;
+}
+
+uint64_t threadCpuNanos() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0;
+  }
+  return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+}
+
+folly::io::CodecType codecType(CompressionAlgorithm algorithm) {
+  switch (algorithm) {
+    case CompressionAlgorithm::ZLIB:
+      return folly::io::CodecType::ZLIB;
+    case CompressionAlgorithm::ZSTD:
+      return folly::io::CodecType::ZSTD;
+    case CompressionAlgorithm::LZ4:
+      return folly::io::CodecType::LZ4_VARINT_SIZE;
+    default:
+      throw transport::TTransportException(
+          transport::TTransportException::CORRUPTED_DATA,
+          "No codec for compression algorithm NONE");
+  }
+}
+
+// Same level THeader uses for ZSTD_TRANSFORM.
+int codecLevel(CompressionAlgorithm algorithm) {
+  return algorithm == CompressionAlgorithm::ZSTD
+      ? 1
+      : folly::io::COMPRESSION_LEVEL_DEFAULT;
+}
+
+template <class Codec>
+using PerAlgorithm = std::array<std::unique_ptr<Codec>, kNumAlgorithms>;
+
+folly::io::Codec& threadCodec(CompressionAlgorithm algorithm) {
+  // Codecs keep their contexts between calls but are not thread safe.
+  thread_local PerAlgorithm<folly::io::Codec> codecs;
+  auto& codec = codecs[indexOf(algorithm)];
+  if (!codec) {
+    codec = folly::io::getCodec(codecType(algorithm), codecLevel(algorithm));
+  }
+  return *codec;
+}
+
+folly::io::StreamCodec& threadStreamCodec(CompressionAlgorithm algorithm) {
+  thread_local PerAlgorithm<folly::io::StreamCodec> codecs;
+  auto& codec = codecs[indexOf(algorithm)];
+  if (!codec) {
+    auto type = codecType(algorithm);
+    if (!folly::io::hasStreamCodec(type)) {
+      throw transport::TTransportException(
+          transport::TTransportException::CORRUPTED_DATA,
+          fmt::format(
+              "Compressed payload of unknown size for algorithm {}",
+              static_cast<int>(algorithm)));
+    }
+    codec = folly::io::getStreamCodec(type, codecLevel(algorithm));
+  }
+  return *codec;
+}
+
+uint64_t varintPrefix(const folly::IOBuf& payload) {
+  uint8_t prefix[folly::kMaxVarintLength64];
+  folly::io::Cursor cursor(&payload);
+  auto bytes = cursor.pullAtMost(prefix, sizeof(prefix));
+  folly::ByteRange range(prefix, bytes);
+  auto size = folly::tryDecodeVarint(range);
+  if (size.hasError()) {
+    throw transport::TTransportException(
+        transport::TTransportException::CORRUPTED_DATA,
+        "Compressed payload has no valid size prefix");
+  }
+  return size.value();
+}
+
+[[noreturn]] void throwTooLarge(uint64_t size, uint64_t maxBytes) {
+  throw transport::TTransportException(
+      transport::TTransportException::CORRUPTED_DATA,
+      fmt::format(
+          "Compressed payload uncompresses to {} bytes, more than the {} "
+          "allowed",
+          size,
+          maxBytes));
+}
+
+/**
+ * Uncompresses a payload a chunk at a time, so that a small payload can't
+ * expand into an allocation larger than 'maxBytes', whether or not its frame
+ * declares a size.
+ */
+std::unique_ptr<folly::IOBuf> uncompressStreamBounded(
+    CompressionAlgorithm algorithm,
+    const folly::IOBuf& payload,
+    uint64_t maxBytes) {
+  constexpr size_t kChunkBytes = 64 * 1024;
+  auto& codec = threadStreamCodec(algorithm);
+  codec.resetStream();
+  folly::IOBufQueue out(folly::IOBufQueue::cacheChainLength());
+  uint64_t total = 0;
+  auto next = payload.begin();
+  folly::ByteRange input;
+  while (true) {
+    while (input.empty() && next != payload.end()) {
+      input = *next++;
+    }
+    bool last = next == payload.end();
+    auto chunk = folly::IOBuf::create(kChunkBytes);
+    folly::MutableByteRange output(chunk->writableTail(), chunk->tailroom());
+    auto inputBefore = input.size();
+    bool ended = codec.uncompressStream(
+        input,
+        output,
+        last ? folly::io::StreamCodec::FlushOp::END
+             : folly::io::StreamCodec::FlushOp::NONE);
+    size_t written = chunk->tailroom() - output.size();
+    if (written > 0) {
+      total += written;
+      if (total > maxBytes) {
+        throwTooLarge(total, maxBytes);
+      }
+      chunk->append(written);
+      out.append(std::move(chunk));
+    }
+    if (ended) {
+      break;
+    }
+    if (last && written == 0 && input.size() == inputBefore) {
+      throw transport::TTransportException(
+          transport::TTransportException::CORRUPTED_DATA,
+          "Truncated compressed payload");
+    }
+  }
+  auto ret = out.move();
+  return ret ? std::move(ret) : folly::IOBuf::create(0);
+}
+
+std::unique_ptr<folly::IOBuf> uncompressBounded(
+    CompressionAlgorithm algorithm,
+    const folly::IOBuf& payload,
+    uint64_t maxBytes) {
+  auto& codec = threadCodec(algorithm);
+  auto size = codec.getUncompressedLength(&payload);
+  if (size && *size > maxBytes) {
+    throwTooLarge(*size, maxBytes);
+  }
+  if (folly::io::hasStreamCodec(codecType(algorithm))) {
+    return uncompressStreamBounded(algorithm, payload, maxBytes);
+  }
+  // LZ4 has no streaming form here, but it prefixes its output with the
+  // uncompressed size, which the codec allocates up front.
+  if (!size) {
+    size = varintPrefix(payload);
+    if (*size > maxBytes) {
+      throwTooLarge(*size, maxBytes);
+    }
+  }
+  return codec.uncompress(&payload);
+}
+
+std::shared_ptr<const transport::ZstdDictionary> dictionaryFor(
+    CompressionAlgorithm algorithm,
+    folly::Optional<uint32_t> dictionaryId) {
+  if (!dictionaryId) {
+    return nullptr;
+  }
+  if (algorithm != CompressionAlgorithm::ZSTD) {
+    throw transport::TTransportException(
+        transport::TTransportException::CORRUPTED_DATA,
+        "Compression dictionaries are only supported with ZSTD");
+  }
+  auto dict = transport::getZstdDictionary(*dictionaryId);
+  if (!dict) {
+    throw transport::TTransportException(
+        transport::TTransportException::CORRUPTED_DATA,
+        fmt::format("Unknown compression dictionary: {}", *dictionaryId));
+  }
+  return dict;
+}
+
+template <class Metadata>
+std::unique_ptr<folly::IOBuf> uncompressWithMetadata(
+    const Metadata& metadata,
+    std::unique_ptr<folly::IOBuf> payload,
+    uint64_t maxUncompressedBytes) {
+  auto compression = metadata.compression_ref();
+  if (!compression || *compression == CompressionAlgorithm::NONE) {
+    return payload;
+  }
+  folly::Optional<uint32_t> dictionaryId;
+  if (auto id = metadata.compressionDictionaryId_ref()) {
+    dictionaryId = *id;
+  }
+  return detail::uncompressPayload(
+      *payload, *compression, dictionaryId, maxUncompressedBytes);
+}
+
+} // namespace
+
+PayloadCompressionStats getPayloadCompressionStats(
+    CompressionAlgorithm algorithm) {
+  auto& c = counters()[indexOf(algorithm)];
+  PayloadCompressionStats stats;
+  stats.compress = c.compress.load();
+  stats.uncompress = c.uncompress.load();
+  return stats;
+}
+
+namespace detail {
+
+std::unique_ptr<folly::IOBuf> compressPayload(
+    const folly::IOBuf& payload,
+    CompressionAlgorithm algorithm,
+    folly::Optional<uint32_t> dictionaryId) {
+  auto dict = dictionaryFor(algorithm, dictionaryId);
+  auto start = threadCpuNanos();
+  auto out = dict ? dict->compress(payload)
+                  : threadCodec(algorithm).compress(&payload);
+  counters()[indexOf(algorithm)].compress.add(
+      payload.computeChainDataLength(),
+      out->computeChainDataLength(),
+      threadCpuNanos() - start);
+  return out;
+}
+
+std::unique_ptr<folly::IOBuf> uncompressPayload(
+    const folly::IOBuf& payload,
+    CompressionAlgorithm algorithm,
+    folly::Optional<uint32_t> dictionaryId,
+    uint64_t maxUncompressedBytes) {
+  auto dict = dictionaryFor(algorithm, dictionaryId);
+  auto start = threadCpuNanos();
+  auto out = dict ? dict->uncompress(payload, maxUncompressedBytes)
+                  : uncompressBounded(algorithm, payload, maxUncompressedBytes);
+  counters()[indexOf(algorithm)].uncompress.add(
+      payload.computeChainDataLength(),
+      out->computeChainDataLength(),
+      threadCpuNanos() - start);
+  return out;
+}
+
+std::unique_ptr<folly::IOBuf> uncompressRequestPayload(
+    const RequestRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf> payload,
+    uint64_t maxUncompressedBytes) {
+  return uncompressWithMetadata(
+      metadata, std::move(payload), maxUncompressedBytes);
+}
+
+std::unique_ptr<folly::IOBuf> uncompressResponsePayload(
+    const ResponseRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf> payload,
+    uint64_t maxUncompressedBytes) {
+  return uncompressWithMetadata(
+      metadata, std::move(payload), maxUncompressedBytes);
+}
+
+} // namespace detail
+} // namespace thrift
+} // namespace apache
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <folly/Optional.h>
+#include <folly/io/IOBuf.h>
+
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
+#include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
+
+namespace apache {
+namespace thrift {
+
+/**
+ * Process-wide totals for one codec, summed over client and server. CPU time
+ * is the calling thread's CPU time, so it does not include time spent
+ * descheduled.
+ */
+struct PayloadCompressionStats {
+  struct Counters {
+    uint64_t calls{0};
+    uint64_t bytesIn{0};
+    uint64_t bytesOut{0};
+    uint64_t cpuNanos{0};
+  };
+  Counters compress;
+  Counters uncompress;
+};
+
+PayloadCompressionStats getPayloadCompressionStats(
+    CompressionAlgorithm algorithm);
+
+namespace detail {
+
+/**
+ * Compresses an RPC payload with 'algorithm'. With ZSTD, 'dictionaryId' names
+ * a dictionary registered via transport::registerZstdDictionary. Throws on
+ * failure; callers are expected to fall back to sending uncompressed.
+ */
+std::unique_ptr<folly::IOBuf> compressPayload(
+    const folly::IOBuf& payload,
+    CompressionAlgorithm algorithm,
+    folly::Optional<uint32_t> dictionaryId = folly::none);
+
+constexpr uint64_t kDefaultMaxUncompressedBytes =
+    transport::ZstdDictionary::kDefaultMaxUncompressedBytes;
+
+/**
+ * Reverses compressPayload(). Throws on corrupt input, an unknown codec or
+ * dictionary, or a payload which would uncompress to more than
+ * 'maxUncompressedBytes'. Memory is only allocated for what the payload
+ * actually uncompresses to, up to that limit, whatever size its frame
+ * header declares.
+ */
+std::unique_ptr<folly::IOBuf> uncompressPayload(
+    const folly::IOBuf& payload,
+    CompressionAlgorithm algorithm,
+    folly::Optional<uint32_t> dictionaryId = folly::none,
+    uint64_t maxUncompressedBytes = kDefaultMaxUncompressedBytes);
+
+/**
+ * Return 'payload' uncompressed as described by the metadata it arrived with,
+ * or unchanged if it was not compressed. Servers pass
+ * ServerConfigs::getMaxUncompressedRequestSize() as the limit.
+ */
+std::unique_ptr<folly::IOBuf> uncompressRequestPayload(
+    const RequestRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf> payload,
+    uint64_t maxUncompressedBytes = kDefaultMaxUncompressedBytes);
+std::unique_ptr<folly::IOBuf> uncompressResponsePayload(
+    const ResponseRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf> payload,
+    uint64_t maxUncompressedBytes = kDefaultMaxUncompressedBytes);
+
+} // namespace detail
+} // namespace thrift
+} // namespace apache
@@ -25,6 +25,7 @@
 
 #include <thrift/lib/cpp/transport/THeader.h>
 #include <thrift/lib/cpp2/async/RequestChannel.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
 namespace apache {
@@ -42,10 +43,22 @@ RequestRpcMetadata makeRequestRpcMetadata(
   uint64_t flags = 0;
   metadata.protocol_ref() = protocolId;
   metadata.kind_ref() = kind;
-  if (rpcOptions.getTimeout() > std::chrono::milliseconds::zero()) {
-    metadata.clientTimeoutMs_ref() = rpcOptions.getTimeout().count();
-  } else if (defaultChannelTimeout > std::chrono::milliseconds::zero()) {
-    metadata.clientTimeoutMs_ref() = defaultChannelTimeout.count();
+  auto timeout = rpcOptions.getTimeout() > std::chrono::milliseconds::zero()
+      ? rpcOptions.getTimeout()
+      : defaultChannelTimeout;
+  // Calls made while serving a request inherit what is left of its deadline.
+  // Oneway and streaming calls may outlive it, so they keep their timeout.
+  folly::Optional<std::chrono::milliseconds> deadlineBudget;
+  if (kind == RpcKind::SINGLE_REQUEST_SINGLE_RESPONSE &&
+      rpcOptions.getInheritDeadline()) {
+    deadlineBudget = RequestDeadline::remaining();
+  }
+  if (deadlineBudget) {
+    metadata.deadlineBudgetMs_ref() = deadlineBudget->count();
+    timeout = RequestDeadline::clampTimeout(timeout);
+  }
+  if (timeout > std::chrono::milliseconds::zero()) {
+    metadata.clientTimeoutMs_ref() = timeout.count();
   }
   if (rpcOptions.getQueueTimeout() > std::chrono::milliseconds::zero()) {
     metadata.queueTimeoutMs_ref() = rpcOptions.getQueueTimeout().count();
@@ -21,6 +21,7 @@
 #include <glog/logging.h>
 
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/transport/core/ThriftRequest.h>
@@ -80,6 +81,8 @@ void ThriftProcessor::onThriftRequest(
 
   auto protoId = request->getProtoId();
   auto reqContext = request->getRequestContext();
+  folly::RequestContextScopeGuard rctx(
+      RequestDeadline::makeContext(reqContext->getDeadline()));
   cpp2Processor_->process(
       std::move(request), std::move(payload), protoId, reqContext, evb, tm_);
 }
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -26,6 +27,9 @@
 
 #include <glog/logging.h>
 
+#include <folly/ExceptionString.h>
+#include <folly/GLog.h>
+#include <folly/Optional.h>
 #include <folly/io/IOBuf.h>
 #include <thrift/lib/cpp/TApplicationException.h>
 #include <thrift/lib/cpp/protocol/TProtocolException.h>
@@ -35,6 +39,7 @@
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/server/ServerConfigs.h>
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
 #include <thrift/lib/cpp2/transport/core/ThriftChannelIf.h>
 #include <thrift/lib/thrift/gen-cpp2/RpcMetadata_types.h>
 
@@ -81,12 +86,40 @@ class ThriftRequestCore : public ResponseChannelRequest {
       clientQueueTimeout_ = std::chrono::milliseconds(*queueTimeoutMs);
       header_.setClientQueueTimeout(clientQueueTimeout_);
     }
+    // The caller stops waiting at the earliest of its own timeout and of the
+    // deadline it is itself serving.  Only request-response calls have one:
+    // the client timeout of a stream bounds its first response, not the
+    // whole stream.
+    if (kind_ == RpcKind::SINGLE_REQUEST_SINGLE_RESPONSE) {
+      folly::Optional<std::chrono::milliseconds> deadlineBudget;
+      if (clientTimeout_ > std::chrono::milliseconds(0)) {
+        deadlineBudget = clientTimeout_;
+      }
+      if (auto deadlineBudgetMs = metadata.deadlineBudgetMs_ref()) {
+        auto budget =
+            std::chrono::milliseconds(std::max<int32_t>(0, *deadlineBudgetMs));
+        deadlineBudget =
+            deadlineBudget ? std::min(*deadlineBudget, budget) : budget;
+      }
+      if (deadlineBudget) {
+        reqContext_.setDeadline(
+            std::chrono::steady_clock::now() + *deadlineBudget);
+      }
+    }
     if (auto priority = metadata.priority_ref()) {
       header_.setCallPriority(static_cast<concurrency::PRIORITY>(*priority));
     }
     if (auto otherMetadata = metadata.otherMetadata_ref()) {
       header_.setReadHeaders(std::move(*otherMetadata));
     }
+    if (auto compression = metadata.acceptResponseCompression_ref()) {
+      if (*compression != CompressionAlgorithm::NONE) {
+        responseCompression_ = *compression;
+        if (auto dictionaryId = metadata.compressionDictionaryId_ref()) {
+          responseDictionaryId_ = *dictionaryId;
+        }
+      }
+    }
 
     reqContext_.setMessageBeginSize(0);
     reqContext_.setMethodName(name_);
@@ -142,6 +175,7 @@ class ThriftRequestCore : public ResponseChannelRequest {
         if (crc32c) {
           metadata.crc32c_ref() = *crc32c;
         }
+        compressResponse(metadata, buf);
         sendReplyInternal(std::move(metadata), std::move(buf));
         if (auto observer = serverConfigs_.getObserver()) {
           observer->sentReply();
@@ -162,6 +196,7 @@ class ThriftRequestCore : public ResponseChannelRequest {
       if (crc32c) {
         metadata.crc32c_ref() = *crc32c;
       }
+      compressResponse(metadata, result.response);
       sendReplyInternal(
           std::move(metadata),
           std::move(result.response),
@@ -270,6 +305,38 @@ class ThriftRequestCore : public ResponseChannelRequest {
     return metadata;
   }
 
+  // Compresses the response payload if the client accepts compression and
+  // the payload is at least getMinCompressBytes() long. Any failure, or a
+  // payload that does not shrink, leaves the response uncompressed.
+  void compressResponse(
+      ResponseRpcMetadata& metadata,
+      std::unique_ptr<folly::IOBuf>& buf) {
+    if (!responseCompression_ || !buf) {
+      return;
+    }
+    auto size = buf->computeChainDataLength();
+    if (size < serverConfigs_.getMinCompressBytes()) {
+      return;
+    }
+    std::unique_ptr<folly::IOBuf> compressed;
+    try {
+      compressed = detail::compressPayload(
+          *buf, *responseCompression_, responseDictionaryId_);
+    } catch (const std::exception& ex) {
+      FB_LOG_EVERY_MS(ERROR, 10000)
+          << "Failed to compress response: " << folly::exceptionStr(ex);
+      return;
+    }
+    if (compressed->computeChainDataLength() >= size) {
+      return;
+    }
+    buf = std::move(compressed);
+    metadata.compression_ref() = *responseCompression_;
+    if (responseDictionaryId_) {
+      metadata.compressionDictionaryId_ref() = *responseDictionaryId_;
+    }
+  }
+
   void sendErrorWrappedInternal(
       folly::exception_wrapper ew,
       const std::string& exCode) {
@@ -385,6 +452,8 @@ class ThriftRequestCore : public ResponseChannelRequest {
   std::atomic<bool> active_;
   transport::THeader header_;
   const uint64_t requestFlags_{0};
+  folly::Optional<CompressionAlgorithm> responseCompression_;
+  folly::Optional<uint32_t> responseDictionaryId_;
   std::shared_ptr<Cpp2ConnContext> connContext_;
   Cpp2RequestContext reqContext_;
 
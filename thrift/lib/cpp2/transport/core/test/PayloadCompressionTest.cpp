@@ -0,0 +1,209 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include <folly/compression/Compression.h>
+#include <folly/io/IOBuf.h>
+#include <folly/portability/GTest.h>
+
+#include <thrift/lib/cpp/transport/TTransportException.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
+
+using namespace apache::thrift;
+
+namespace {
+
+std::string makePayload() {
+  std::string ret;
+  for (int i = 0; i < 200; ++i) {
+    ret += "field" + std::to_string(i % 7) + "=value;";
+  }
+  return ret;
+}
+
+std::string toString(const folly::IOBuf& buf) {
+  return buf.cloneCoalescedAsValue().moveToFbString().toStdString();
+}
+
+} // namespace
+
+TEST(PayloadCompression, RoundTrip) {
+  auto payload = makePayload();
+  // Chained input exercises the codecs' gather path.
+  auto buf = folly::IOBuf::copyBuffer(payload.substr(0, 100));
+  buf->prependChain(folly::IOBuf::copyBuffer(payload.substr(100)));
+
+  for (auto algorithm : {CompressionAlgorithm::ZLIB,
+                         CompressionAlgorithm::ZSTD,
+                         CompressionAlgorithm::LZ4}) {
+    if (algorithm == CompressionAlgorithm::LZ4 &&
+        !folly::io::hasCodec(folly::io::CodecType::LZ4_VARINT_SIZE)) {
+      continue;
+    }
+    auto before = getPayloadCompressionStats(algorithm);
+    auto compressed = detail::compressPayload(*buf, algorithm);
+    EXPECT_LT(compressed->computeChainDataLength(), payload.size());
+    auto uncompressed = detail::uncompressPayload(*compressed, algorithm);
+    EXPECT_EQ(payload, toString(*uncompressed));
+
+    auto after = getPayloadCompressionStats(algorithm);
+    EXPECT_EQ(before.compress.calls + 1, after.compress.calls);
+    EXPECT_EQ(
+        before.compress.bytesIn + payload.size(), after.compress.bytesIn);
+    EXPECT_EQ(
+        before.compress.bytesOut + compressed->computeChainDataLength(),
+        after.compress.bytesOut);
+    EXPECT_EQ(before.uncompress.calls + 1, after.uncompress.calls);
+    EXPECT_EQ(
+        before.uncompress.bytesOut + payload.size(), after.uncompress.bytesOut);
+  }
+}
+
+TEST(PayloadCompression, Dictionary) {
+  auto payload = makePayload();
+  transport::registerZstdDictionary(
+      1234, folly::StringPiece(payload.substr(0, 256)));
+  auto buf = folly::IOBuf::copyBuffer(payload);
+
+  auto plain = detail::compressPayload(*buf, CompressionAlgorithm::ZSTD);
+  auto withDict =
+      detail::compressPayload(*buf, CompressionAlgorithm::ZSTD, 1234u);
+  EXPECT_LT(
+      withDict->computeChainDataLength(), plain->computeChainDataLength());
+
+  EXPECT_EQ(
+      payload,
+      toString(*detail::uncompressPayload(
+          *withDict, CompressionAlgorithm::ZSTD, 1234u)));
+  EXPECT_ANY_THROW(
+      detail::uncompressPayload(*withDict, CompressionAlgorithm::ZSTD));
+  EXPECT_ANY_THROW(
+      detail::compressPayload(*buf, CompressionAlgorithm::ZSTD, 4321u));
+  EXPECT_ANY_THROW(
+      detail::compressPayload(*buf, CompressionAlgorithm::ZLIB, 1234u));
+}
+
+TEST(PayloadCompression, Metadata) {
+  auto payload = makePayload();
+  auto compressed = detail::compressPayload(
+      *folly::IOBuf::copyBuffer(payload), CompressionAlgorithm::ZSTD);
+
+  ResponseRpcMetadata metadata;
+  auto same = folly::IOBuf::copyBuffer(payload);
+  auto* raw = same.get();
+  EXPECT_EQ(
+      raw, detail::uncompressResponsePayload(metadata, std::move(same)).get());
+
+  metadata.compression_ref() = CompressionAlgorithm::ZSTD;
+  EXPECT_EQ(
+      payload,
+      toString(
+          *detail::uncompressResponsePayload(metadata, compressed->clone())));
+
+  RequestRpcMetadata requestMetadata;
+  requestMetadata.compression_ref() = CompressionAlgorithm::ZSTD;
+  EXPECT_EQ(
+      payload,
+      toString(*detail::uncompressRequestPayload(
+          requestMetadata, std::move(compressed))));
+}
+
+TEST(PayloadCompression, DeclaredSizeTooLarge) {
+  // A zstd frame header declaring 1TB of content, with a single empty raw
+  // block: rejected before anything is allocated for it.
+  const uint8_t frame[] = {
+      0x28, 0xb5, 0x2f, 0xfd, // magic
+      0xe0, // single segment, 8-byte content size
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, // 1 << 40
+      0x01, 0x00, 0x00, // last raw block, empty
+  };
+  auto buf = folly::IOBuf::copyBuffer(frame, sizeof(frame));
+  try {
+    detail::uncompressPayload(*buf, CompressionAlgorithm::ZSTD);
+    ADD_FAILURE() << "Expected an exception";
+  } catch (const transport::TTransportException& ex) {
+    EXPECT_NE(std::string::npos, std::string(ex.what()).find("1099511627776"))
+        << ex.what();
+  }
+}
+
+TEST(PayloadCompression, DictionaryDeclaredSizeTooLarge) {
+  auto payload = makePayload();
+  transport::registerZstdDictionary(
+      1234, folly::StringPiece(payload.substr(0, 256)));
+  // As above, with a 2-byte dictionary id (1234) in the frame header.
+  const uint8_t frame[] = {
+      0x28, 0xb5, 0x2f, 0xfd, // magic
+      0xe2, // single segment, 8-byte content size, 2-byte dictionary id
+      0xd2, 0x04, // 1234
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, // 1 << 40
+      0x01, 0x00, 0x00, // last raw block, empty
+  };
+  auto buf = folly::IOBuf::copyBuffer(frame, sizeof(frame));
+  try {
+    detail::uncompressPayload(*buf, CompressionAlgorithm::ZSTD, 1234u);
+    ADD_FAILURE() << "Expected an exception";
+  } catch (const std::runtime_error& ex) {
+    EXPECT_NE(std::string::npos, std::string(ex.what()).find("1099511627776"))
+        << ex.what();
+  }
+}
+
+TEST(PayloadCompression, ConfiguredLimit) {
+  // Compresses to a few hundred bytes at most.
+  const std::string payload(1 << 20, 'x');
+  const uint64_t kLimit = 64 * 1024;
+  auto buf = folly::IOBuf::copyBuffer(payload);
+  transport::registerZstdDictionary(
+      1234, folly::StringPiece(makePayload().substr(0, 256)));
+
+  for (auto algorithm : {CompressionAlgorithm::ZLIB,
+                         CompressionAlgorithm::ZSTD,
+                         CompressionAlgorithm::LZ4}) {
+    if (algorithm == CompressionAlgorithm::LZ4 &&
+        !folly::io::hasCodec(folly::io::CodecType::LZ4_VARINT_SIZE)) {
+      continue;
+    }
+    auto compressed = detail::compressPayload(*buf, algorithm);
+    EXPECT_THROW(
+        detail::uncompressPayload(*compressed, algorithm, folly::none, kLimit),
+        transport::TTransportException);
+    EXPECT_EQ(
+        payload,
+        toString(*detail::uncompressPayload(
+            *compressed, algorithm, folly::none, payload.size())));
+  }
+
+  auto withDict =
+      detail::compressPayload(*buf, CompressionAlgorithm::ZSTD, 1234u);
+  EXPECT_THROW(
+      detail::uncompressPayload(
+          *withDict, CompressionAlgorithm::ZSTD, 1234u, kLimit),
+      std::runtime_error);
+  EXPECT_EQ(
+      payload,
+      toString(*detail::uncompressPayload(
+          *withDict, CompressionAlgorithm::ZSTD, 1234u, payload.size())));
+
+  RequestRpcMetadata metadata;
+  metadata.compression_ref() = CompressionAlgorithm::ZSTD;
+  metadata.compressionDictionaryId_ref() = 1234;
+  EXPECT_ANY_THROW(
+      detail::uncompressRequestPayload(metadata, withDict->clone(), kLimit));
+}
@@ -15,7 +15,10 @@
  */
 
 #include <thrift/lib/cpp2/transport/core/ThriftProcessor.h>
+#include <chrono>
+#include <folly/synchronization/Baton.h>
 #include <thrift/lib/cpp/concurrency/PosixThreadFactory.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
 #include <thrift/lib/cpp2/async/AsyncProcessor.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/transport/core/testutil/CoreTestFixture.h>
@@ -94,5 +97,97 @@ TEST_F(CoreTestFixture, BadMetadata) {
   EXPECT_EQ(TApplicationException::UNSUPPORTED_CLIENT_TYPE, tae.getType());
 }
 
+TEST_F(CoreTestFixture, DeadlineExpiresInQueue) {
+  auto threadManager = concurrency::ThreadManager::newSimpleThreadManager(1);
+  threadManager->threadFactory(
+      std::make_shared<concurrency::PosixThreadFactory>());
+  threadManager->setExpireCallback(
+      [](std::shared_ptr<concurrency::Runnable> r) {
+        if (auto task = dynamic_cast<EventTask*>(r.get())) {
+          task->expired();
+        }
+      });
+  threadManager->start();
+  processor_.setThreadManager(threadManager.get());
+
+  // Keep the only worker busy until the deadline of the request has passed.
+  // The strict mock fails the test if the handler runs.
+  folly::Baton<> blocked;
+  folly::Baton<> release;
+  threadManager->add([&] {
+    blocked.post();
+    release.wait();
+  });
+  blocked.wait();
+
+  runInEventBaseThread([&]() mutable {
+    RequestRpcMetadata metadata;
+    folly::IOBufQueue request;
+    serializeSumTwoNumbers(5, 10, false, &request, &metadata);
+    metadata.deadlineBudgetMs_ref() = 20;
+    auto channel = std::shared_ptr<ThriftChannelIf>(channel_);
+    processor_.onThriftRequest(std::move(metadata), request.move(), channel);
+    eventBase_.runAfterDelay([&] { release.post(); }, 100);
+  });
+  threadManager->join();
+
+  TApplicationException tae;
+  EXPECT_TRUE(deserializeException(channel_->getPayloadBuf(), &tae));
+  EXPECT_EQ(TApplicationException::TIMEOUT, tae.getType());
+  EXPECT_EQ(
+      kTaskExpiredErrorCode,
+      channel_->getMetadata()->otherMetadata_ref()->at("ex"));
+}
+
+TEST_F(CoreTestFixture, DeadlineExceededBeforeQueueing) {
+  runInEventBaseThread([&]() mutable {
+    RequestRpcMetadata metadata;
+    folly::IOBufQueue request;
+    serializeSumTwoNumbers(5, 10, false, &request, &metadata);
+    metadata.clientTimeoutMs_ref() = 10000;
+    metadata.deadlineBudgetMs_ref() = 0;
+    auto channel = std::shared_ptr<ThriftChannelIf>(channel_);
+    processor_.onThriftRequest(std::move(metadata), request.move(), channel);
+  });
+
+  EXPECT_EQ(0, threadManager_->addedTaskCount());
+  TApplicationException tae;
+  EXPECT_TRUE(deserializeException(channel_->getPayloadBuf(), &tae));
+  EXPECT_EQ(TApplicationException::TIMEOUT, tae.getType());
+  EXPECT_EQ(
+      kTaskExpiredErrorCode,
+      channel_->getMetadata()->otherMetadata_ref()->at("ex"));
+}
+
+TEST_F(CoreTestFixture, DeadlineIsEarliestOfTimeoutAndBudget) {
+  auto remaining = [&](int32_t clientTimeoutMs, int32_t deadlineBudgetMs) {
+    folly::Optional<std::chrono::milliseconds> timeRemaining;
+    EXPECT_CALL(service_, sumTwoNumbers_(5, 10)).WillOnce(Invoke([&](int, int) {
+      timeRemaining = service_.getConnectionContext()->getTimeRemaining();
+      return 0;
+    }));
+    channel_ = std::make_shared<FakeChannel>(&eventBase_);
+    runInEventBaseThread([&]() mutable {
+      RequestRpcMetadata metadata;
+      folly::IOBufQueue request;
+      serializeSumTwoNumbers(5, 10, false, &request, &metadata);
+      metadata.clientTimeoutMs_ref() = clientTimeoutMs;
+      metadata.deadlineBudgetMs_ref() = deadlineBudgetMs;
+      auto channel = std::shared_ptr<ThriftChannelIf>(channel_);
+      processor_.onThriftRequest(std::move(metadata), request.move(), channel);
+    });
+    EXPECT_EQ(15, deserializeSumTwoNumbers(channel_->getPayloadBuf()));
+    return timeRemaining.value_or(std::chrono::milliseconds(-1));
+  };
+
+  auto timeRemaining = remaining(60000, 30000);
+  EXPECT_LE(timeRemaining, std::chrono::milliseconds(30000));
+  EXPECT_GT(timeRemaining, std::chrono::milliseconds(20000));
+
+  timeRemaining = remaining(30000, 60000);
+  EXPECT_LE(timeRemaining, std::chrono::milliseconds(30000));
+  EXPECT_GT(timeRemaining, std::chrono::milliseconds(20000));
+}
+
 } // namespace thrift
 } // namespace apache
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <thrift/lib/cpp/concurrency/PosixThreadFactory.h>
 #include <thrift/lib/cpp/concurrency/Thread.h>
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
@@ -37,10 +39,16 @@ class FakeThreadManager : public apache::thrift::concurrency::ThreadManager {
       int64_t /*expiration*/,
       bool /*cancellable*/,
       bool /*numa*/) noexcept {
+    ++addedTaskCount_;
     auto thread = factory_.newThread(task);
     thread->start();
   }
 
+  // Number of tasks handed to add() so far.
+  size_t addedTaskCount() const {
+    return addedTaskCount_;
+  }
+
   // Following methods are not required for this fake object.
 
   void add(folly::Func /*f*/) noexcept override {
@@ -154,6 +162,7 @@ class FakeThreadManager : public apache::thrift::concurrency::ThreadManager {
 
  private:
   apache::thrift::concurrency::PosixThreadFactory factory_;
+  std::atomic<size_t> addedTaskCount_{0};
   bool throwOnAdd_{false};
 };
 
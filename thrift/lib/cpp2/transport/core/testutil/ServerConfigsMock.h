@@ -19,6 +19,7 @@
 #include <string>
 
 #include <thrift/lib/cpp/transport/THeader.h>
+#include <thrift/lib/cpp/transport/ZstdDictionary.h>
 #include <thrift/lib/cpp2/async/ResponseChannel.h>
 #include <thrift/lib/cpp2/server/ServerConfigs.h>
 #include <thrift/lib/cpp2/transport/core/testutil/FakeServerObserver.h>
@@ -35,6 +36,10 @@ class ServerConfigsMock : public ServerConfigs {
     return maxResponseSize_;
   }
 
+  uint64_t getMaxUncompressedRequestSize() const override {
+    return maxUncompressedRequestSize_;
+  }
+
   /**
    * @see BaseThriftServer::getTaskExpireTimeForRequest function.
    */
@@ -85,6 +90,8 @@ class ServerConfigsMock : public ServerConfigs {
 
  public:
   uint64_t maxResponseSize_{0};
+  uint64_t maxUncompressedRequestSize_{
+      transport::ZstdDictionary::kDefaultMaxUncompressedBytes};
   std::chrono::milliseconds queueTimeout_{std::chrono::milliseconds(500)};
   std::chrono::milliseconds taskTimeout_{std::chrono::milliseconds(500)};
   std::shared_ptr<apache::thrift::server::TServerObserver> observer_{
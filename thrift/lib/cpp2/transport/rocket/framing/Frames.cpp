@@ -404,17 +404,23 @@ void PayloadFrame::serializeIntoSingleFrame(Serializer& writer) && {
   DCHECK_EQ(Serializer::kBytesForFrameOrMetadataLength + frameSize, nwritten);
 }
 
-std::unique_ptr<folly::IOBuf> PayloadFrame::serialize() && {
+std::unique_ptr<folly::IOBuf> PayloadFrame::serialize(size_t* bytesCopied) && {
   constexpr size_t kRsocketOverheadMax = 3 + 6 + 3;
   if (LIKELY(
           payload_.metadataAndDataSize() <= kMaxFragmentedPayloadSize &&
           payload_.hasNonemptyMetadata() &&
           payload_.metadata()->headroom() >= kRsocketOverheadMax)) {
     // Use headroom in the metadata struct for rsocket header.
+    if (bytesCopied) {
+      *bytesCopied = 0;
+    }
     return std::move(*this).serializeUsingMetadataHeadroom();
   }
   Serializer writer;
   std::move(*this).serialize(writer);
+  if (bytesCopied) {
+    *bytesCopied = writer.bytesCopied();
+  }
   return std::move(writer).move();
 }
 
@@ -450,19 +456,11 @@ PayloadFrame::serializeUsingMetadataHeadroom() && {
   DCHECK_EQ(writer.result().size(), rsocketLen);
   metadata->prepend(rsocketLen);
 
-  // Append data to metadata, packing into the metadata buf
-  // if under threshold (short iovecs better).
-  folly::IOBuf* tail = metadata->prev();
-  if (dataLen <= tail->tailroom() &&
-      dataLen <= folly::IOBufQueue::kMaxPackCopy) {
-    for (; data; data = data->pop()) {
-      size_t n = data->length();
-      DCHECK_GE(tail->tailroom(), n);
-      memcpy(tail->writableTail(), data->data(), n);
-      tail->append(n);
-    }
-  } else {
-    tail->appendChain(std::move(data));
+  // Link the data in after the metadata rather than copying it into the
+  // metadata buffer, so that it is written straight from where the handler
+  // serialized it.
+  if (dataLen > 0) {
+    metadata->prependChain(std::move(data));
   }
   return metadata;
 }
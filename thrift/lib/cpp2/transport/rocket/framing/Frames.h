@@ -427,7 +427,10 @@ class PayloadFrame {
     return flags_.next();
   }
 
-  std::unique_ptr<folly::IOBuf> serialize() &&;
+  // Returns the frame as a chain of the frame header, the metadata and the
+  // data, with the payload IOBufs linked rather than copied. If bytesCopied
+  // is given, it is set to the number of payload bytes that had to be copied.
+  std::unique_ptr<folly::IOBuf> serialize(size_t* bytesCopied = nullptr) &&;
   void serialize(Serializer& writer) &&;
 
  private:
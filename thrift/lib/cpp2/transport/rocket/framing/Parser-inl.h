@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 
 #include <folly/io/Cursor.h>
@@ -27,6 +29,7 @@
 
 #include <thrift/lib/cpp/transport/TTransportException.h>
 #include <thrift/lib/cpp2/transport/rocket/framing/FrameType.h>
+#include <thrift/lib/cpp2/transport/rocket/framing/ReadBufferPool.h>
 #include <thrift/lib/cpp2/transport/rocket/framing/Serializer.h>
 #include <thrift/lib/cpp2/transport/rocket/framing/Util.h>
 
@@ -38,7 +41,23 @@ template <class T>
 void Parser<T>::getReadBuffer(void** bufout, size_t* lenout) {
   DCHECK(!readBuffer_.isChained());
 
-  resizeBuffer();
+  if (readBuffer_.capacity() == 0) {
+    allocateBuffer();
+  } else if (bufferPolicy_ == ParserBufferPolicy::GROW) {
+    resizeBuffer();
+  }
+
+  if (directFrameSize_ != 0) {
+    // Read no further than the end of the frame, so that the buffer ends up
+    // holding exactly the frame and can be handed off as it is.
+    DCHECK_EQ(0, readBuffer_.headroom());
+    DCHECK(!readBuffer_.isSharedOne());
+    DCHECK_LT(readBuffer_.length(), directFrameSize_);
+    *bufout = readBuffer_.writableTail();
+    *lenout = directFrameSize_ - readBuffer_.length();
+    return;
+  }
+
   readBuffer_.unshareOne();
 
   if (readBuffer_.length() == 0) {
@@ -58,8 +77,6 @@ template <class T>
 void Parser<T>::readDataAvailable(size_t nbytes) noexcept {
   folly::DelayedDestruction::DestructorGuard dg(&this->owner_);
 
-  constexpr size_t kBytesForFrameSize = 3;
-
   readBuffer_.append(nbytes);
 
   while (!readBuffer_.empty()) {
@@ -73,16 +90,23 @@ void Parser<T>::readDataAvailable(size_t nbytes) noexcept {
 
     if (readBuffer_.length() < totalFrameSize) {
       if (readBuffer_.length() + readBuffer_.tailroom() < totalFrameSize) {
-        DCHECK(!readBuffer_.isChained());
-        readBuffer_.unshareOne();
-        bufferSize_ = std::max<size_t>(bufferSize_, totalFrameSize);
-        readBuffer_.reserve(
-            0 /* minHeadroom */,
-            bufferSize_ - readBuffer_.length() /* minTailroom */);
+        growBuffer(totalFrameSize);
       }
       return;
     }
 
+    if (directFrameSize_ != 0) {
+      // The buffer was allocated for this frame alone; hand it off instead of
+      // cloning out of it.
+      DCHECK_EQ(directFrameSize_, totalFrameSize);
+      directFrameSize_ = 0;
+      auto frame = std::make_unique<folly::IOBuf>(std::move(readBuffer_));
+      readBuffer_ = folly::IOBuf();
+      frame->trimStart(Serializer::kBytesForFrameOrMetadataLength);
+      owner_.handleFrame(std::move(frame));
+      return;
+    }
+
     // Otherwise, we have a full frame to handle.
     const size_t bytesToClone =
         totalFrameSize - Serializer::kBytesForFrameOrMetadataLength;
@@ -92,7 +116,9 @@ void Parser<T>::readDataAvailable(size_t nbytes) noexcept {
     readBuffer_.trimStart(totalFrameSize);
   }
 
-  // TODO Periodically shrink the buffer back to kMaxBufferSize
+  if (bufferPolicy_ == ParserBufferPolicy::POOLED) {
+    releaseBuffer();
+  }
 }
 
 template <class T>
@@ -135,6 +161,53 @@ void Parser<T>::resizeBuffer() {
   }
 }
 
+template <class T>
+void Parser<T>::allocateBuffer() {
+  if (bufferPolicy_ == ParserBufferPolicy::POOLED) {
+    readBuffer_ = ReadBufferPool::get().acquire();
+  } else {
+    readBuffer_ = folly::IOBuf(folly::IOBuf::CreateOp(), bufferSize_);
+  }
+}
+
+template <class T>
+void Parser<T>::growBuffer(size_t totalFrameSize) {
+  DCHECK(!readBuffer_.isChained());
+  if (bufferPolicy_ == ParserBufferPolicy::GROW) {
+    readBuffer_.unshareOne();
+    bufferSize_ = std::max<size_t>(bufferSize_, totalFrameSize);
+    readBuffer_.reserve(
+        0 /* minHeadroom */,
+        bufferSize_ - readBuffer_.length() /* minTailroom */);
+    return;
+  }
+
+  // A frame that fits a pooled buffer only needs the partial data moved to
+  // the front, which getReadBuffer() does.
+  if (totalFrameSize <= ReadBufferPool::kBufferSize &&
+      ReadBufferPool::isPoolSized(readBuffer_)) {
+    return;
+  }
+
+  // Read the rest of the frame straight into a buffer of exactly its size,
+  // which becomes the frame itself. Only the part already read is copied.
+  folly::IOBuf buf(folly::IOBuf::CreateOp(), totalFrameSize);
+  memcpy(buf.writableTail(), readBuffer_.data(), readBuffer_.length());
+  buf.append(readBuffer_.length());
+  std::swap(readBuffer_, buf);
+  ReadBufferPool::get().release(std::move(buf));
+  directFrameSize_ = totalFrameSize;
+}
+
+template <class T>
+void Parser<T>::releaseBuffer() {
+  DCHECK(readBuffer_.empty());
+  if (readBuffer_.capacity() != 0) {
+    ReadBufferPool::get().release(std::move(readBuffer_));
+    readBuffer_ = folly::IOBuf();
+  }
+}
+
 template <class T>
 constexpr size_t Parser<T>::kMinBufferSize;
 template <class T>
@@ -28,14 +28,29 @@ namespace apache {
 namespace thrift {
 namespace rocket {
 
+// How a Parser sizes its read buffer.
+enum class ParserBufferPolicy {
+  // One buffer per connection, grown to the largest frame seen and shrunk
+  // back to kMaxBufferSize by resizeBuffer() at most once per resize interval.
+  GROW,
+  // Buffers of kMaxBufferSize come from the thread's ReadBufferPool, and the
+  // buffer is given up whenever it holds no partial frame. Once the length of
+  // a frame that does not fit is known, the rest of it is read directly into
+  // a buffer of exactly its size, which is then handed off as the frame.
+  POOLED,
+};
+
 template <class T>
 class Parser final : public folly::AsyncTransportWrapper::ReadCallback {
  public:
   explicit Parser(
       T& owner,
       std::chrono::milliseconds resizeBufferTimeout =
-          kDefaultBufferResizeInterval)
-      : owner_(owner), resizeBufferTimeout_(resizeBufferTimeout) {}
+          kDefaultBufferResizeInterval,
+      ParserBufferPolicy bufferPolicy = ParserBufferPolicy::POOLED)
+      : owner_(owner),
+        resizeBufferTimeout_(resizeBufferTimeout),
+        bufferPolicy_(bufferPolicy) {}
 
   // AsyncTransportWrapper::ReadCallback implementation
   FOLLY_NOINLINE void getReadBuffer(void** bufout, size_t* lenout) override;
@@ -60,6 +75,15 @@ class Parser final : public folly::AsyncTransportWrapper::ReadCallback {
     bufferSize_ = size;
   }
 
+  // Bytes of read buffer currently held by this connection.
+  size_t getReadBufferMemory() const {
+    return readBuffer_.capacity();
+  }
+
+  ParserBufferPolicy getBufferPolicy() const {
+    return bufferPolicy_;
+  }
+
   void resizeBuffer();
 
   static constexpr size_t kMinBufferSize{256};
@@ -69,12 +93,21 @@ class Parser final : public folly::AsyncTransportWrapper::ReadCallback {
   static constexpr std::chrono::milliseconds kDefaultBufferResizeInterval{
       std::chrono::seconds(3)};
 
+  void allocateBuffer();
+  void growBuffer(size_t totalFrameSize);
+  void releaseBuffer();
+
   T& owner_;
   size_t bufferSize_{kMinBufferSize};
-  folly::IOBuf readBuffer_{folly::IOBuf::CreateOp(), bufferSize_};
+  // Empty (no capacity) until the socket first becomes readable
+  folly::IOBuf readBuffer_;
   std::chrono::steady_clock::time_point resizeBufferTimer_{
       std::chrono::steady_clock::now()};
   const std::chrono::milliseconds resizeBufferTimeout_;
+  const ParserBufferPolicy bufferPolicy_;
+  // Size (including length prefix) of the frame being read directly into
+  // readBuffer_, or 0
+  size_t directFrameSize_{0};
 };
 
 } // namespace rocket
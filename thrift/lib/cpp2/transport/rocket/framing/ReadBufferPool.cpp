@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thrift/lib/cpp2/transport/rocket/framing/ReadBufferPool.h>
+
+#include <utility>
+
+#include <folly/SingletonThreadLocal.h>
+
+namespace apache {
+namespace thrift {
+namespace rocket {
+
+namespace {
+struct ReadBufferPoolTag {};
+} // namespace
+
+constexpr size_t ReadBufferPool::kBufferSize;
+constexpr size_t ReadBufferPool::kDefaultMaxPooledBuffers;
+
+ReadBufferPool& ReadBufferPool::get() {
+  return folly::SingletonThreadLocal<ReadBufferPool, ReadBufferPoolTag>::get();
+}
+
+folly::IOBuf ReadBufferPool::acquire() {
+  if (free_.empty()) {
+    ++stats_.buffersAllocated;
+    return folly::IOBuf(folly::IOBuf::CreateOp(), kBufferSize);
+  }
+  ++stats_.buffersReused;
+  auto buf = std::move(free_.back());
+  free_.pop_back();
+  return buf;
+}
+
+void ReadBufferPool::release(folly::IOBuf&& buf) {
+  if (free_.size() >= maxPooledBuffers_ || buf.isChained() ||
+      buf.isSharedOne() || !isPoolSized(buf)) {
+    return;
+  }
+  buf.clear();
+  free_.push_back(std::move(buf));
+}
+
+} // namespace rocket
+} // namespace thrift
+} // namespace apache
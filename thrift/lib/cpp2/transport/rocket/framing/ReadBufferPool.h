@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019-present Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <folly/io/IOBuf.h>
+
+namespace apache {
+namespace thrift {
+namespace rocket {
+
+/**
+ * Free list of fixed-size read buffers shared by all rocket connections
+ * whose sockets are read on the same thread, i.e. by the same EventBase.
+ *
+ * Connections take a buffer when the socket becomes readable and give it back
+ * as soon as it holds no partial frame, so an idle connection does not pin
+ * any read buffer memory.
+ */
+class ReadBufferPool {
+ public:
+  static constexpr size_t kBufferSize{4096};
+  static constexpr size_t kDefaultMaxPooledBuffers{64};
+
+  struct Stats {
+    // Buffers currently sitting in the free list
+    size_t buffersPooled{0};
+    // Buffers handed out by acquire() that had to be allocated
+    size_t buffersAllocated{0};
+    // Buffers handed out by acquire() that came from the free list
+    size_t buffersReused{0};
+  };
+
+  explicit ReadBufferPool(size_t maxPooledBuffers = kDefaultMaxPooledBuffers)
+      : maxPooledBuffers_(maxPooledBuffers) {}
+
+  ReadBufferPool(const ReadBufferPool&) = delete;
+  ReadBufferPool& operator=(const ReadBufferPool&) = delete;
+
+  // The pool of the calling thread.
+  static ReadBufferPool& get();
+
+  // Returns an empty buffer with at least kBufferSize bytes of tailroom.
+  folly::IOBuf acquire();
+
+  // Takes back a buffer. Buffers that are chained, shared with frames still
+  // in flight or not of the pool's size are freed instead.
+  void release(folly::IOBuf&& buf);
+
+  static bool isPoolSized(const folly::IOBuf& buf) {
+    return buf.capacity() >= kBufferSize && buf.capacity() < 2 * kBufferSize;
+  }
+
+  Stats getStats() const {
+    Stats stats = stats_;
+    stats.buffersPooled = free_.size();
+    return stats;
+  }
+
+  size_t getPooledBytes() const {
+    return free_.size() * kBufferSize;
+  }
+
+ private:
+  const size_t maxPooledBuffers_;
+  std::vector<folly::IOBuf> free_;
+  Stats stats_;
+};
+
+} // namespace rocket
+} // namespace thrift
+} // namespace apache
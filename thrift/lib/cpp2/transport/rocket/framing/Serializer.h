@@ -60,18 +60,20 @@ class Serializer {
     return writeBE(static_cast<uint32_t>(streamId));
   }
 
+  // IOBufs are linked into the output as they are, never packed into the
+  // buffer holding the frame header, so each one goes out as its own iovec.
   size_t write(const folly::IOBuf& buf) {
-    appender_.insert(buf);
-    return buf.computeChainDataLength();
+    return write(buf.clone());
   }
 
   size_t write(std::unique_ptr<folly::IOBuf> buf) {
     auto r = buf->computeChainDataLength();
-    appender_.insert(std::move(buf));
+    queue_.append(std::move(buf), false /* pack */);
     return r;
   }
 
   size_t write(folly::StringPiece sp) {
+    bytesCopied_ += sp.size();
     appender_.push(reinterpret_cast<const uint8_t*>(sp.data()), sp.size());
     return sp.size();
   }
@@ -92,9 +94,16 @@ class Serializer {
     return queue_.move();
   }
 
+  // Bytes other than frame headers that were copied into the output so far.
+  size_t bytesCopied() const {
+    return bytesCopied_;
+  }
+
  private:
   static constexpr size_t kQueueAppenderChunkSize = 512;
 
+  size_t bytesCopied_{0};
+
   folly::IOBufQueue queue_{folly::IOBufQueue::cacheChainLength()};
   folly::io::QueueAppender appender_{&queue_, kQueueAppenderChunkSize};
 
@@ -15,6 +15,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include <folly/portability/GTest.h>
@@ -561,6 +562,49 @@ TEST(FrameSerialization, PayloadFrameSerializeAPI) {
   validate(std::make_unique<folly::IOBuf>(), folly::IOBuf::wrapBuffer(kData));
 }
 
+TEST(FrameSerialization, PayloadFrameSerializeLinksData) {
+  auto validate = [](std::unique_ptr<folly::IOBuf> md) {
+    constexpr size_t kDataSize = 64 << 10;
+    auto data = folly::IOBuf::create(kDataSize);
+    data->append(kDataSize);
+    std::memset(data->writableData(), 'x', kDataSize);
+    const uint8_t* const dataPtr = data->data();
+
+    PayloadFrame frame(
+        kTestStreamId,
+        Payload::makeFromMetadataAndData(std::move(md), std::move(data)),
+        Flags::none().next(true).complete(true));
+    size_t bytesCopied = 1;
+    auto buf = std::move(frame).serialize(&bytesCopied);
+    EXPECT_EQ(0, bytesCopied);
+
+    // The data buffer must be linked into the frame as its own element.
+    bool found = false;
+    for (const auto& br : *buf) {
+      if (br.data() == dataPtr) {
+        EXPECT_EQ(kDataSize, br.size());
+        found = true;
+      }
+    }
+    EXPECT_TRUE(found);
+  };
+
+  // Header is written into the metadata headroom.
+  validate(
+      folly::IOBuf::wrapBuffer(kMetadata)->cloneCoalescedWithHeadroomTailroom(
+          16, 256));
+  // Header is written by a Serializer.
+  validate(folly::IOBuf::copyBuffer(kMetadata));
+}
+
+TEST(FrameSerialization, SerializerCountsCopiedBytes) {
+  Serializer writer;
+  writer.write(folly::IOBuf::copyBuffer(kData));
+  EXPECT_EQ(0, writer.bytesCopied());
+  writer.write(kMetadata);
+  EXPECT_EQ(kMetadata.size(), writer.bytesCopied());
+}
+
 } // namespace rocket
 } // namespace thrift
 } // namespace apache
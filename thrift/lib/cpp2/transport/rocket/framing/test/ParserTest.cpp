@@ -15,9 +15,15 @@
  */
 #include <folly/portability/GTest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <folly/ExceptionWrapper.h>
 #include <folly/io/async/DelayedDestruction.h>
 #include <thrift/lib/cpp2/transport/rocket/framing/Parser.h>
+#include <thrift/lib/cpp2/transport/rocket/framing/ReadBufferPool.h>
 
 namespace apache {
 namespace thrift {
@@ -25,10 +31,43 @@ namespace rocket {
 
 class FakeOwner : public folly::DelayedDestruction {
  public:
-  void handleFrame(std::unique_ptr<folly::IOBuf>) {}
+  void handleFrame(std::unique_ptr<folly::IOBuf> frame) {
+    frameSizes.push_back(frame->computeChainDataLength());
+    lastFrameShared = frame->isChained() || frame->isSharedOne();
+  }
   void close(folly::exception_wrapper) noexcept {}
+
+  std::vector<size_t> frameSizes;
+  bool lastFrameShared{false};
 };
 
+namespace {
+// A frame of the given payload size, preceded by its 3 byte length.
+std::string makeFrame(size_t size) {
+  std::string frame(3 + size, 'x');
+  frame[0] = static_cast<char>(size >> 16);
+  frame[1] = static_cast<char>(size >> 8);
+  frame[2] = static_cast<char>(size);
+  return frame;
+}
+
+// Feeds data to the parser the way AsyncSocket would, in reads of at most
+// maxRead bytes.
+void feed(Parser<FakeOwner>& parser, const std::string& data, size_t maxRead) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    void* buf;
+    size_t len;
+    parser.getReadBuffer(&buf, &len);
+    ASSERT_GT(len, 0);
+    const size_t n = std::min({len, maxRead, data.size() - offset});
+    std::memcpy(buf, data.data() + offset, n);
+    offset += n;
+    parser.readDataAvailable(n);
+  }
+}
+} // namespace
+
 TEST(ParserTest, resizeBufferTest) {
   FakeOwner owner;
   Parser<FakeOwner> parser(owner, std::chrono::milliseconds(0));
@@ -59,6 +98,70 @@ TEST(ParserTest, noResizeBufferTest) {
   EXPECT_EQ(parser.getReadBufferSize(), Parser<FakeOwner>::kMaxBufferSize * 2);
 }
 
+TEST(ParserTest, pooledBufferReleasedWhenIdle) {
+  FakeOwner owner;
+  Parser<FakeOwner> parser(owner);
+  EXPECT_EQ(0, parser.getReadBufferMemory());
+
+  feed(parser, makeFrame(100) + makeFrame(200), 1000);
+  EXPECT_EQ(std::vector<size_t>({100, 200}), owner.frameSizes);
+  EXPECT_EQ(0, parser.getReadBufferMemory());
+
+  // Partial frame keeps the buffer.
+  feed(parser, makeFrame(100).substr(0, 50), 1000);
+  EXPECT_GE(parser.getReadBufferMemory(), ReadBufferPool::kBufferSize);
+}
+
+TEST(ParserTest, pooledBufferReused) {
+  FakeOwner owner;
+  Parser<FakeOwner> parser(owner);
+  auto& pool = ReadBufferPool::get();
+
+  feed(parser, makeFrame(10), 1000);
+  const auto before = pool.getStats();
+  feed(parser, makeFrame(10), 1000);
+  feed(parser, makeFrame(10), 1000);
+  const auto after = pool.getStats();
+  EXPECT_EQ(2, after.buffersReused - before.buffersReused);
+}
+
+TEST(ParserTest, pooledLargeFrameUsesExactBuffer) {
+  FakeOwner owner;
+  Parser<FakeOwner> parser(owner);
+  const size_t kFrameSize = 1 << 20;
+
+  const auto frame = makeFrame(kFrameSize);
+  feed(parser, frame.substr(0, 100000), 4096);
+  EXPECT_GE(parser.getReadBufferMemory(), kFrameSize + 3);
+  EXPECT_LT(parser.getReadBufferMemory(), 2 * (kFrameSize + 3));
+
+  // Reads stop at the end of the frame.
+  void* buf;
+  size_t len;
+  parser.getReadBuffer(&buf, &len);
+  EXPECT_EQ(frame.size() - 100000, len);
+
+  feed(parser, frame.substr(100000) + makeFrame(10).substr(0, 5), 4096);
+  EXPECT_EQ(std::vector<size_t>({kFrameSize}), owner.frameSizes);
+  // The frame is the buffer it was read into, not a clone out of it.
+  EXPECT_FALSE(owner.lastFrameShared);
+
+  feed(parser, makeFrame(10).substr(5), 4096);
+  EXPECT_EQ(std::vector<size_t>({kFrameSize, 10}), owner.frameSizes);
+  EXPECT_EQ(0, parser.getReadBufferMemory());
+}
+
+TEST(ParserTest, growPolicyKeepsBuffer) {
+  FakeOwner owner;
+  Parser<FakeOwner> parser(
+      owner, std::chrono::seconds(3), ParserBufferPolicy::GROW);
+
+  feed(parser, makeFrame(10000), 4096);
+  EXPECT_EQ(std::vector<size_t>({10000}), owner.frameSizes);
+  EXPECT_GE(parser.getReadBufferMemory(), 10003);
+  EXPECT_GE(parser.getReadBufferSize(), 10003);
+}
+
 } // namespace rocket
 } // namespace thrift
 } // namespace apache
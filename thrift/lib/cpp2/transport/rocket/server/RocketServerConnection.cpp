@@ -65,13 +65,19 @@ RocketServerConnection::createStreamSubscriber(
   return subscriber;
 }
 
-void RocketServerConnection::send(std::unique_ptr<folly::IOBuf> data) {
+void RocketServerConnection::send(
+    std::unique_ptr<folly::IOBuf> data,
+    size_t bytesCopied) {
   evb_.dcheckIsInEventBaseThread();
 
   if (state_ != ConnectionState::ALIVE) {
     return;
   }
 
+  ++writeStats_.frames;
+  writeStats_.bytes += data->computeChainDataLength();
+  writeStats_.bytesCopied += bytesCopied;
+
   batchWriteLoopCallback_.enqueueWrite(std::move(data));
   if (!batchWriteLoopCallback_.isLoopCallbackScheduled()) {
     evb_.runInLoop(&batchWriteLoopCallback_, true /* thisIteration */);
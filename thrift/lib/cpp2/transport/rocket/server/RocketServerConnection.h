@@ -50,7 +50,16 @@ class RocketServerConnection
       folly::AsyncTransportWrapper::UniquePtr socket,
       std::shared_ptr<RocketServerHandler> frameHandler);
 
-  void send(std::unique_ptr<folly::IOBuf> data);
+  // Per-connection accounting of outgoing frames. bytesCopied counts payload
+  // bytes that were copied while serializing frames, as opposed to being
+  // linked into the written chain.
+  struct WriteStats {
+    uint64_t frames{0};
+    uint64_t bytes{0};
+    uint64_t bytesCopied{0};
+  };
+
+  void send(std::unique_ptr<folly::IOBuf> data, size_t bytesCopied = 0);
 
   // Create a stream subscriber with initialRequestN credits
   static std::shared_ptr<RocketServerStreamSubscriber> createStreamSubscriber(
@@ -85,6 +94,15 @@ class RocketServerConnection
     return streams_.size();
   }
 
+  const WriteStats& getWriteStats() const {
+    return writeStats_;
+  }
+
+  // Read buffer memory held by this connection; zero while it is idle.
+  size_t getReadBufferMemory() const {
+    return parser_.getReadBufferMemory();
+  }
+
  private:
   // Note that attachEventBase()/detachEventBase() are not supported in server
   // code
@@ -104,6 +122,7 @@ class RocketServerConnection
     CLOSED,
   };
   ConnectionState state_{ConnectionState::ALIVE};
+  WriteStats writeStats_;
 
   // streams_ map only maintains entries for REQUEST_STREAM streams
   std::unordered_map<StreamId, std::shared_ptr<RocketServerStreamSubscriber>>
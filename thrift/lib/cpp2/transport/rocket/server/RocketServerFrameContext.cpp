@@ -59,8 +59,10 @@ void RocketServerFrameContext::sendPayload(Payload&& payload, Flags flags) {
   DCHECK(connection_);
   DCHECK(flags.next() || flags.complete());
 
-  auto buf = PayloadFrame(streamId_, std::move(payload), flags).serialize();
-  connection_->send(std::move(buf));
+  size_t bytesCopied = 0;
+  auto buf = PayloadFrame(streamId_, std::move(payload), flags)
+                 .serialize(&bytesCopied);
+  connection_->send(std::move(buf), bytesCopied);
 }
 
 void RocketServerFrameContext::sendError(RocketException&& rex) {
@@ -68,7 +70,8 @@ void RocketServerFrameContext::sendError(RocketException&& rex) {
 
   Serializer writer;
   ErrorFrame(streamId_, std::move(rex)).serialize(writer);
-  connection_->send(std::move(writer).move());
+  const auto bytesCopied = writer.bytesCopied();
+  connection_->send(std::move(writer).move(), bytesCopied);
 }
 
 void RocketServerFrameContext::onFullFrame(
@@ -29,9 +29,11 @@
 #include <rsocket/RSocketParameters.h>
 
 #include <thrift/lib/cpp/TApplicationException.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/server/Cpp2ConnContext.h>
 #include <thrift/lib/cpp2/server/Cpp2Worker.h>
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
 #include <thrift/lib/cpp2/transport/core/ThriftRequest.h>
 #include <thrift/lib/cpp2/transport/rocket/RocketException.h>
 #include <thrift/lib/cpp2/transport/rocket/framing/ErrorCode.h>
@@ -67,6 +69,22 @@ bool isMetadataValid(const RequestRpcMetadata& metadata) {
   return metadata.protocol_ref() && metadata.name_ref() &&
       metadata.kind_ref() && metadata.seqId_ref();
 }
+
+// Replaces 'data' with its uncompressed form if the client compressed it.
+bool uncompressRequest(
+    const RequestRpcMetadata& metadata,
+    std::unique_ptr<folly::IOBuf>& data,
+    uint64_t maxUncompressedBytes) {
+  try {
+    data = detail::uncompressRequestPayload(
+        metadata, std::move(data), maxUncompressedBytes);
+    return true;
+  } catch (const std::exception& ex) {
+    FB_LOG_EVERY_MS(ERROR, 10000)
+        << "Exception on uncompressing request: " << folly::exceptionStr(ex);
+    return false;
+  }
+}
 } // namespace
 
 ThriftRocketServerHandler::ThriftRocketServerHandler(
@@ -181,21 +199,27 @@ void ThriftRocketServerHandler::handleRequestCommon(
 
   auto data = std::move(payload).data();
   const bool validMetadata = parseOk && isMetadataValid(metadata);
-  const bool badChecksum = validMetadata && metadata.crc32c_ref() &&
+  // Shed load before paying for decompression on the IO thread.
+  if (validMetadata &&
+      UNLIKELY(serverConfigs_.isOverloaded(
+          metadata.otherMetadata_ref() ? &*metadata.otherMetadata_ref()
+                                       : nullptr,
+          &*metadata.name_ref()))) {
+    handleRequestOverloadedServer(makeRequest(std::move(metadata)));
+    return;
+  }
+  const bool uncompressed = validMetadata &&
+      uncompressRequest(
+          metadata, data, serverConfigs_.getMaxUncompressedRequestSize());
+  const bool badChecksum = uncompressed && metadata.crc32c_ref() &&
       (*metadata.crc32c_ref() != checksum::crc32c(*data));
 
-  if (validMetadata && !badChecksum) {
-    if (UNLIKELY(serverConfigs_.isOverloaded(
-            metadata.otherMetadata_ref() ? &*metadata.otherMetadata_ref()
-                                         : nullptr,
-            &*metadata.name_ref()))) {
-      handleRequestOverloadedServer(makeRequest(std::move(metadata)));
-      return;
-    }
-
+  if (uncompressed && !badChecksum) {
     auto request = makeRequest(std::move(metadata));
     const auto protocolId = request->getProtoId();
     auto* const cpp2ReqCtx = request->getRequestContext();
+    folly::RequestContextScopeGuard rctx(
+        RequestDeadline::makeContext(cpp2ReqCtx->getDeadline()));
     cpp2Processor_->process(
         std::move(request),
         std::move(data),
@@ -205,6 +229,8 @@ void ThriftRocketServerHandler::handleRequestCommon(
         threadManager_.get());
   } else if (!validMetadata) {
     handleRequestWithBadMetadata(makeRequest(std::move(metadata)));
+  } else if (!uncompressed) {
+    handleRequestWithBadCompression(makeRequest(std::move(metadata)));
   } else {
     handleRequestWithBadChecksum(makeRequest(std::move(metadata)));
   }
@@ -227,6 +253,15 @@ void ThriftRocketServerHandler::handleRequestWithBadChecksum(
       "Corrupted request");
 }
 
+void ThriftRocketServerHandler::handleRequestWithBadCompression(
+    std::unique_ptr<ThriftRequestCore> request) {
+  request->sendErrorWrapped(
+      folly::make_exception_wrapper<TApplicationException>(
+          TApplicationException::INVALID_TRANSFORM,
+          "Unable to uncompress request"),
+      "Corrupted request");
+}
+
 void ThriftRocketServerHandler::handleRequestOverloadedServer(
     std::unique_ptr<ThriftRequestCore> request) {
   request->sendErrorWrapped(
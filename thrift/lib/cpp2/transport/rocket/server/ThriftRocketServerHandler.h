@@ -88,6 +88,8 @@ class ThriftRocketServerHandler : public RocketServerHandler {
       std::unique_ptr<ThriftRequestCore> request);
   FOLLY_NOINLINE void handleRequestWithBadChecksum(
       std::unique_ptr<ThriftRequestCore> request);
+  FOLLY_NOINLINE void handleRequestWithBadCompression(
+      std::unique_ptr<ThriftRequestCore> request);
   FOLLY_NOINLINE void handleRequestOverloadedServer(
       std::unique_ptr<ThriftRequestCore> request);
 };
@@ -30,6 +30,7 @@
 #include <thrift/lib/cpp/async/TAsyncSocket.h>
 #include <thrift/lib/cpp2/async/RocketClientChannel.h>
 #include <thrift/lib/cpp2/test/gen-cpp2/TestService.h>
+#include <thrift/lib/cpp2/transport/core/PayloadCompression.h>
 #include <thrift/lib/cpp2/transport/rsocket/server/RSRoutingHandler.h>
 #include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
 
@@ -47,6 +48,11 @@ class Handler : public test::TestServiceSvIf {
   folly::SemiFuture<folly::Unit> semifuture_noResponse(int64_t) final {
     return folly::makeSemiFuture();
   }
+
+  folly::SemiFuture<std::unique_ptr<std::string>> semifuture_echoRequest(
+      std::unique_ptr<std::string> req) final {
+    return folly::makeSemiFuture(std::move(req));
+  }
 };
 
 class RocketClientChannelTest : public testing::Test {
@@ -56,10 +62,13 @@ class RocketClientChannelTest : public testing::Test {
         .addRoutingHandler(std::make_unique<RSRoutingHandler>());
   }
 
+  RocketClientChannel::Ptr makeChannel(folly::EventBase& evb) {
+    return RocketClientChannel::newChannel(async::TAsyncSocket::UniquePtr(
+        new async::TAsyncSocket(&evb, runner_.getAddress())));
+  }
+
   test::TestServiceAsyncClient makeClient(folly::EventBase& evb) {
-    return test::TestServiceAsyncClient(
-        RocketClientChannel::newChannel(async::TAsyncSocket::UniquePtr(
-            new async::TAsyncSocket(&evb, runner_.getAddress()))));
+    return test::TestServiceAsyncClient(makeChannel(evb));
   }
 
  private:
@@ -122,3 +131,25 @@ TEST_F(RocketClientChannelTest, SyncFiberOneWay) {
   }
   EXPECT_EQ(1, sent);
 }
+
+TEST_F(RocketClientChannelTest, PayloadCompression) {
+  folly::EventBase evb;
+  auto channel = makeChannel(evb);
+  channel->setPayloadCompression(CompressionAlgorithm::ZSTD);
+  test::TestServiceAsyncClient client(std::move(channel));
+
+  auto before = getPayloadCompressionStats(CompressionAlgorithm::ZSTD);
+  std::string request(10000, 'x');
+  std::string response;
+  client.sync_echoRequest(response, request);
+  EXPECT_EQ(request, response);
+
+  // Client and server share the counters: the request and the response are
+  // each compressed and uncompressed once.
+  auto after = getPayloadCompressionStats(CompressionAlgorithm::ZSTD);
+  EXPECT_EQ(before.compress.calls + 2, after.compress.calls);
+  EXPECT_EQ(before.uncompress.calls + 2, after.uncompress.calls);
+  EXPECT_LT(
+      after.compress.bytesOut - before.compress.bytesOut,
+      after.compress.bytesIn - before.compress.bytesIn);
+}
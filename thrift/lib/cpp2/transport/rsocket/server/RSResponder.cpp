@@ -16,6 +16,7 @@
 #include <thrift/lib/cpp2/transport/rsocket/server/RSResponder.h>
 
 #include <rsocket/internal/ScheduledSubscriber.h>
+#include <thrift/lib/cpp2/async/RequestDeadline.h>
 #include <thrift/lib/cpp2/protocol/CompactProtocol.h>
 #include <thrift/lib/cpp2/transport/core/ThriftRequest.h>
 #include <thrift/lib/cpp2/transport/rsocket/server/RSThriftRequests.h>
@@ -94,6 +95,8 @@ void RSResponder::onThriftRequest(
 
   auto protoId = request->getProtoId();
   auto reqContext = request->getRequestContext();
+  folly::RequestContextScopeGuard rctx(
+      RequestDeadline::makeContext(reqContext->getDeadline()));
   cpp2Processor_->process(
       std::move(request),
       std::move(buf),
@@ -51,6 +51,14 @@ enum RequestRpcMetadataFlags {
   QUERY_SERVER_LOAD = 0x1,
 }
 
+// Codec applied to an RPC payload.  The metadata itself is never compressed.
+enum CompressionAlgorithm {
+  NONE = 0,
+  ZLIB = 1,
+  ZSTD = 2,
+  LZ4 = 3,
+}
+
 // RPC metadata sent from the client to the server.  The lifetime of
 // objects of this type starts at the call to the generated client
 // code, and ends at the generated server code.
@@ -97,6 +105,20 @@ struct RequestRpcMetadata {
   // The CRC32C of the RPC message.
   11: optional i32 (cpp.type = "std::uint32_t") crc32c;
   12: optional i64 (cpp.type = "std::uint64_t") flags;
+  // The codec the request payload was compressed with, if any.  The CRC32C
+  // above always covers the uncompressed payload.
+  13: optional CompressionAlgorithm compression;
+  // The codec the client is willing to receive the response payload in.  The
+  // server may still reply uncompressed, e.g. for small responses.
+  14: optional CompressionAlgorithm acceptResponseCompression;
+  // The id of the shared zstd dictionary used for the request payload, and
+  // offered for the response.  Only meaningful with ZSTD.
+  15: optional i32 (cpp.type = "std::uint32_t") compressionDictionaryId;
+  // The time left until the end-to-end deadline of the call, when the client
+  // is itself serving a request with a deadline.  Relative, so that it does
+  // not depend on synchronized clocks.  The server does not process the
+  // request past that deadline, and propagates it to the calls it makes.
+  16: optional i32 deadlineBudgetMs;
 }
 
 // RPC metadata sent from the server to the client.  The lifetime of
@@ -122,6 +144,10 @@ struct ResponseRpcMetadata {
   4: optional i64 load;
   // The CRC32C of the RPC response.
   5: optional i32 (cpp.type = "std::uint32_t") crc32c;
+  // The codec the response payload was compressed with, if any.
+  6: optional CompressionAlgorithm compression;
+  // The id of the shared zstd dictionary used for the response payload.
+  7: optional i32 (cpp.type = "std::uint32_t") compressionDictionaryId;
 }
 
 // Setup metadata sent from the client to the server at the time
@@ -21,6 +21,7 @@
 
 #include <thrift/lib/cpp/util/VarintUtils.h>
 
+#include <folly/io/IOBufQueue.h>
 #include <folly/portability/GTest.h>
 
 using namespace apache::thrift::util;
@@ -54,3 +55,44 @@ TEST(VarintTest, Varint) {
   }
   EXPECT_THROW(readVarint<uint8_t>(rcursor), out_of_range);
 }
+
+TEST(VarintTest, VarintArray) {
+  vector<uint64_t> values;
+  for (int i = 0; i < 1000; ++i) {
+    // Mostly single-byte values with occasional long ones mixed in.
+    values.push_back(i % 37 == 0 ? (uint64_t(1) << (i % 64)) : i % 100);
+  }
+
+  folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+  QueueAppender appender(&queue, 100);
+  uint32_t size = writeVarintArray(appender, values.data(), values.size());
+
+  folly::IOBufQueue expected(folly::IOBufQueue::cacheChainLength());
+  QueueAppender expectedAppender(&expected, 100);
+  for (auto v : values) {
+    writeVarint(expectedAppender, v);
+  }
+  EXPECT_EQ(expected.chainLength(), size);
+  auto buf = queue.move();
+  EXPECT_TRUE(folly::IOBufEqualTo()(*expected.move(), *buf));
+
+  // Decode from a chain split into small pieces so that runs and varints
+  // straddle buffer boundaries.
+  auto flat = buf->cloneCoalesced();
+  std::unique_ptr<IOBuf> chain;
+  for (size_t pos = 0; pos < flat->length(); pos += 7) {
+    auto piece = IOBuf::copyBuffer(
+        flat->data() + pos, std::min<size_t>(7, flat->length() - pos));
+    if (chain) {
+      chain->prependChain(std::move(piece));
+    } else {
+      chain = std::move(piece);
+    }
+  }
+
+  vector<uint64_t> decoded(values.size());
+  Cursor rcursor(chain.get());
+  readVarintArray(rcursor, decoded.data(), decoded.size());
+  EXPECT_EQ(values, decoded);
+  EXPECT_TRUE(rcursor.isAtEnd());
+}